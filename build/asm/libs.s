@@ -0,0 +1,174 @@
+# 0 "src/libc/libs.S"
+# 1 "/root/repo//"
+# 0 "<built-in>"
+# 0 "<command-line>"
+# 1 "src/libc/libs.S"
+# 21 "src/libc/libs.S"
+ARG1 = 8
+ARG2 = 12
+# 36 "src/libc/libs.S"
+ .globl __inb, __inw, __inl
+
+__inb:
+ enter $0,$0
+ xorl %eax,%eax
+ movl ARG1(%ebp),%edx
+ inb (%dx)
+ leave
+ ret
+__inw:
+ enter $0,$0
+ xorl %eax,%eax
+ movl ARG1(%ebp),%edx
+ inw (%dx)
+ leave
+ ret
+__inl:
+ enter $0,$0
+ xorl %eax,%eax
+ movl ARG1(%ebp),%edx
+ inl (%dx)
+ leave
+ ret
+# 71 "src/libc/libs.S"
+ .globl __outb, __outw, __outl
+__outb:
+ enter $0,$0
+ movl ARG1(%ebp),%edx
+ movl ARG2(%ebp),%eax
+ outb (%dx)
+ leave
+ ret
+__outw:
+ enter $0,$0
+ movl ARG1(%ebp),%edx
+ movl ARG2(%ebp),%eax
+ outw (%dx)
+ leave
+ ret
+__outl:
+ enter $0,$0
+ movl ARG1(%ebp),%edx
+ movl ARG2(%ebp),%eax
+ outl (%dx)
+ leave
+ ret
+# 101 "src/libc/libs.S"
+ .globl __get_flags
+
+__get_flags:
+ pushfl
+ popl %eax
+ ret
+
+
+
+
+
+
+ .globl __pause
+
+__pause:
+ enter $0,$0
+ sti
+ hlt
+ leave
+ ret
+# 129 "src/libc/libs.S"
+ .globl __rdtsc
+
+__rdtsc:
+ rdtsc
+ ret
+# 143 "src/libc/libs.S"
+ .globl __cpuid
+
+__cpuid:
+ enter $0,$0
+ pushl %ebx
+ pushl %edi
+ movl 8(%ebp),%eax
+ xorl %ecx,%ecx
+ cpuid
+ movl 12(%ebp),%edi
+ movl %eax,0(%edi)
+ movl %ebx,4(%edi)
+ movl %ecx,8(%edi)
+ movl %edx,12(%edi)
+ popl %edi
+ popl %ebx
+ leave
+ ret
+# 171 "src/libc/libs.S"
+ .globl __rdmsr
+
+__rdmsr:
+ movl 4(%esp),%ecx
+ rdmsr
+ ret
+# 186 "src/libc/libs.S"
+ .globl __wrmsr
+
+__wrmsr:
+ movl 4(%esp),%ecx
+ movl 8(%esp),%eax
+ movl 12(%esp),%edx
+ wrmsr
+ ret
+# 204 "src/libc/libs.S"
+ .globl __get_cr0, __set_cr0, __get_cr4, __set_cr4
+
+__get_cr0:
+ movl %cr0,%eax
+ ret
+
+__set_cr0:
+ movl 4(%esp),%eax
+ movl %eax,%cr0
+ ret
+
+__get_cr4:
+ movl %cr4,%eax
+ ret
+
+__set_cr4:
+ movl 4(%esp),%eax
+ movl %eax,%cr4
+ ret
+# 231 "src/libc/libs.S"
+ .globl __get_cr2
+
+__get_cr2:
+ movl %cr2,%eax
+ ret
+# 245 "src/libc/libs.S"
+ .globl __set_cr3
+
+__set_cr3:
+ movl 4(%esp),%eax
+ movl %eax,%cr3
+ ret
+# 259 "src/libc/libs.S"
+ .globl __invlpg
+
+__invlpg:
+ movl 4(%esp),%eax
+ invlpg (%eax)
+ ret
+# 273 "src/libc/libs.S"
+ .globl __ltr
+
+__ltr:
+ movl 4(%esp),%eax
+ ltr %ax
+ ret
+# 288 "src/libc/libs.S"
+ .global __get_ra
+
+__get_ra:
+
+
+
+
+ movl 4(%ebp), %eax
+ ret
@@ -0,0 +1,62 @@
+# 0 "src/startup.S"
+# 1 "/root/repo//"
+# 0 "<built-in>"
+# 0 "<command-line>"
+# 1 "src/startup.S"
+# 17 "src/startup.S"
+ .arch i386
+
+# 1 "src/bootstrap.h" 1
+# 20 "src/startup.S" 2
+# 31 "src/startup.S"
+ .globl begtext
+
+ .text
+begtext:
+
+
+
+
+ .globl _start
+
+_start:
+ cli
+ movb $0x00, %al
+ outb $0x70
+
+
+
+
+
+ xorl %eax, %eax
+ movw $0x0018, %ax
+ movw %ax, %ds
+ movw %ax, %es
+ movw %ax, %fs
+ movw %ax, %gs
+
+ movw $0x0020, %ax
+ movw %ax, %ss
+
+ movl $0x00010000, %ebp
+ movl %ebp, %esp
+
+
+
+
+
+
+
+ .globl __bss_start, _end
+
+ movl $__bss_start, %edi
+clearbss:
+ movl $0, (%edi)
+ addl $4, %edi
+ cmpl $_end, %edi
+ jb clearbss
+# 87 "src/startup.S"
+ .globl _kinit
+ call _kinit
+# 99 "src/startup.S"
+ jmp __isr_restore
@@ -0,0 +1,72 @@
+# 0 "src/usr/ulibs.S"
+# 1 "/root/repo//"
+# 0 "<built-in>"
+# 0 "<command-line>"
+# 1 "src/usr/ulibs.S"
+# 13 "src/usr/ulibs.S"
+# 1 "src/kern/syscalls.h" 1
+# 19 "src/kern/syscalls.h"
+# 1 "src/common.h" 1
+# 21 "src/common.h"
+# 1 "src/params.h" 1
+# 22 "src/common.h" 2
+# 20 "src/kern/syscalls.h" 2
+# 14 "src/usr/ulibs.S" 2
+# 40 "src/usr/ulibs.S"
+.globl exit ; exit: ; movl $0, %eax ; int $0x80 ; ret
+.globl sleep ; sleep: ; movl $1, %eax ; int $0x80 ; ret
+.globl read ; read: ; movl $2, %eax ; int $0x80 ; ret
+.globl write ; write: ; movl $3, %eax ; int $0x80 ; ret
+.globl waitpid ; waitpid: ; movl $4, %eax ; int $0x80 ; ret
+.globl getdata ; getdata: ; movl $5, %eax ; int $0x80 ; ret
+.globl setdata ; setdata: ; movl $6, %eax ; int $0x80 ; ret
+.globl kill ; kill: ; movl $7, %eax ; int $0x80 ; ret
+.globl fork ; fork: ; movl $8, %eax ; int $0x80 ; ret
+.globl exec ; exec: ; movl $9, %eax ; int $0x80 ; ret
+
+.globl vgatextclear ; vgatextclear: ; movl $10, %eax ; int $0x80 ; ret
+.globl vgatextgetactivecolor ; vgatextgetactivecolor: ; movl $11, %eax ; int $0x80 ; ret
+.globl vgatextsetactivecolor ; vgatextsetactivecolor: ; movl $12, %eax ; int $0x80 ; ret
+.globl acpicommand ; acpicommand: ; movl $13, %eax ; int $0x80 ; ret
+.globl vgatextgetblinkenabled ; vgatextgetblinkenabled: ; movl $14, %eax ; int $0x80 ; ret
+.globl vgatextsetblinkenabled ; vgatextsetblinkenabled: ; movl $15, %eax ; int $0x80 ; ret
+.globl vgagetmode ; vgagetmode: ; movl $16, %eax ; int $0x80 ; ret
+.globl vgasetmode ; vgasetmode: ; movl $17, %eax ; int $0x80 ; ret
+.globl vgaclearscreen ; vgaclearscreen: ; movl $18, %eax ; int $0x80 ; ret
+.globl vgatest ; vgatest: ; movl $19, %eax ; int $0x80 ; ret
+.globl vgadrawimage ; vgadrawimage: ; movl $20, %eax ; int $0x80 ; ret
+.globl vgawritepixel ; vgawritepixel: ; movl $21, %eax ; int $0x80 ; ret
+
+.globl fopen ; fopen: ; movl $25, %eax ; int $0x80 ; ret
+.globl fclose ; fclose: ; movl $26, %eax ; int $0x80 ; ret
+.globl fread ; fread: ; movl $27, %eax ; int $0x80 ; ret
+.globl fwrite ; fwrite: ; movl $28, %eax ; int $0x80 ; ret
+.globl flistdir ; flistdir: ; movl $29, %eax ; int $0x80 ; ret
+.globl fcreate ; fcreate: ; movl $30, %eax ; int $0x80 ; ret
+.globl fdelete ; fdelete: ; movl $31, %eax ; int $0x80 ; ret
+.globl fioctl ; fioctl: ; movl $32, %eax ; int $0x80 ; ret
+.globl fseek ; fseek: ; movl $33, %eax ; int $0x80 ; ret
+.globl fchdir ; fchdir: ; movl $34, %eax ; int $0x80 ; ret
+.globl fgetcwd ; fgetcwd: ; movl $35, %eax ; int $0x80 ; ret
+
+.globl rtsched ; rtsched: ; movl $36, %eax ; int $0x80 ; ret
+.globl usleep ; usleep: ; movl $37, %eax ; int $0x80 ; ret
+.globl spawnfd ; spawnfd: ; movl $38, %eax ; int $0x80 ; ret
+.globl thrcreate ; thrcreate: ; movl $39, %eax ; int $0x80 ; ret
+.globl thrjoin ; thrjoin: ; movl $40, %eax ; int $0x80 ; ret
+
+.globl ciogetcursorpos ; ciogetcursorpos: ; movl $22, %eax ; int $0x80 ; ret
+.globl ciosetcursorpos ; ciosetcursorpos: ; movl $23, %eax ; int $0x80 ; ret
+.globl ciogetspecialdown ; ciogetspecialdown: ; movl $24, %eax ; int $0x80 ; ret
+
+
+
+
+
+.globl bogus ; bogus: ; movl $0xbad, %eax ; int $0x80 ; ret
+# 105 "src/usr/ulibs.S"
+ .globl fake_exit
+fake_exit:
+
+ pushl %eax
+ call exit
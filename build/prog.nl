@@ -0,0 +1,198 @@
+
+
+2026-10-17 07:39                                                          Page 1
+
+
+00010000 T _start	   00011d02 T __sprint	      000160de T _que_remove_ptr
+00010000 T begtext	   00011f73 T __cvtdec0	      0001630e T _iq_create
+0001006c T __isr_restore   00011ffc T __cvtuns0	      00016389 T _iq_peek
+00010174 T __isr_page_faul 00012062 T __cvtdec	      0001643d T _iq_insert
+0001017f T __isr_vm_abort  000120a5 T __cvtuns	      000165d8 T _iq_remove
+00010bfb T __inb	   000120d3 T __cvthex	      0001669b T _iq_remove_ptr
+00010c07 T __inw	   0001214e T __cvtoct	      00016df8 T _sch_init
+00010c14 T __inl	   000123c7 T __panic	      00016ec1 T _schedule
+00010c20 T __outb	   000123e4 T __init_interrup 0001704c T _dispatch
+00010c2d T __outw	   000123f7 T __install_isr   00017248 T _sch_setprio
+00010c3b T __outl	   0001241c T __install_task_ 0001728c T _sch_setpolicy
+00010c48 T __get_flags	   00012459 T __isr_stub      000172fd T _sch_getpolicy
+00010c4b T __pause	   00012487 T __delay	      0001732a T _sch_setrt
+00010c53 T __rdtsc	   00012931 T _clk_init	      000174c2 T _sch_rtmisses
+00010c56 T __cpuid	   000129e7 T _clk_ns	      000174e1 T _sch_forget
+00010c75 T __rdmsr	   00012a8c T _clk_resume     0001753c T _sch_reserve
+00010c7c T __wrmsr	   00012a92 T _clk_event_ok   000175f1 T _sch_yield
+00010c8b T __get_cr0	   00012a9e T _clk_event      0001767e T _sch_blocked
+00010c8f T __set_cr0	   00012c23 T _kinit	      000176bc T _sch_idle
+00010c97 T __get_cr4	   000130eb T _kpanic	      000176e5 T _sch_unidle
+00010c9b T __set_cr4	   00013188 T _kma_init	      0001770b T _sch_idletime
+00010ca3 T __get_cr2	   00013249 T kmalloc	      0001773a T _sch_tick
+00010ca7 T __set_cr3	   000132b2 T kfree	      00017cf0 T _sio_init
+00010caf T __invlpg	   0001388a T _km_init	      00017e7f T _sio_enable
+00010cb7 T __ltr	   00013b69 T _km_dump	      00017ef6 T _sio_disable
+00010cbf T __get_ra	   00013edf T _km_page_alloc  00017f6d T _sio_inq_length
+00010db3 T __cio_setscroll 00013efb T _km_page_alloc_ 00017f77 T _sio_readc
+00010e55 T __cio_getpos	   00013f18 T _km_page_free   00017fd8 T _sio_read
+00010e71 T __cio_getarrowd 000140de T _km_page_share  00018073 T _sio_writec
+00010e7b T __cio_moveto	   000141c6 T _km_page_refs   000180e3 T _sio_write
+00010edb T __cio_putchar_a 00014292 T _km_page_lookup 0001818a T _sio_puts
+00010f53 T __cio_putchar   000143d2 T _km_scrub	      000181b7 T _sio_dump
+00011057 T __cio_puts_at   000145a8 T _km_slice_alloc 00018334 T _stk_init
+00011099 T __cio_puts	   00014663 T _km_slice_free  000183b1 T _stk_alloc
+000110cb T __cio_write	   00014b05 T _pcb_init	      000183fe T _stk_dealloc
+00011104 T __cio_clearscro 00014bc4 T _pcb_alloc      00018456 T _stk_setup
+0001117c T __cio_clearscre 00014cff T _pcb_dealloc    000186c3 T _stk_dump
+000111e9 T __cio_scroll	   00014d9a T _pcb_new_pid    0001abd6 T _sys_init
+000116ef T __cio_printf_at 00014dec T _pcb_enroll     0001ad47 T _timer_init
+0001170f T __cio_printf	   00014f6c T _pcb_find	      0001add5 T _timer_setup
+000118e1 T __cio_getchar   00014fa2 T _pcb_first      0001ae60 T _timer_arm
+00011960 T __cio_gets	   00014fb1 T _pcb_next	      0001af2e T _timer_cancel
+000119b1 T __cio_input_que 00014fe1 T _pcb_joiner     0001aff8 T _timer_pending
+000119d9 T __cio_init	   000150eb T _pcb_cleanup    0001b008 T _timer_count
+00011a6a T __put_char_or_c 00015169 T _pcb_zombify    0001b012 T _timer_next
+00011aa4 T __bound	   00015581 T _pcb_get_next_f 0001b07b T _timer_tick
+00011ac8 T __memset	   000155bd T _pcb_dump	      0001b1fe T vga_text_fg
+00011aef T __memclr	   00015688 T _ctx_dump	      0001b20e T vga_text_bg
+00011b13 T __memcpy	   0001577a T _ctx_dump_all   0001b221 T ansi_color_to_v
+00011b41 T __memcmp	   00015816 T _ptable_dump    0001b330 T parse_ansi_colo
+00011b89 T __strlen	   00015ba3 T _que_init	      0001b5f9 T __vga_text_get_
+00011bad T __strcmp	   00015c45 T _que_reserve    0001b603 T __vga_text_set_
+00011be7 T __strcpy	   00015c85 T _que_create     0001b611 T __vga_text_get_
+00011c16 T __strcat	   00015cf7 T _que_insert     0001b638 T __vga_text_set_
+00011c4c T __pad	   00015ea2 T _que_peek	      0001b688 T _vga_text_init
+00011c6e T __padstr	   00015f4f T _que_remove     0001b6a8 T _vga_text_color
+
+
+
+
+
+
+
+2026-10-17 07:39                                                          Page 2
+
+
+0001c449 T _acpi_command   00020c33 T _vfs_mount_fs   00023667 T wtsh_main
+0001c8ff T _acpi_init	   00020cf7 T _vfs_allocate_f 00023b01 T int_cmd_help
+0001d10c T _acpi_aml_find_ 00020d11 T _vfs_allocate_s 00023be6 T int_cmd_echo
+0001d1a0 T _acpi_checksum_ 00020d2b T _vfs_allocate_d 00023c50 T int_cmd_exit
+0001d378 T _acpi_get_rsdp_ 00020da5 T _vfs_free_file  00023c61 T int_cmd_shutdow
+0001d3f6 T _acpi_validate_ 00020dc1 T _vfs_close_file 00023c9b T int_cmd_reboot
+0001d481 T _vga_attr_read  00020ead T _vfs_free_diren 00023cd5 T int_cmd_ls
+0001d4e5 T _vga_attr_write 00020f2b T _vfs_dirent_loo 00023dcb T draw_square
+0001d553 T __vga_get_mode  00020f79 T _vfs_dirent_to_ 00023eec T int_cmd_vgademo
+0001d95b T __vga_clear_scr 00020ff8 T resolve_path    000240ae T int_cmd_getcwd
+0001d9bb T _draw_x	   000211e0 T namey	      000240f0 T int_cmd_cd
+0001da2a T __vga_draw_test 0002122f T testfs_open     0002415f T int_cmd_write
+0001db19 T __vga_draw_imag 000212d1 T testfs_iterate_ 00024263 T int_cmd_cat
+0001de32 T __vga_set_mode  00021465 T testfs_lookup   00024522 T init
+0001e050 T _dump_regs	   0002150a T testfs_close_fi 00024672 T exit
+0001e147 T _read_regs	   0002154e T testfs_ioctl    0002467a T sleep
+0001e2ab T _lapic_init	   00021591 T testfs_file_rea 00024682 T read
+0001e3d6 T _lapic_timer	   0002164e T testfs_file_wri 0002468a T write
+0001e3fe T _lapic_timer_le 0002173d T testfs_get_leng 00024692 T waitpid
+0001e40f T _lapic_timer_de 0002174b T testfs_mount    0002469a T getdata
+0001e6f9 T _hrt_init	   000218a7 T testfs_init     000246a2 T setdata
+0001e719 T _hrt_setup	   000218c9 T testfs_deinit   000246aa T kill
+0001e7c0 T _hrt_arm	   000218db T __init_bogus_no 000246b2 T fork
+0001e848 T _hrt_cancel	   0002192c T __deinit_bogus_ 000246ba T exec
+0001e90b T _hrt_pending	   00021979 T wait	      000246c2 T vgatextclear
+0001e93d T _hrt_expire	   00021991 T spawn	      000246ca T vgatextgetactiv
+0001edc4 T _vm_init	   000219ac T cwritech	      000246d2 T vgatextsetactiv
+0001f079 T _vm_create	   000219cd T cwrites	      000246da T acpicommand
+0001f0f7 T _vm_fork	   000219fa T cwrite	      000246e2 T vgatextgetblink
+0001f261 T _vm_free	   00021a15 T swritech	      000246ea T vgatextsetblink
+0001f34e T _vm_slot_free   00021a36 T swrites	      000246f2 T vgagetmode
+0001f43f T _vm_switch	   00021a63 T swrite	      000246fa T vgasetmode
+0001f471 T _vm_access	   00021a7e T str2int	      00024702 T vgaclearscreen
+0001f547 T _vm_context	   00021af4 T strlen	      0002470a T vgatest
+0001f5b2 T _vm_copyin	   00021b18 T strcpy	      00024712 T vgadrawimage
+0001f638 T _vm_copyout	   00021b42 T strcat	      0002471a T vgawritepixel
+0001f6be T _vm_fault	   00021b78 T strcmp	      00024722 T fopen
+0001f885 T _vm_kill	   00021bb2 T pad	      0002472a T fclose
+0001f919 T kstr_strcmp	   00021bd4 T padstr	      00024732 T fread
+0001fa23 T kstr_strtok	   00021c68 T sprint	      0002473a T fwrite
+0001fafb T kstr_hash	   00021e95 T cvt_dec0	      00024742 T flistdir
+00020015 T slab_init	   00021f1e T cvt_dec	      0002474a T fcreate
+00020035 T slab_init_ctor  00021f61 T cvt_hex	      00024752 T fdelete
+000201f9 T slab_deinit	   00021ff0 T cvt_oct	      0002475a T fioctl
+000202ca T slab_alloc	   00022076 T test_fd_assignm 00024762 T fseek
+0002039b T slab_free	   000222fc T test_rw_locks   0002476a T fchdir
+00020462 T slab_alloc_bulk 000224ca T test_fioctl     00024772 T fgetcwd
+000205b1 T slab_free_bulk  00022698 T test_read	      0002477a T rtsched
+00020713 T slab_set_max_em 00022b01 T test_fseek      00024782 T usleep
+00020736 T slab_shrink	   00022e56 T test_write      0002478a T spawnfd
+0002074e T slab_register   0002320d T __dump_children 00024792 T thrcreate
+0002081f T slab_info	   00023324 T test_listdir    0002479a T thrjoin
+00020a14 T slab_element_ca 00023426 T test_relative_p 000247a2 T ciogetcursorpos
+00020aa5 T _vfs_init	   0002355b T test_vfs	      000247aa T ciosetcursorpos
+00020bc2 T _vfs_deinit	   0002356d T init_state      000247b2 T ciogetspecialdo
+00020bec T _vfs_register_f 00023579 T prep_arguments  000247ba T bogus
+
+
+
+
+
+
+
+2026-10-17 07:39                                                          Page 3
+
+
+000247c2 T fake_exit	   0005ac40 D _vga_palette_25 0005cda0 B open_file_table
+0002c000 D __isr_stub_tabl 0005afa0 D bogus_root_node 0005cfc0 B _ready
+0002c50c D __hexdigits	   0005b360 D bogus_all_nodes 0005d074 B _current
+0002c520 D _state_str	   0005b3a0 D g_commands      0005d120 B _sio_readq
+0002c570 D _prio_str	   0005c180 B __bss_start     0005e174 B _kstack
+0002c5c0 D logo		   0005c180 D _edata	      0005e178 B _kesp
+0002c770 D __vga_write_pix 0005c2a0 B __isr_table     0005fa9c B active_color
+0002c780 D _vga_mode_80x25 0005c6a0 B _system_time    0005fac8 B _lapic
+0002c7c0 D _vga_mode_640x4 0005c6a4 B _clk_tsc_khz    0005facc B _lapic_deadline
+0002c800 D _vga_mode_320x2 0005c6e0 B _b256	      0005fc20 B g_root_dirent
+0002c840 D _vga_font_defau 0005c7e0 B _b512	      0005fde0 B print_buffer
+0002d840 D vga_image_rick  0005cd80 B _pcb_count      0005fee0 B dent_buffer
+0003b940 D vga_image_adin  0005cd84 B _next_pid	      00061340 B cwd_buffer
+000427c0 D vga_image_obiwa 0005cd88 B _init_pcb	      00061740 B read_buffer
+0004d080 D vga_image_coyot 0005cd8c B _idle_pcb	      00062894 B _end
+0005ab40 D _vga_palette_16
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
@@ -40,6 +40,10 @@
 #define	GDT_DATA	0x0018		/* All of memory, R/W */
 #define	GDT_STACK	0x0020		/* All of memory, R/W */
 
+	/* task state segments (filled in by the VM module) */
+#define	GDT_TSS_KERN	0x0028		/* The running task */
+#define	GDT_TSS_FAULT	0x0030		/* The page fault handler */
+
 /*
 ** The Interrupt Descriptor Table (0000:2500 - 0000:2D00)
 */
@@ -101,8 +101,12 @@ typedef int32_t (*userfcn_t)(int32_t,char*[]);
 // Get/set syscall options
 typedef int32_t datum_t;
 
+// Idle is in ms since boot; Nanos is the low 32 bits of the
+// nanosecond clock, so it wraps around every 4.3 seconds; Pid is the
+// same in all the threads of a process, but Tid is not
 enum datum_e {
-	Pid = 0, PPid = 1, Prio = 2, Time = 3,
+	Pid = 0, PPid = 1, Prio = 2, Time = 3, Policy = 4, Misses = 5,
+	Idle = 6, Nanos = 7, Tid = 8,
 	// sentinel
 	N_DATUMS
 	// yes, that's valid as the plural of 'datum', according
@@ -160,6 +164,15 @@ enum prio_e {
     N_PRIOS
 };
 
+// Scheduling policies (the Policy datum)
+enum policy_e {
+    PolicyMLFQ = 0,     // multilevel feedback queue (the default)
+    PolicyFair,         // fair share, by virtual runtime
+    PolicyRT,           // earliest deadline first (see rtsched())
+    // sentinel
+    N_POLICIES
+};
+
 // ----------------------------------------------------------
 // Just VFS Things
 typedef uint32_t inum_t;
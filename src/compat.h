@@ -68,7 +68,7 @@
 #define PCBTYPE		pcb_t
 
 // type name for our queue
-#define QTYPE		queue_t
+#define QTYPE		iqueue_t
 
 /*
 ** Section 3:  interface and behavior
@@ -105,7 +105,7 @@
 
 // invoke the queue creation function
 #define QCREATE(q)	do { \
-		_que_create( &(q), NULL ); \
+		_iq_create( &(q), NULL, PCB_QLINK ); \
 	} while(0)
 
 // invoke the queue "length" function
@@ -114,7 +114,7 @@
 // this macro expands into code that removes a value from
 // 'q' and places it into 'd'
 #define QDEQUE(q,d)	do { \
-        assert( _que_remove( &(q), (void **) &(d) ) == S_OK ); \
+        assert( _iq_remove( &(q), (void **) &(d) ) == S_OK ); \
     } while(0)
 
 #endif
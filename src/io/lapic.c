@@ -0,0 +1,135 @@
+/**
+** @file	lapic.c
+**
+** @brief	Local APIC module
+**
+** Only the parts needed to use the LAPIC timer as the clock source:
+** the APIC is enabled with its local interrupt pins set up for the
+** 8259 (LINT0, as ExtINT) and NMIs (LINT1), so the other devices
+** keep working as before.  The clock module does the calibration.
+*/
+
+#define SP_KERNEL_SRC
+
+#include "common.h"
+
+#include "lapic.h"
+
+#include "kern/kernel.h"
+#include "kern/support.h"
+
+/*
+** PUBLIC GLOBAL VARIABLES
+*/
+
+// the register block (NULL if there is no local APIC)
+volatile uint32_t *_lapic;
+
+// does the timer have a TSC-deadline mode?
+bool_t _lapic_deadline;
+
+/*
+** PRIVATE FUNCTIONS
+*/
+
+/**
+** Name:	_lapic_spurious
+**
+** ISR for spurious interrupts; these must not be acknowledged
+**
+** @param vector   Vector number for the interrupt
+** @param code     Error code (0 for this interrupt)
+*/
+static void _lapic_spurious( int vector, int code ) {
+	(void) vector;
+	(void) code;
+}
+
+/*
+** PUBLIC FUNCTIONS
+*/
+
+/**
+** Name:	_lapic_init
+**
+** Find and enable the local APIC, with its timer stopped
+**
+** @return true if there is one, else false
+*/
+bool_t _lapic_init( void ) {
+	unsigned int regs[4];
+
+	// we need both the APIC and the MSR instructions
+	__cpuid( 1, regs );
+	if( (regs[3] & (CPUID_1_EDX_APIC | CPUID_1_EDX_MSR)) !=
+			(CPUID_1_EDX_APIC | CPUID_1_EDX_MSR) ) {
+		return false;
+	}
+	_lapic_deadline = (regs[2] & CPUID_1_ECX_DEADLINE) != 0;
+
+	// make sure it is globally enabled, and find the registers
+	uint64_t base = __rdmsr( MSR_APIC_BASE );
+	if( (base & MSR_APIC_BASE_ENABLE) == 0 ) {
+		base |= MSR_APIC_BASE_ENABLE;
+		__wrmsr( MSR_APIC_BASE, base );
+	}
+	_lapic = (volatile uint32_t *) (uint32_t) (base & MSR_APIC_BASE_ADDR);
+
+	__install_isr( LAPIC_VEC_SPURIOUS, _lapic_spurious );
+
+	// route the 8259 and NMIs through, accept every priority,
+	// and software-enable it
+	LAPIC(LAPIC_REG_LVT_LINT0) = LAPIC_LVT_EXTINT;
+	LAPIC(LAPIC_REG_LVT_LINT1) = LAPIC_LVT_NMI;
+	LAPIC(LAPIC_REG_TPR) = 0;
+	LAPIC(LAPIC_REG_SVR) = LAPIC_SVR_ENABLE | LAPIC_VEC_SPURIOUS;
+
+	// the timer stays quiet until the clock module starts it
+	LAPIC(LAPIC_REG_TIMER_DIV) = LAPIC_TIMER_DIV_16;
+	_lapic_timer( LAPIC_LVT_MASKED, 0 );
+
+	__cio_puts( " LAPIC" );
+
+	return true;
+}
+
+/**
+** Name:	_lapic_timer
+**
+** Start (or stop) the timer counting down
+**
+** @param mode    LAPIC_TIMER_PERIODIC or LAPIC_TIMER_ONESHOT, possibly
+**                with LAPIC_LVT_MASKED
+** @param count   The count to start from (0 stops the timer)
+*/
+void _lapic_timer( uint32_t mode, uint32_t count ) {
+	LAPIC(LAPIC_REG_LVT_TIMER) = mode | LAPIC_VEC_TIMER;
+	LAPIC(LAPIC_REG_TIMER_INIT) = count;
+}
+
+/**
+** Name:	_lapic_timer_left
+**
+** @return what is left of the timer's current count
+*/
+uint32_t _lapic_timer_left( void ) {
+	return LAPIC(LAPIC_REG_TIMER_CUR);
+}
+
+/**
+** Name:	_lapic_timer_deadline
+**
+** Have the timer interrupt once, when the TSC reaches a given value
+** (only if _lapic_deadline is true)
+**
+** @param tsc   The deadline
+*/
+void _lapic_timer_deadline( uint64_t tsc ) {
+	assert1( _lapic_deadline );
+
+	LAPIC(LAPIC_REG_LVT_TIMER) = LAPIC_TIMER_DEADLINE | LAPIC_VEC_TIMER;
+
+	// the LVT write must land before the MSR write arms the timer
+	__asm__ __volatile__( "mfence" ::: "memory" );
+	__wrmsr( MSR_TSC_DEADLINE, tsc );
+}
@@ -0,0 +1,133 @@
+/**
+** @file	lapic.h
+**
+** @brief	Local APIC declarations
+**
+** The local APIC's registers are memory-mapped, at an address found
+** in the IA32_APIC_BASE MSR.  We use it only for its timer, which can
+** interrupt periodically, once after a count runs down, or (on CPUs
+** which support it) once the TSC reaches a deadline.  Other device
+** interrupts still come through the 8259, in virtual wire mode.
+*/
+
+#ifndef LAPIC_H_
+#define LAPIC_H_
+
+/*
+** General (C and/or assembly) definitions
+*/
+
+// register offsets (in bytes) from the LAPIC base address
+#define LAPIC_REG_ID		0x020	// local APIC ID
+#define LAPIC_REG_TPR		0x080	// task priority
+#define LAPIC_REG_EOI		0x0b0	// end of interrupt
+#define LAPIC_REG_SVR		0x0f0	// spurious interrupt vector
+#define LAPIC_REG_ISR		0x100	// in-service bits (8 registers,
+									// 0x10 apart, 32 vectors each)
+#define LAPIC_REG_LVT_TIMER	0x320	// LVT entries
+#define LAPIC_REG_LVT_LINT0	0x350
+#define LAPIC_REG_LVT_LINT1	0x360
+#define LAPIC_REG_TIMER_INIT	0x380	// timer initial count
+#define LAPIC_REG_TIMER_CUR	0x390	// timer current count
+#define LAPIC_REG_TIMER_DIV	0x3e0	// timer divide configuration
+
+// spurious interrupt vector register:  software enable
+#define LAPIC_SVR_ENABLE	0x100
+
+// LVT entry fields
+#define LAPIC_LVT_MASKED	0x10000		// interrupt is masked
+#define LAPIC_LVT_NMI		0x00400		// delivery modes
+#define LAPIC_LVT_EXTINT	0x00700
+
+// timer modes (in the timer's LVT entry)
+#define LAPIC_TIMER_ONESHOT		0x00000
+#define LAPIC_TIMER_PERIODIC	0x20000
+#define LAPIC_TIMER_DEADLINE	0x40000
+
+// timer divide configuration:  divide the bus clock by 16
+#define LAPIC_TIMER_DIV_16	0x3
+
+// model-specific registers
+#define MSR_APIC_BASE			0x01b
+#define MSR_APIC_BASE_ENABLE	0x800
+#define MSR_APIC_BASE_ADDR		0xfffff000
+#define MSR_TSC_DEADLINE		0x6e0
+
+// CPUID leaf 1 feature bits
+#define CPUID_1_EDX_MSR			(1 << 5)
+#define CPUID_1_EDX_APIC		(1 << 9)
+#define CPUID_1_ECX_DEADLINE	(1 << 24)
+
+// the vectors we use
+#define LAPIC_VEC_TIMER		0x30
+#define LAPIC_VEC_SPURIOUS	0xff
+
+#ifndef SP_ASM_SRC
+
+/*
+** Start of C-only definitions
+*/
+
+#include "common.h"
+
+/*
+** Globals
+*/
+
+// the register block (NULL if there is no local APIC)
+extern volatile uint32_t *_lapic;
+
+// does the timer have a TSC-deadline mode?
+extern bool_t _lapic_deadline;
+
+// access one register
+#define LAPIC(reg)		(_lapic[(reg) >> 2])
+
+// acknowledge the current interrupt; just one register write
+#define LAPIC_ACK()		(LAPIC(LAPIC_REG_EOI) = 0)
+
+/*
+** Prototypes
+*/
+
+/**
+** Name:	_lapic_init
+**
+** Find and enable the local APIC, with its timer stopped
+**
+** @return true if there is one, else false
+*/
+bool_t _lapic_init( void );
+
+/**
+** Name:	_lapic_timer
+**
+** Start (or stop) the timer counting down
+**
+** @param mode    LAPIC_TIMER_PERIODIC or LAPIC_TIMER_ONESHOT, possibly
+**                with LAPIC_LVT_MASKED
+** @param count   The count to start from (0 stops the timer)
+*/
+void _lapic_timer( uint32_t mode, uint32_t count );
+
+/**
+** Name:	_lapic_timer_left
+**
+** @return what is left of the timer's current count
+*/
+uint32_t _lapic_timer_left( void );
+
+/**
+** Name:	_lapic_timer_deadline
+**
+** Have the timer interrupt once, when the TSC reaches a given value
+** (only if _lapic_deadline is true)
+**
+** @param tsc   The deadline
+*/
+void _lapic_timer_deadline( uint64_t tsc );
+
+#endif
+// !SP_ASM_SRC
+
+#endif
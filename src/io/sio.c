@@ -174,10 +174,14 @@ static void _sio_isr( int vector, int ecode ) {
 				QDEQUE( QNAME, pcb );
 				assert( pcb );
 
-				// return char via arg #2 and count in EAX
-				char *buf = (char *) ARG(pcb,2);
-				*buf = ch & 0xff;
-				RET(pcb) = 1;
+				// return char via arg #2 and count in EAX; both
+				// are in the reader's address space
+				char *buf = _vm_access( pcb->proc->pgdir,
+						VM_ARG(pcb,2), true );
+				if( buf != NULL ) {
+					*buf = ch & 0xff;
+				}
+				VM_RET(pcb) = 1;
 				SCHED( pcb );
 
 			} else {
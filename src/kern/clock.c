@@ -17,8 +17,12 @@
 #include "sched.h"
 #include "io/sio.h"
 #include "mem/stacks.h"
+#include "mem/kmem.h"
 #include "kernel.h"
 #include "syscalls.h"
+#include "timer.h"
+#include "hrtimer.h"
+#include "io/lapic.h"
 
 #include "x86arch.h"
 #include "x86pic.h"
@@ -28,6 +32,36 @@
 ** PRIVATE DEFINITIONS
 */
 
+// PIT counts per clock tick
+#define TICK_COUNT		(PIT_FREQUENCY / CLOCK_FREQUENCY)
+
+// PIT channel 2 is gated through port B of the keyboard controller,
+// where its OUT pin can also be read
+#define PIT_2_GATE_PORT	0x61
+#define PIT_2_GATE		0x01	// channel 2 counts while this is set
+#define PIT_2_SPEAKER	0x02	// and drives the speaker if this is
+#define PIT_2_OUT		0x20	// channel 2's OUT pin
+
+// the PIT's interrupt line on the primary PIC
+#define PIC_IRQ_TIMER	0x01
+
+// the TSC is calibrated over this many PIT counts (about 50ms)
+#define CAL_COUNT		(PIT_FREQUENCY / 20)
+
+// nanoseconds are converted to PIT counts by multiplying by this
+// and dropping the low 32 bits (PIT_FREQUENCY / 10^9, times 2^32)
+#define NS_TO_PIT_MULT	5124678
+
+// TSC cycles are converted to nanoseconds by multiplying by a
+// fixed-point factor with this many fraction bits
+#define TSC_SHIFT		24
+
+#ifdef TICKLESS_IDLE
+// read-back status bit:  the channel's OUT pin, which goes high
+// when a mode 0 count reaches zero
+#define PIT_STATUS_OUT	0x80
+#endif
+
 /*
 ** PRIVATE DATA TYPES
 */
@@ -40,6 +74,36 @@
 static uint32_t _pinwheel;   // pinwheel counter
 static uint32_t _pindex;     // index into pinwheel string
 
+// TSC value at boot, and the cycles-to-nanoseconds factor
+static uint64_t _tsc_base;
+static uint32_t _tsc_mult;
+
+// is the tick coming from the LAPIC timer (rather than the PIT)?
+static bool_t _clk_lapic;
+
+// LAPIC timer counts per tick
+static uint32_t _clk_lapic_count;
+
+// has the PIT's interrupt been unmasked for one-shot events?
+static bool_t _clk_event_on;
+
+#if defined(SYSTEM_STATUS)
+// the time of the last status report, and the idle time then
+static time_t _st_time;
+static uint32_t _st_idle;
+#endif
+
+#ifdef TICKLESS_IDLE
+// one-shot (tickless) state; a one-shot is measured in PIT counts,
+// LAPIC timer counts, or TSC cycles for a TSC deadline
+static bool_t _clk_oneshot;     // is the timer counting down once?
+static uint32_t _clk_count;     // the count it was started with
+static uint64_t _clk_start;     // TSC when it was started (deadlines only)
+static uint32_t _clk_skipped;   // ticks passing without an interrupt
+static uint32_t _clk_shot_tick; // one-shot counts per tick
+static uint32_t _clk_shot_max;  // most ticks one one-shot may cover
+#endif
+
 /*
 ** PUBLIC GLOBAL VARIABLES
 */
@@ -47,13 +111,177 @@ static uint32_t _pindex;     // index into pinwheel string
 // current system time
 time_t _system_time;
 
-// queue of sleeping processes
-queue_t _sleeping;
+// TSC frequency, in kHz
+uint32_t _clk_tsc_khz;
 
 /*
 ** PRIVATE FUNCTIONS
 */
 
+/**
+** Name:  _clk_program
+**
+** Start PIT channel 0 counting
+**
+** @param mode    PIT_0_SQUARE for the periodic tick, or PIT_MODE_0
+**                for a single interrupt when the count runs out
+** @param count   The count to load
+*/
+static void _clk_program( uint8_t mode, uint32_t count ) {
+    __outb( PIT_CONTROL_PORT, PIT_0_LOAD | mode );
+    __outb( PIT_0_PORT, count & 0xff );        // LSB of count
+    __outb( PIT_0_PORT, (count >> 8) & 0xff ); // MSB of count
+}
+
+/**
+** Name:  _clk_periodic
+**
+** Start the periodic tick, from whichever timer we are using
+*/
+static void _clk_periodic( void ) {
+    if( _clk_lapic ) {
+        _lapic_timer( LAPIC_TIMER_PERIODIC, _clk_lapic_count );
+    } else {
+        _clk_program( PIT_0_SQUARE, TICK_COUNT );
+    }
+}
+
+#ifdef TICKLESS_IDLE
+/**
+** Name:  _clk_shot
+**
+** Have the timer interrupt us once, rather than periodically
+**
+** @param count   How long from now, in one-shot counts
+*/
+static void _clk_shot( uint32_t count ) {
+    _clk_count = count;
+    if( !_clk_lapic ) {
+        _clk_program( PIT_MODE_0, count );
+    } else if( _lapic_deadline ) {
+        _clk_start = __rdtsc();
+        _lapic_timer_deadline( _clk_start + count );
+    } else {
+        _lapic_timer( LAPIC_TIMER_ONESHOT, count );
+    }
+}
+
+/**
+** Name:  _clk_shot_elapsed
+**
+** See how far the current one-shot has gotten
+**
+** @param elapsed   (output) one-shot counts since it was started
+**
+** @return false if it has already gone off, else true
+*/
+static bool_t _clk_shot_elapsed( uint32_t *elapsed ) {
+
+    if( _clk_lapic && _lapic_deadline ) {
+        uint32_t now = (uint32_t) (__rdtsc() - _clk_start);
+        if( now >= _clk_count ) {
+            return false;
+        }
+        *elapsed = now;
+        return true;
+    }
+
+    uint32_t left;
+    if( _clk_lapic ) {
+        left = _lapic_timer_left();
+        if( left == 0 ) {
+            return false;
+        }
+    } else {
+        // the OUT pin goes high when the count runs out
+        __outb( PIT_CONTROL_PORT,
+                PIT_READBACK | PIT_RB_NOT_COUNT | PIT_RB_CHAN_0 );
+        if( __inb(PIT_0_PORT) & PIT_STATUS_OUT ) {
+            return false;
+        }
+        // latch the count and see how far it has gotten
+        __outb( PIT_CONTROL_PORT, PIT_0_SELECT );
+        left = __inb( PIT_0_PORT );
+        left |= __inb( PIT_0_PORT ) << 8;
+    }
+
+    *elapsed = _clk_count - left;
+    return true;
+}
+#endif
+
+/**
+** Name:  _clk_div64
+**
+** 64-bit by 32-bit division, the slow way; we have no libgcc to
+** do it for us, and it is only needed at boot time
+**
+** @param n   The dividend
+** @param d   The divisor
+**
+** @return n / d
+*/
+static uint64_t _clk_div64( uint64_t n, uint32_t d ) {
+    uint64_t q = 0;
+    uint64_t r = 0;
+
+    for( int i = 63; i >= 0; --i ) {
+        r = (r << 1) | ((n >> i) & 1);
+        if( r >= d ) {
+            r -= d;
+            q |= 1ULL << i;
+        }
+    }
+
+    return( q );
+}
+
+/**
+** Name:  _clk_calibrate
+**
+** Measure the TSC frequency (and the LAPIC timer's, if we are using
+** it) against PIT channel 2, and set up the nanosecond clock.  Must
+** be called with interrupts disabled.
+*/
+static void _clk_calibrate( void ) {
+
+    // stop channel 2, and keep it away from the speaker
+    uint8_t gate = __inb( PIT_2_GATE_PORT ) & ~(PIT_2_GATE | PIT_2_SPEAKER);
+    __outb( PIT_2_GATE_PORT, gate );
+
+    // load it in mode 0, so OUT goes high when the count runs out
+    __outb( PIT_CONTROL_PORT, PIT_2_SELECT | PIT_2_READ | PIT_MODE_0 );
+    __outb( PIT_2_PORT, CAL_COUNT & 0xff );
+    __outb( PIT_2_PORT, (CAL_COUNT >> 8) & 0xff );
+
+    // let it count, and see how many cycles (and LAPIC timer
+    // counts) that takes
+    if( _clk_lapic ) {
+        _lapic_timer( LAPIC_TIMER_ONESHOT | LAPIC_LVT_MASKED, 0xffffffff );
+    }
+    uint64_t start = __rdtsc();
+    __outb( PIT_2_GATE_PORT, gate | PIT_2_GATE );
+    while( (__inb(PIT_2_GATE_PORT) & PIT_2_OUT) == 0 ) {
+        continue;
+    }
+    uint64_t cycles = __rdtsc() - start;
+    uint32_t counts = 0xffffffff - (_clk_lapic ? _lapic_timer_left() : 0);
+    __outb( PIT_2_GATE_PORT, gate );
+
+    if( _clk_lapic ) {
+        _lapic_timer( LAPIC_LVT_MASKED, 0 );
+        _clk_lapic_count = _clk_div64( (uint64_t) counts * PIT_FREQUENCY,
+                CAL_COUNT * CLOCK_FREQUENCY );
+        assert( _clk_lapic_count > 0 );
+    }
+
+    _clk_tsc_khz = _clk_div64( cycles * PIT_FREQUENCY, CAL_COUNT * 1000 );
+    assert( _clk_tsc_khz > 0 );
+
+    _tsc_mult = _clk_div64( 1000000ULL << TSC_SHIFT, _clk_tsc_khz );
+    _tsc_base = __rdtsc();
+}
+
 /**
 ** Name:  _clk_isr
 **
@@ -81,89 +309,100 @@ static void _clk_isr( int vector, int code ) {
     // reporting frequency, in seconds.
 
     if( (_system_time % SEC_TO_TICKS(SYSTEM_STATUS)) == 0 ) {
-		__cio_printf_at( 1, 0, " queues: RQ[%d,%d,%d] SL[%d] SIO[%d]   ",
-				QUE_LENGTH(&_ready[SysPrio]),
-				QUE_LENGTH(&_ready[UserPrio]),
-				QUE_LENGTH(&_ready[DeferredPrio]),
-				QUE_LENGTH(&_sleeping),
-				QUE_LENGTH(&_sio_readq)
+		uint32_t user = 0;
+		for( int n = LVL_USER_TOP; n <= LVL_USER_BOT; ++n ) {
+			user += QUE_LENGTH(&_ready[n]);
+		}
+		// CPU utilization (percent busy) since the last report
+		uint32_t idle = _sch_idletime();
+		uint32_t busy = 0;
+		if( _system_time != _st_time ) {
+			busy = 100 - ((idle - _st_idle) * 100) /
+					(_system_time - _st_time);
+		}
+		_st_idle = idle;
+		_st_time = _system_time;
+		__cio_printf_at( 1, 0, " queues: RQ[%d,%d,%d] TM[%d] SIO[%d] CPU[%d]   ",
+				QUE_LENGTH(&_ready[LVL_SYS]),
+				user,
+				QUE_LENGTH(&_ready[LVL_DEFERRED]),
+				_timer_count(),
+				QUE_LENGTH(&_sio_readq),
+				busy
 				);
 	}
 
 #endif
 
+#ifdef TICKLESS_IDLE
+	// if the clock was stopped, account for the ticks that went by
+	// without interrupts, and go back to ticking periodically
+	if( _clk_oneshot ) {
+		_system_time += _clk_skipped;
+		_clk_skipped = 0;
+		_clk_oneshot = false;
+		_clk_periodic();
+	}
+#endif
+
     // time marches on!
     ++_system_time;
 
-	// wake up any sleeping processes whose time has come
-	//
-	// we give them preference over the current process (when
-	// it is scheduled again)
+	// run any timers whose time has come; this is what wakes up
+	// sleeping processes, which get preference over the current
+	// process (when it is scheduled again)
+	_timer_tick();
 
-	do {
-
-		// if there isn't anyone in the sleep queue, we're done
-		if( QUE_IS_EMPTY(&_sleeping) ) {
-			break;
-		}
-
-		// peek at the first member of the queue
-		pcb_t *pcb = NULL;
-		assert(_que_peek( &_sleeping, (void **) &pcb ) == S_OK );
-
-		// the retrieved PCB's wakeup time is the earliest time for
-		// any process on the sleep queue; if that's greater than
-		// the current time, there's nobody left to awaken
+	// if only the idle process wants the CPU, use some of the
+	// time to get deferred memory clearing done
+	bool_t busy = false;
+	if( _current == _idle_pcb ) {
+		busy = _km_scrub();
+	}
 
-		if( pcb->wakeup > _system_time ) {
-			break;
+	// next, charge this tick to the current process; this may
+	// select a new current process
+	_sch_tick();
+
+#ifdef TICKLESS_IDLE
+	// if there is nothing to do until the next timer expires, stop
+	// the periodic tick and have the timer interrupt us just once, then
+	if( !busy && _sch_idle() ) {
+		uint32_t ticks = _timer_next( _clk_shot_max );
+		if( ticks > 1 ) {
+			_clk_skipped = ticks - 1;
+			_clk_oneshot = true;
+			_clk_shot( ticks * _clk_shot_tick );
 		}
-
-		// OK, we need to wake someone up
-		assert( _que_remove( &_sleeping, (void **) &pcb ) == S_OK );
-		assert( _schedule(pcb) == S_OK );
-
-	} while( 1 );
-
-	// next, we decrement the current process' remaining quantum
-	_current->ticks_left -= 1;
-
-	// has it expired?
-	if( _current->ticks_left < 1 ) {
-		// yes! reschedule it
-		assert( _schedule(_current) == S_OK );
-		// pick a new current process
-		_dispatch();
 	}
+#else
+	(void) busy;
+#endif
 
-    // tell the PIC we're done
-    __outb( PIC_PRI_CMD_PORT, PIC_EOI );
+    // tell the LAPIC or the PIC we're done
+    if( _clk_lapic ) {
+        LAPIC_ACK();
+    } else {
+        __outb( PIC_PRI_CMD_PORT, PIC_EOI );
+    }
 }
 
 /**
-** Name:	_ord_wakeup
+** Name:  _clk_event_isr
 **
-** Compare two PCB wakeup times.
+** The ISR for one-shot events from the PIT (only when the tick comes
+** from the LAPIC timer)
 **
-** @param p1   first PCB
-** @param p2   second PCB
-**
-** @return integer indicating the relationship between the wakeup times:
-**   < 0 --> 'p1' <  'p2'
-**   = 0 --> 'p1' == 'p2'
-**   > 0 --> 'p1' >  'p2'
+** @param vector    Vector number for the PIT interrupt
+** @param code      Error code (0 for this interrupt)
 */
-static int _ord_wakeup( void *p1, void *p2 )
-{
-	uint32_t w1 = ((pcb_t *)p1)->wakeup;
-	uint32_t w2 = ((pcb_t *)p2)->wakeup;
+static void _clk_event_isr( int vector, int code ) {
 
-	if( w1 < w2 )
-		return -1;
-	else if( w1 == w2 )
-		return 0;
-	else
-		return 1;
+	// run the high-resolution timers which have come due
+	_hrt_expire();
+
+    // tell the PIC we're done
+    __outb( PIC_PRI_CMD_PORT, PIC_EOI );
 }
 
 /*
@@ -185,17 +424,131 @@ void _clk_init( void ) {
     // return to the dawn of time
     _system_time = 0;
 
-	// configure the sleep queue
-	_que_create( &_sleeping, _ord_wakeup );
+	// set up the timer wheel and the high-resolution timers
+	_timer_init();
+	_hrt_init();
 
-    // configure the clock
-    uint32_t divisor = PIT_FREQUENCY / CLOCK_FREQUENCY;
-    __outb( PIT_CONTROL_PORT, PIT_0_LOAD | PIT_0_SQUARE );
-    __outb( PIT_0_PORT, divisor & 0xff );        // LSB of divisor
-    __outb( PIT_0_PORT, (divisor >> 8) & 0xff ); // MSB of divisor
+#ifndef CLOCK_PIT
+	// tick with the LAPIC timer if there is one
+	_clk_lapic = _lapic_init();
+#endif
+
+	// find out how fast the TSC (and the LAPIC timer) run; this
+	// uses PIT channel 2, so it doesn't disturb the tick
+	_clk_calibrate();
+
+#ifdef TICKLESS_IDLE
+	// one-shots use a TSC deadline if they can
+	if( !_clk_lapic ) {
+		_clk_shot_tick = TICK_COUNT;
+	} else if( _lapic_deadline ) {
+		_clk_shot_tick = _clk_div64( (uint64_t) _clk_tsc_khz * 1000,
+				CLOCK_FREQUENCY );
+	} else {
+		_clk_shot_tick = _clk_lapic_count;
+	}
+	_clk_shot_max = (_clk_lapic ? 0xffffffff : 0xffff) / _clk_shot_tick;
+#endif
 
-    // register the second-stage ISR
-    __install_isr( INT_VEC_TIMER, _clk_isr );
+    // register the second-stage ISR; with the LAPIC timer, the
+    // PIT's interrupt is no longer needed
+    // (until it is used for one-shot events)
+    if( _clk_lapic ) {
+        __install_isr( LAPIC_VEC_TIMER, _clk_isr );
+        __install_isr( INT_VEC_TIMER, _clk_event_isr );
+        __outb( PIC_PRI_IMR_PORT, __inb(PIC_PRI_IMR_PORT) | PIC_IRQ_TIMER );
+    } else {
+        __install_isr( INT_VEC_TIMER, _clk_isr );
+    }
+
+    // configure the clock
+    _clk_periodic();
 
     __cio_puts( " CLK" );
 }
+
+/**
+** Name:  _clk_ns
+**
+** @return the number of nanoseconds since the clock was initialized,
+**         as measured by the TSC
+*/
+uint64_t _clk_ns( void ) {
+	uint64_t cycles = __rdtsc() - _tsc_base;
+	uint32_t hi = (uint32_t) (cycles >> 32);
+	uint32_t lo = (uint32_t) cycles;
+
+	// (cycles * _tsc_mult) >> TSC_SHIFT, without a 96-bit product
+	return( (((uint64_t) hi * _tsc_mult) << (32 - TSC_SHIFT)) +
+			(((uint64_t) lo * _tsc_mult) >> TSC_SHIFT) );
+}
+
+/**
+** Name:  _clk_resume
+**
+** Called when a process becomes ready.  If the periodic tick was
+** stopped while the CPU idled, bring the system time up to date
+** from the timer's count, then finish out the current tick with one
+** more one-shot count; its interrupt restarts the periodic tick
+** in phase with the ticks that went before.
+*/
+void _clk_resume( void ) {
+#ifdef TICKLESS_IDLE
+
+	// nothing to do if the tick is running, or already resuming
+	if( !_clk_oneshot || _clk_skipped == 0 ) {
+		return;
+	}
+
+	// if the count has run out, its interrupt will catch us up
+	uint32_t elapsed;
+	if( !_clk_shot_elapsed(&elapsed) ) {
+		return;
+	}
+
+	_system_time += elapsed / _clk_shot_tick;
+	_clk_skipped = 0;
+	_clk_shot( _clk_shot_tick - elapsed % _clk_shot_tick );
+#endif
+}
+
+/**
+** Name:  _clk_event_ok
+**
+** @return true if _clk_event() can deliver one-shot events; this
+**         needs the PIT, so only when the tick comes from the LAPIC
+*/
+bool_t _clk_event_ok( void ) {
+	return _clk_lapic;
+}
+
+/**
+** Name:  _clk_event
+**
+** Ask for a one-shot event; _hrt_expire() will be called when it
+** happens.  Any event already asked for is replaced.
+**
+** @param ns   How far from now it should happen (at most ~54ms)
+**
+** @return true if it was set up, else false (see _clk_event_ok())
+*/
+bool_t _clk_event( uint32_t ns ) {
+
+	if( !_clk_lapic ) {
+		return false;
+	}
+
+	// round up, so it is never early
+	uint32_t count = (uint32_t) (((uint64_t) ns * NS_TO_PIT_MULT) >> 32) + 1;
+	if( count > 0xffff ) {
+		count = 0xffff;
+	}
+	_clk_program( PIT_MODE_0, count );
+
+	if( !_clk_event_on ) {
+		_clk_event_on = true;
+		__outb( PIC_PRI_IMR_PORT, __inb(PIC_PRI_IMR_PORT) & ~PIC_IRQ_TIMER );
+	}
+
+	return true;
+}
@@ -47,8 +47,8 @@
 // current system time
 extern time_t _system_time;
 
-// queue of sleeping processes
-extern queue_t _sleeping;
+// TSC frequency, in kHz
+extern uint32_t _clk_tsc_khz;
 
 /*
 ** Prototypes
@@ -62,6 +62,41 @@ extern queue_t _sleeping;
 */
 void _clk_init( void );
 
+/**
+** Name:  _clk_ns
+**
+** @return the number of nanoseconds since the clock was initialized,
+**         as measured by the TSC
+*/
+uint64_t _clk_ns( void );
+
+/**
+** Name:  _clk_event_ok
+**
+** @return true if _clk_event() can deliver one-shot events
+*/
+bool_t _clk_event_ok( void );
+
+/**
+** Name:  _clk_event
+**
+** Ask for a one-shot event; _hrt_expire() will be called when it
+** happens.  Any event already asked for is replaced.
+**
+** @param ns   How far from now it should happen (at most ~54ms)
+**
+** @return true if it was set up, else false (see _clk_event_ok())
+*/
+bool_t _clk_event( uint32_t ns );
+
+/**
+** Name:  _clk_resume
+**
+** Restart the periodic tick if it was stopped while the CPU idled
+** (TICKLESS_IDLE only); called when a process becomes ready
+*/
+void _clk_resume( void );
+
 #endif
 /* SP_ASM_SRC */
 
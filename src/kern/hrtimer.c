@@ -0,0 +1,238 @@
+/**
+** @file	hrtimer.c
+**
+** @brief	High-resolution timer implementation
+**
+** A timer whose expiration is more than HRT_NEAR away is put on the
+** timing wheel, for a tick at least one tick before it expires; when
+** that tick comes, it is placed again.  Once it is near, it goes on
+** a list ordered by expiration time, and the clock is asked for a
+** one-shot interrupt when the first timer on the list comes due.
+**
+** Riding the wheel means that long timers cost nothing per tick, and
+** that the tickless idle code sees them through _timer_next().
+*/
+
+#define SP_KERNEL_SRC
+
+#include "common.h"
+
+#include "hrtimer.h"
+
+#include "clock.h"
+#include "kernel.h"
+#include "timer.h"
+#include "util/queues.h"
+
+/*
+** PRIVATE DEFINITIONS
+*/
+
+// where the near-list links are in a timer
+#define HRT_QLINK		IQ_OFFSET(hrtimer_t,link)
+
+/*
+** PRIVATE GLOBAL VARIABLES
+*/
+
+// timers within HRT_NEAR of expiring, soonest first
+static iqueue_t _hrt_near;
+
+/*
+** PRIVATE FUNCTIONS
+*/
+
+/**
+** Name:	_hrt_sooner
+**
+** Ordering function for the list of near timers
+**
+** @param t1   One timer
+** @param t2   Another timer
+**
+** @return < 0 if t1 expires first, 0 if at the same time, > 0 if later
+*/
+static int _hrt_sooner( void *t1, void *t2 ) {
+	uint64_t e1 = ((hrtimer_t *) t1)->expires;
+	uint64_t e2 = ((hrtimer_t *) t2)->expires;
+
+	return e1 < e2 ? -1 : (e1 > e2 ? 1 : 0);
+}
+
+/**
+** Name:	_hrt_program
+**
+** Ask for an interrupt when the first near timer comes due
+*/
+static void _hrt_program( void ) {
+	hrtimer_t *first;
+
+	if( _iq_peek(&_hrt_near,(void **) &first) == S_OK ) {
+		uint64_t now = _clk_ns();
+		(void) _clk_event( first->expires > now ?
+				(uint32_t) (first->expires - now) : 0 );
+	}
+}
+
+static void _hrt_coarse( ktimer_t *coarse, void *arg );
+
+/**
+** Name:	_hrt_place
+**
+** Put a timer on the wheel or the near list, as its expiration
+** time requires
+**
+** @param timer   The timer
+** @param now     The current nanosecond clock time
+*/
+static void _hrt_place( hrtimer_t *timer, uint64_t now ) {
+	uint64_t delta = timer->expires > now ? timer->expires - now : 0;
+
+	if( delta > HRT_NEAR ) {
+
+		// a tick which is sure to come before it is due; far off
+		// timers are first brought nearer, in steps of ~2^20 ns
+		uint32_t ticks = delta >> 32 ? (uint32_t) (delta >> 20) :
+				(uint32_t) delta / NS_PER_TICK - 1;
+		_timer_arm( &timer->coarse, _system_time + ticks );
+
+	} else if( !_clk_event_ok() ) {
+
+		// without a one-shot interrupt, the best we can do is
+		// the next tick
+		_timer_arm( &timer->coarse, _system_time + 1 );
+
+	} else {
+
+		timer->near = true;
+		assert( _iq_insert(&_hrt_near,timer) == S_OK );
+		hrtimer_t *first;
+		if( _iq_peek(&_hrt_near,(void **) &first) == S_OK &&
+				first == timer ) {
+			_hrt_program();
+		}
+	}
+}
+
+/**
+** Name:	_hrt_coarse
+**
+** Wheel timer callback:  the timer is either due, or near enough to
+** be placed again
+**
+** @param coarse   The wheel timer
+** @param arg      The high-resolution timer
+*/
+static void _hrt_coarse( ktimer_t *coarse, void *arg ) {
+	hrtimer_t *timer = (hrtimer_t *) arg;
+	uint64_t now = _clk_ns();
+
+	if( timer->expires <= now ) {
+		timer->func( timer, timer->arg );
+	} else {
+		_hrt_place( timer, now );
+	}
+}
+
+/*
+** PUBLIC FUNCTIONS
+*/
+
+/**
+** Name:	_hrt_init
+**
+** Initializes the high-resolution timer module
+*/
+void _hrt_init( void ) {
+	_iq_create( &_hrt_near, _hrt_sooner, HRT_QLINK );
+}
+
+/**
+** Name:	_hrt_setup
+**
+** Prepare a timer for use
+**
+** @param timer   The timer
+** @param func    The function to call when it expires
+** @param arg     The argument to pass to func
+*/
+void _hrt_setup( hrtimer_t *timer, hrtimer_fn_t func, void *arg ) {
+	assert1( timer != NULL && func != NULL );
+
+	_timer_setup( &timer->coarse, _hrt_coarse, timer );
+	timer->link.prev = timer->link.next = NULL;
+	timer->expires = 0;
+	timer->func = func;
+	timer->arg = arg;
+	timer->near = false;
+}
+
+/**
+** Name:	_hrt_arm
+**
+** Arm a timer to fire at a given nanosecond clock time; a pending
+** timer is moved to the new time
+**
+** @param timer     The timer
+** @param expires   When it should fire
+*/
+void _hrt_arm( hrtimer_t *timer, uint64_t expires ) {
+	assert1( timer != NULL );
+
+	(void) _hrt_cancel( timer );
+	timer->expires = expires;
+	_hrt_place( timer, _clk_ns() );
+}
+
+/**
+** Name:	_hrt_cancel
+**
+** Disarm a timer
+**
+** @param timer   The timer
+**
+** @return S_OK if it was pending, else S_NOTFOUND
+*/
+status_t _hrt_cancel( hrtimer_t *timer ) {
+	assert1( timer != NULL );
+
+	// if it was first on the near list, the interrupt we asked for
+	// will find nothing to do, and ask for the next one
+	if( timer->near ) {
+		assert( _iq_remove_ptr(&_hrt_near,timer) == S_OK );
+		timer->near = false;
+		return S_OK;
+	}
+
+	return _timer_cancel( &timer->coarse );
+}
+
+/**
+** Name:	_hrt_pending
+**
+** @param timer   The timer
+**
+** @return true if the timer is armed and has not yet fired
+*/
+bool_t _hrt_pending( hrtimer_t *timer ) {
+	return timer->near || _timer_pending( &timer->coarse );
+}
+
+/**
+** Name:	_hrt_expire
+**
+** Run the near timers which have come due, and ask for an interrupt
+** when the next one will.  Called by the clock's one-shot ISR.
+*/
+void _hrt_expire( void ) {
+	hrtimer_t *timer;
+
+	while( _iq_peek(&_hrt_near,(void **) &timer) == S_OK &&
+			timer->expires <= _clk_ns() ) {
+		assert( _iq_remove(&_hrt_near,(void **) &timer) == S_OK );
+		timer->near = false;
+		timer->func( timer, timer->arg );
+	}
+
+	_hrt_program();
+}
@@ -0,0 +1,132 @@
+/**
+** @file	hrtimer.h
+**
+** @brief	High-resolution timer declarations
+**
+** High-resolution timers expire at a nanosecond clock time rather
+** than at a clock tick.  A timer rides the timing wheel until it is
+** within HRT_NEAR of expiring; then it moves to a short list which
+** is served by a one-shot timer interrupt (see _clk_event()), so it
+** fires within a few microseconds of the requested time.  Without a
+** one-shot timer to spare, it fires on the first tick after that
+** time instead.
+*/
+
+#ifndef HRTIMER_H_
+#define HRTIMER_H_
+
+#include "common.h"
+
+#include "util/queues.h"
+#include "kern/timer.h"
+
+/*
+** General (C and/or assembly) definitions
+*/
+
+// nanoseconds per clock tick
+#define NS_PER_TICK		(1000000000 / CLOCK_FREQUENCY)
+
+// how close to expiring a timer must be to be served by the
+// one-shot interrupt rather than by the timing wheel
+#define HRT_NEAR		(2 * NS_PER_TICK)
+
+#ifndef SP_ASM_SRC
+
+/*
+** Start of C-only definitions
+*/
+
+/*
+** Types
+*/
+
+typedef struct hrtimer_s hrtimer_t;
+
+// the function called when a timer expires; it may re-arm the timer
+typedef void (*hrtimer_fn_t)( hrtimer_t *timer, void *arg );
+
+/*
+** A high-resolution timer
+**
+** Like a kernel timer, set it up once with _hrt_setup(); after
+** that, it can be armed and cancelled any number of times.
+*/
+struct hrtimer_s {
+	ktimer_t coarse;		// on the wheel until it is near expiring
+	qlink_t link;			// then, links in the list of near timers
+	uint64_t expires;		// _clk_ns() time at which it fires
+	hrtimer_fn_t func;		// what to call then
+	void *arg;				// and what to pass to it
+	bool_t near;			// on the list of near timers?
+};
+
+/*
+** Globals
+*/
+
+/*
+** Prototypes
+*/
+
+/**
+** Name:	_hrt_init
+**
+** Initializes the high-resolution timer module
+*/
+void _hrt_init( void );
+
+/**
+** Name:	_hrt_setup
+**
+** Prepare a timer for use
+**
+** @param timer   The timer
+** @param func    The function to call when it expires
+** @param arg     The argument to pass to func
+*/
+void _hrt_setup( hrtimer_t *timer, hrtimer_fn_t func, void *arg );
+
+/**
+** Name:	_hrt_arm
+**
+** Arm a timer to fire at a given nanosecond clock time; a pending
+** timer is moved to the new time
+**
+** @param timer     The timer
+** @param expires   When it should fire
+*/
+void _hrt_arm( hrtimer_t *timer, uint64_t expires );
+
+/**
+** Name:	_hrt_cancel
+**
+** Disarm a timer
+**
+** @param timer   The timer
+**
+** @return S_OK if it was pending, else S_NOTFOUND
+*/
+status_t _hrt_cancel( hrtimer_t *timer );
+
+/**
+** Name:	_hrt_pending
+**
+** @param timer   The timer
+**
+** @return true if the timer is armed and has not yet fired
+*/
+bool_t _hrt_pending( hrtimer_t *timer );
+
+/**
+** Name:	_hrt_expire
+**
+** Run the near timers which have come due, and ask for an interrupt
+** when the next one will.  Called by the clock's one-shot ISR.
+*/
+void _hrt_expire( void );
+
+#endif
+// !SP_ASM_SRC
+
+#endif
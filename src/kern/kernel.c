@@ -19,7 +19,10 @@
 #include "io/cio.h"
 #include "acpi/acpi.h"
 #include "clock.h"
+#include "timer.h"
 #include "mem/kmem.h"
+#include "mem/kmalloc.h"
+#include "mem/vm.h"
 #include "sched.h"
 #include "io/sio.h"
 #include "support.h"
@@ -30,6 +33,9 @@
 // need address of the init() function
 USERMAIN( init );
 
+// the idle process runs here, in the kernel
+static int32_t _kidle( int32_t argc, char *argv[] );
+
 /*
 ** PRIVATE DEFINITIONS
 */
@@ -75,6 +81,7 @@ const char *_state_str[N_STATES][2] = {
 	[ Sleeping ] = { "Sleeping", "Slp" },
 	[ Blocked  ] = { "Blocked",	 "Blk" },
 	[ Waiting  ] = { "Waiting",	 "Wtg" },
+	[ Joining  ] = { "Joining",	 "Joi" },
 	[ Killed   ] = { "Killed"	 "Kil" },
 	[ Zombie   ] = { "Zombie",	 "Zom" }
 };
@@ -100,10 +107,11 @@ const char *_prio_str[N_PRIOS] = {
 static void _kreport( bool_t dtrace ) {
 
 	__cio_puts( "\n-------------------------------\n" );
-	__cio_printf( "Config:	N_PROCS = %d", N_PROCS );
+	__cio_printf( "Config:	N_PROCS = %d (%u in use)", N_PROCS, _pcb_count );
 	__cio_printf( " N_PRIOS = %d", N_PRIOS );
 	__cio_printf( " N_STATES = %d", N_STATES );
-	__cio_printf( " CLOCK = %dHz\n", CLOCK_FREQUENCY );
+	__cio_printf( " CLOCK = %dHz", CLOCK_FREQUENCY );
+	__cio_printf( " TSC = %dkHz\n", _clk_tsc_khz );
 
 	// This code is ugly, but it's the simplest way to
 	// print out the values of compile-time options
@@ -225,13 +233,15 @@ static void _kshell( int code ) {
 
 	case 'q':  // dump the queues
 		// code to dump out any/all queues
-		_que_dump( "Sleep", _sleeping );
+		__cio_printf( "Timers: %u pending\n", _timer_count() );
 #ifdef QNAME
 		_que_dump( "SIO", QNAME );
 #endif
-		_que_dump( "R[S]", _ready[SysPrio] );
-		_que_dump( "R[U]", _ready[UserPrio] );
-		_que_dump( "R[D]", _ready[DeferredPrio] );
+		for( int n = 0; n < N_LEVELS; ++n ) {
+			__cio_printf( "R[%d]: %d\n", n, QUE_LENGTH(&_ready[n]) );
+		}
+		__cio_printf( "Idle: %u of %u ms\n", _sch_idletime(),
+				_system_time );
 		break;
 
 	case 'r':  // print system configuration information
@@ -240,12 +250,20 @@ static void _kshell( int code ) {
 
 	case 's':  // dump stack info for all active PCBS
 		__cio_puts( "\nActive stacks (w/5-sec. delays):\n" );
-		register pcb_t *pcb = _processes;
-		for( register int i = 0; i < N_PROCS; ++i, ++pcb ) {
-			if( pcb->state != Unused ) {
-				__cio_printf( "pid %5u: ", pcb->pid );
-				__cio_printf( "EIP %08x, ", pcb->context->eip );
-				_stk_dump( NULL, pcb->stack, 12 );
+		for( pcb_t *pcb = _pcb_first(); pcb != NULL; pcb = _pcb_next(pcb) ) {
+			__cio_printf( "pid %5u: ", pcb->pid );
+			__cio_printf( "EIP %08x, ", VM_REG(pcb,eip) );
+			// the top of the stack, from its own address space
+			uint32_t top[12];
+			_vm_copyin( pcb->proc->pgdir,
+					VM_SLOT_TOP(pcb->slot) - sizeof(top),
+					top, sizeof(top) );
+			__cio_printf( "top of stack:\n" );
+			for( int j = 0; j < 12; ++j ) {
+				__cio_printf( " %08x", top[j] );
+				if( (j & 3) == 3 ) {
+					__cio_putchar( '\n' );
+				}
 			}
 		}
 		break;
@@ -274,6 +292,23 @@ static void _kshell( int code ) {
 }
 #endif
 
+/**
+** _kidle - the idle process
+**
+** Dispatched only when no other process is ready.  It halts the
+** CPU until the next interrupt; if that interrupt makes a process
+** ready, the ISR return path dispatches it (see _sch_unidle()).
+** Processes run in ring 0, so the idle process can do this itself.
+*/
+static int32_t _kidle( int32_t argc, char *argv[] ) {
+
+	for(;;) {
+		__pause();
+	}
+
+	return( 0 );
+}
+
 /*
 ** PUBLIC FUNCTIONS
 */
@@ -339,6 +374,9 @@ void _kinit( void ) {
 	// classic order:  kmem; queue; everything else
 
 	_km_init();		// MUST BE FIRST
+#ifdef KMEM_BENCH
+	_km_bench();
+#endif
 #if TRACING_KMEM || TRACING_KMEM_FREE
 	__delay(50);	// about 1.25 seconds
 #endif
@@ -348,6 +386,8 @@ void _kinit( void ) {
 	__delay(50);
 #endif
 
+	_kma_init();
+
 	// other module initialization calls here
 	_acpi_init();
 
@@ -355,6 +395,9 @@ void _kinit( void ) {
 	_pcb_init();
 
 	_vfs_init();
+#ifdef SLAB_BENCH
+	_vfs_bench();
+#endif
 #if TRACING_PCB
 	__delay(50);
 #endif
@@ -363,6 +406,7 @@ void _kinit( void ) {
 #if TRACING_STACK
 	__delay(50);
 #endif
+	_vm_init();
 	_sio_init();
 	_sys_init();
 #if TRACING_SYSCALLS || TRACING_SYSRETS
@@ -392,21 +436,25 @@ void _kinit( void ) {
 	*/
 
     // allocate the necessary data structures
-    pcb_t *pcb = _pcb_alloc();
+    pcb_t *pcb = _pcb_alloc( NULL );
     assert( pcb != NULL );
 
-    pcb->stack = _stk_alloc();
-    assert( pcb->stack != NULL );
+    pcb->proc->pgdir = _vm_create();
+    assert( pcb->proc->pgdir != NULL );
 
     // fill in the PCB
     pcb->pid = pcb->ppid = PID_INIT;
     pcb->state = New;
     pcb->priority = SysPrio;
-	pcb->cwd = g_root_dirent;
+	pcb->proc->pid = PID_INIT;
+	pcb->proc->cwd = g_root_dirent;
+	pcb->proc->slots = 1U << pcb->slot;
+	_pcb_enroll( pcb );
 
     // process context area and initial stack contents
 	char *args[] = { "init", "+", NULL };
-    context_t *ctx = _stk_setup( pcb->stack, (uint32_t) init, args );
+    context_t *ctx = _stk_setup( pcb->proc->pgdir, VM_STACK_TOP,
+			(uint32_t) init, args );
     assert( ctx != NULL );
 
     // remember where the context area is
@@ -415,7 +463,32 @@ void _kinit( void ) {
 	// remember which PCB is 'init'
 	_init_pcb = pcb;
 
-    // schedule and dispatch it
+	/*
+	** Create the idle process.  It is never put on a ready queue;
+	** _dispatch() selects it when no other process is ready.
+	*/
+
+	_idle_pcb = _pcb_alloc( NULL );
+	assert( _idle_pcb != NULL );
+
+	_idle_pcb->proc->pgdir = _vm_create();
+	assert( _idle_pcb->proc->pgdir != NULL );
+
+	_idle_pcb->pid = _idle_pcb->ppid = PID_IDLE;
+	_idle_pcb->state = Ready;
+	_idle_pcb->priority = DeferredPrio;
+	_idle_pcb->level = LVL_DEFERRED;
+	_idle_pcb->proc->pid = PID_IDLE;
+	_idle_pcb->proc->cwd = g_root_dirent;
+	_idle_pcb->proc->slots = 1U << _idle_pcb->slot;
+	_pcb_enroll( _idle_pcb );
+
+	char *iargs[] = { "idle", NULL };
+	_idle_pcb->context = _stk_setup( _idle_pcb->proc->pgdir, VM_STACK_TOP,
+			(uint32_t) _kidle, iargs );
+	assert( _idle_pcb->context != NULL );
+
+    // schedule and dispatch init
     assert( _schedule(pcb) == S_OK );
     _dispatch();
 
@@ -21,6 +21,9 @@
 ** PRIVATE DEFINITIONS
 */
 
+// which PID hash chain a PID is on
+#define	PID_HASH(pid)	((pid) & (N_PROCS - 1))
+
 /*
 ** PRIVATE DATA TYPES
 */
@@ -29,16 +32,22 @@
 ** PRIVATE GLOBAL VARIABLES
 */
 
-// the number of available PCBs
-static uint32_t _avail_pcbs;
+// store for the PCBs themselves
+static slab_cache_t _pcbs;
+
+// the PID hash table:  each chain is linked through the PCBs' hnext
+static pcb_t *_pid_hash[N_PROCS];
+
+// store for the process-wide state shared by a process' threads
+static slab_cache_t _proc_states;
 
 
 /*
 ** PUBLIC GLOBAL VARIABLES
 */
 
-// the process table
-pcb_t _processes[N_PROCS];
+// the number of PCBs in use
+uint32_t _pcb_count;
 
 // next available PID
 pid_t _next_pid;
@@ -46,6 +55,9 @@ pid_t _next_pid;
 // pointer to the PCB for the 'init' process
 pcb_t *_init_pcb;
 
+// pointer to the PCB for the idle process
+pcb_t *_idle_pcb;
+
 // Store for all open file tables
 // NOTE(Adin): Each table is a fixed size
 // 			   (VFS_MAX_NUM_OPEN_FILES * sizeof(kfile_t *))
@@ -56,6 +68,181 @@ slab_cache_t open_file_tables;
 ** PRIVATE FUNCTIONS
 */
 
+/**
+** Name:	_proc_release
+**
+** Drop a reference to a process' shared state; the last one to go
+** takes its open files and its address space with it
+**
+** @param proc  The process
+*/
+static void _proc_release( process_t *proc )
+{
+	if( --proc->refs > 0 ) {
+		return;
+	}
+
+	// close whatever files it left open
+	for( int i = 0; i < VFS_MAX_OPEN_FILES; ++i ) {
+		if( proc->open_files[i] != NULL ) {
+			_vfs_close_file( proc->open_files[i] );
+		}
+	}
+	slab_free( &open_file_tables, proc->open_files );
+
+	// release the address space, stacks and all
+	if( proc->pgdir != NULL ) {
+		_vm_free( proc->pgdir );
+	}
+
+	slab_free( &_proc_states, proc );
+}
+
+/**
+** Name:	_pcb_withdraw
+**
+** Take a PCB out of the PID table, and out of its parent's list of
+** children (or its process' list of threads); a PCB which was never
+** enrolled is left alone
+**
+** @param pcb  The PCB
+*/
+static void _pcb_withdraw( pcb_t *pcb )
+{
+	pcb_t **link = &_pid_hash[PID_HASH(pcb->pid)];
+
+	while( *link != NULL && *link != pcb ) {
+		link = &(*link)->hnext;
+	}
+
+	if( *link == NULL ) {
+		return;
+	}
+	*link = pcb->hnext;
+
+	if( IS_THREAD(pcb) ) {
+		assert( _iq_remove_ptr(&pcb->proc->threads,pcb) == S_OK );
+	} else if( pcb->ppid != pcb->pid ) {
+		pcb_t *parent = _pcb_find( pcb->ppid );
+		assert( parent != NULL );
+		assert( _iq_remove_ptr(&parent->proc->children,pcb) == S_OK );
+	}
+}
+
+/**
+** Name:	_pcb_scan
+**
+** Find the first PCB on a PID hash chain at or after a given one
+**
+** @param chain  Where to start looking
+**
+** @return the PCB, or NULL if those chains are all empty
+*/
+static pcb_t *_pcb_scan( uint32_t chain )
+{
+	for( ; chain < N_PROCS; ++chain ) {
+		if( _pid_hash[chain] != NULL ) {
+			return _pid_hash[chain];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+** Name:	_pcb_leader
+**
+** @param proc  A process
+**
+** @return the PCB for the first thread of the process, or NULL if
+**   it is gone
+*/
+static pcb_t *_pcb_leader( process_t *proc )
+{
+	pcb_t *pcb = _pcb_find( proc->pid );
+
+	// once it is gone, its PID may belong to someone else
+	return( pcb != NULL && pcb->proc == proc ? pcb : NULL );
+}
+
+/**
+** Name:	_pcb_kill_thread
+**
+** Get rid of one of the other threads of a process whose first
+** thread is exiting
+**
+** @param pcb  The thread
+*/
+static void _pcb_kill_thread( pcb_t *pcb )
+{
+	switch( pcb->state ) {
+
+	case Zombie:
+		// nobody is left to join it
+		_pcb_cleanup( pcb );
+		break;
+
+	case Killed:
+		// already on its way out
+		break;
+
+	case Joining:
+		// it isn't on any queue, so it can go right now
+		pcb->exit_status = EXIT_KILLED;
+		_pcb_zombify( pcb );
+		break;
+
+	default:
+		// it goes the next time it is scheduled
+		pcb->exit_status = EXIT_KILLED;
+		pcb->state = Killed;
+	}
+}
+
+/**
+** Name:	_pcb_zombify_thread
+**
+** Do the real work for exit() in a thread:  hand its status to the
+** thread joining it, if there is one
+**
+** @param victim  Pointer to the PCB for the exiting thread
+*/
+static void _pcb_zombify_thread( pcb_t *victim )
+{
+	pcb_t *curr = _pcb_joiner( victim );
+
+	if( curr != NULL ) {
+
+		// intrinsic return value is the TID
+		VM_RET(curr) = victim->pid;
+
+		// may also want to return the exit status
+		uint32_t ptr = VM_ARG(curr,2);
+
+		if( ptr != 0 ) {
+			int32_t *status = _vm_access( curr->proc->pgdir, ptr, true );
+			if( status != NULL ) {
+				*status = victim->exit_status;
+			}
+		}
+
+		// all done - schedule the joiner, and clean up the thread
+		_schedule( curr );
+		_pcb_cleanup( victim );
+
+		return;
+	}
+
+	// if the process itself has gone, nobody ever will join it
+	pcb_t *first = _pcb_leader( victim->proc );
+	if( first == NULL || first->state == Zombie || first->state == Killed ) {
+		_pcb_cleanup( victim );
+		return;
+	}
+
+	victim->state = Zombie;
+}
+
 /*
 ** PUBLIC FUNCTIONS
 */
@@ -70,17 +257,22 @@ slab_cache_t open_file_tables;
 */
 void _pcb_init( void )
 {
-	// clear out all the PCBs
-	CLEAR( _processes );
+	// no PCBs yet
+	CLEAR( _pid_hash );
+	_pcb_count = 0;
 
-	// reset the "free" count
-	_avail_pcbs = N_PROCS;
+	slab_init( &_pcbs, sizeof(pcb_t), 0 );
+	slab_register( &_pcbs, "pcb" );
 
 	// reset the PID counter
 	_next_pid = FIRST_USER_PID;
 
 	// Initialize the open file tables' slab cache
 	slab_init(&open_file_tables, VFS_MAX_OPEN_FILES * sizeof(kfile_t *), SC_INIT_LARGE_SLABS);
+	slab_register(&open_file_tables, "open_file_table");
+
+	slab_init( &_proc_states, sizeof(process_t), 0 );
+	slab_register( &_proc_states, "process" );
 
 	// report that we're done
 	__cio_puts( " PCB" );
@@ -91,48 +283,63 @@ void _pcb_init( void )
 **
 ** Allocates a PCB structure
 **
+** @param proc  The process the PCB is to be a thread of, or NULL if
+**              it is to be the first thread of a new process
+**
 ** @return A pointer to a "clean" PCB, or NULL
 */
-pcb_t *_pcb_alloc( void )
+pcb_t *_pcb_alloc( process_t *proc )
 {
 #if TRACING_PCB
-	__cio_puts( "** _pcb_alloc(), _avail_pcbs %d\n", _avail_pcbs );
+	__cio_printf( "** _pcb_alloc(), %u in use\n", _pcb_count );
 #endif
 
-	// can't allocate one if there aren't any available
-	if( _avail_pcbs < 1 ) {
+	// the scheduler must have room for one more
+	if( _sch_reserve(_pcb_count + 1) != S_OK ) {
 #if TRACING_PCB
 		__cio_puts( "** ALLOC FAILED\n" );
 #endif
 		return NULL;
 	}
 
-	// find the first available PCB structure
-	register int i = 0;
-	register pcb_t *pcb = _processes;
-	while( i < N_PROCS && pcb->state != Unused ) {
-		++i;
-		++pcb;
+	// get a "clean" PCB
+	pcb_t *pcb = slab_alloc( &_pcbs, SC_ALLOC_ZERO_MEM );
+	if( pcb == NULL ) {
+#if TRACING_PCB
+		__cio_puts( "** ALLOC FAILED\n" );
+#endif
+		return NULL;
 	}
 
-	// sanity check - if we ran off the end of the
-	// PCB array without finding a free one, there's
-	// a consistency problem because _avail_pcbs indicated
-	// that there should have been at least one available
-	assert( i < N_PROCS );
+	// a new process starts out with no files, no children and no
+	// address space
+	if( proc == NULL ) {
+		proc = slab_alloc( &_proc_states, SC_ALLOC_ZERO_MEM );
+		if( proc == NULL ) {
+			slab_free( &_pcbs, pcb );
+			return NULL;
+		}
+		proc->open_files = slab_alloc(&open_file_tables, SC_ALLOC_ZERO_MEM);
+		if( proc->open_files == NULL ) {
+			slab_free( &_proc_states, proc );
+			slab_free( &_pcbs, pcb );
+			return NULL;
+		}
+		_iq_create( &proc->children, NULL, PCB_PLINK );
+		_iq_create( &proc->threads, NULL, PCB_PLINK );
+	}
+	proc->refs += 1;
 
-	// zero out the memory and mark this PCB as "in use"
-	CLEAR_PTR( pcb );
+	// mark this PCB as "in use"
 	pcb->state = New;
+	pcb->proc = proc;
 
-	pcb->cwd = NULL;
-	pcb->open_files = slab_alloc(&open_file_tables, SC_ALLOC_ZERO_MEM);
-
-	// one fewer PCB in the pool
-	_avail_pcbs -= 1;
+	// one more PCB in use
+	_pcb_count += 1;
 
 #if TRACING_PCB
-	__cio_puts( "** _pcb_alloc() ret #%d,_avail_pcbs %d\n", i, _avail_pcbs );
+	__cio_printf( "** _pcb_alloc() ret %08x, %u in use\n", (uint32_t) pcb,
+			_pcb_count );
 #endif
 
 	// return the PCB to the caller
@@ -149,27 +356,68 @@ pcb_t *_pcb_alloc( void )
 void _pcb_dealloc( pcb_t *pcb )
 {
 #if TRACING_PCB
-	__cio_printf( "** _pcb_dealloc(%08x), avail %d\n", data, _avail_pcbs );
+	__cio_printf( "** _pcb_dealloc(%08x), %u in use\n", (uint32_t) pcb,
+			_pcb_count );
 #endif
 	// sanity check?
 	assert1( pcb != NULL );
 
-	// one more PCB we can allocate
-	_avail_pcbs += 1;
+	// nobody can find it any more
+	_pcb_withdraw( pcb );
+
+	if( pcb->proc != NULL ) {
+		_proc_release( pcb->proc );
+	}
 
-	// we do the least amount of work necessary here;
-	// if/when this PCB is re-used, we'll clear the
-	// rest of it when it's allocated
 	pcb->state = Unused;		// PCB is inactive
-	pcb->pid = pcb->ppid = 0;	// guard against finding it accidentally
+	slab_free( &_pcbs, pcb );
 
-	if(pcb->open_files) {
-		slab_free(&open_file_tables, pcb->open_files);
+	// one fewer PCB in use
+	_pcb_count -= 1;
+}
+
+/**
+** Name:	_pcb_new_pid
+**
+** Choose a PID for a new process or thread
+**
+** @return a PID which no PCB is using
+*/
+pid_t _pcb_new_pid( void )
+{
+	// PIDs wrap around eventually; skip the ones reserved for the
+	// OS, and the ones still in use
+	while( _next_pid < FIRST_USER_PID || _pcb_find(_next_pid) != NULL ) {
+		++_next_pid;
 	}
 
-#if TRACING_PCB
-	__cio_printf( "** _pcb_dealloc(), avail now %d\n", _avail_pcbs );
-#endif
+	return _next_pid++;
+}
+
+/**
+** Name:	_pcb_enroll
+**
+** Enter a PCB whose PID and PPID have been set into the PID table,
+** and into its parent's list of children (or, for a thread, into its
+** process' list of threads)
+**
+** @param pcb  The PCB
+*/
+void _pcb_enroll( pcb_t *pcb )
+{
+	uint32_t chain = PID_HASH( pcb->pid );
+
+	pcb->hnext = _pid_hash[chain];
+	_pid_hash[chain] = pcb;
+
+	// init and the idle process are their own parents
+	if( IS_THREAD(pcb) ) {
+		assert( _iq_insert(&pcb->proc->threads,pcb) == S_OK );
+	} else if( pcb->ppid != pcb->pid ) {
+		pcb_t *parent = _pcb_find( pcb->ppid );
+		assert( parent != NULL );
+		assert( _iq_insert(&parent->proc->children,pcb) == S_OK );
+	}
 }
 
 /**
@@ -188,25 +436,80 @@ pcb_t *_pcb_find( pid_t pid )
 	__cio_printf( "** _pcb_find(%u)", pid );
 #endif
 
-	// iterate through the PCB table
-	register pcb_t *pcb = _processes;
+	// only one hash chain can hold it
+	register pcb_t *pcb = _pid_hash[PID_HASH(pid)];
 
-	for( int i = 0; i < N_PROCS; ++i, ++pcb ) {
+	while( pcb != NULL && pcb->pid != pid ) {
+		pcb = pcb->hnext;
+	}
 
-		// if this is the one we want, we're done
-		if( pcb->state != Unused && pcb->pid == pid ) {
 #if TRACING_PCB
-			__cio_printf( ", slot #%d\n", i );
+	if( pcb != NULL ) {
+		__cio_printf( ", at %08x\n", (uint32_t) pcb );
+	} else {
+		__cio_puts( ", not found\n" );
+	}
 #endif
-			return pcb;
-		}
+	return pcb;
+}
+
+/**
+** Name:	_pcb_first
+**
+** Start walking through every PCB in use (in no particular order)
+**
+** @return the first PCB, or NULL if there are none
+*/
+pcb_t *_pcb_first( void )
+{
+	return _pcb_scan( 0 );
+}
 
+/**
+** Name:	_pcb_next
+**
+** Continue walking through every PCB in use
+**
+** @param pcb  The PCB the walk is at
+**
+** @return the PCB after it, or NULL if there are no more
+*/
+pcb_t *_pcb_next( pcb_t *pcb )
+{
+	if( pcb->hnext != NULL ) {
+		return pcb->hnext;
 	}
 
-#if TRACING_PCB
-	__cio_puts( ", not found\n" );
-#endif
-	return NULL;
+	return _pcb_scan( PID_HASH(pcb->pid) + 1 );
+}
+
+/**
+** Name:	_pcb_joiner
+**
+** Find the thread which is joining a thread, if any
+**
+** @param thread  The thread
+**
+** @return the PCB of the thread joining it, or NULL
+*/
+pcb_t *_pcb_joiner( pcb_t *thread )
+{
+	process_t *proc = thread->proc;
+
+	// the first thread isn't on the list of threads
+	pcb_t *curr = _pcb_leader( proc );
+
+	if( curr == NULL || curr->state != Joining ||
+			VM_ARG(curr,1) != thread->pid ) {
+		for( curr = IQ_FIRST(&proc->threads); curr != NULL;
+				curr = IQ_NEXT(&proc->threads,curr) ) {
+			if( curr->state == Joining && VM_ARG(curr,1) == thread->pid ) {
+				break;
+			}
+		}
+	}
+
+	return curr;
 }
 
 /**
@@ -229,9 +532,12 @@ void _pcb_cleanup( pcb_t *pcb )
 		return;
 	}
 
-	// release the stack(en?)
-	if( pcb->stack != NULL ) {
-		_stk_dealloc( pcb->stack );
+	// a thread's stack goes now; the rest of the process goes with
+	// its last thread (see _pcb_dealloc())
+	process_t *proc = pcb->proc;
+	if( proc != NULL && proc->refs > 1 ) {
+		_vm_slot_free( proc->pgdir, pcb->slot );
+		proc->slots &= ~(1U << pcb->slot);
 	}
 
 	// release the PCB
@@ -259,64 +565,64 @@ void _pcb_zombify( pcb_t *victim )
 				(uint32_t) victim, victim->pid, victim->ppid );
 #endif
 
-	// set its state
+	// set its state, and let the scheduler forget about it
 	victim->state = Zombie;
+	_sch_forget( victim );
 
-	/*
-	** We need to locate the parent of this process.  We also need
-	** to reparent any children of this process.  We do these in
-	** a single loop.
-	*/
-	pcb_t *parent = NULL;
-	pcb_t *zombie = NULL;
-
-	// two PIDs we will look for
-	pid_t vicpid = victim->pid;
-	pid_t vicparent = victim->ppid;
-
-	// speed up access to the process table entries
-	register pcb_t *curr = _processes;
+	// a thread only has to be joined
+	if( IS_THREAD(victim) ) {
+		_pcb_zombify_thread( victim );
+		return;
+	}
 
-	for( int i = 0; i < N_PROCS; ++i, ++curr ) {
+	process_t *proc = victim->proc;
 
-		// make sure this is a valid entry
-		if( curr->state == Unused ) {
-			continue;
-		}
+	// the process' other threads go with it
+	pcb_t *curr = IQ_FIRST( &proc->threads );
+	while( curr != NULL ) {
+		pcb_t *next = IQ_NEXT( &proc->threads, curr );
+		_pcb_kill_thread( curr );
+		curr = next;
+	}
 
-		// see if this is our parent; if it isn't, see if
-		// it's a child of the terminating process
-		if( curr->pid == vicparent ) {
+	// every process must have a parent, even if it's 'init'
+	pcb_t *parent = _pcb_find( victim->ppid );
+	assert( parent != NULL );
 
-			// found the parent; make sure we hadn't already found it!
-			assert( parent == NULL );
-			parent = curr;
+	// the PID its parent may be waiting for
+	pid_t vicpid = victim->pid;
 
-			// NOTE: we don't break out of the 'for' loop here because
-			// we want to continue iterating to find all the children
-			// of this process.
+	/*
+	** Its children (if it has any) are reparented to init.
+	*/
+	pcb_t *zombie = NULL;
 
-		} else if( curr->ppid == vicpid ) {
+	while( _iq_remove(&proc->children,(void **) &curr) == S_OK ) {
 
-			// found a child - reparent it
-			curr->ppid = PID_INIT;
+		curr->ppid = PID_INIT;
+		assert( _iq_insert(&_init_pcb->proc->children,curr) == S_OK );
 
-			// see if this child is already undead
-			if( curr->state == Zombie ) {
-				// if it's already a zombie, remember it, so we
-				// can pass it on to 'init'; also, if there are
-				// two or more zombie children, it doesn't matter
-				// which one we pick here, as the others will be
-				// collected as 'init' loops
-				zombie = &(_processes[i]);
+		// only its first thread is on the list, but its other
+		// threads share its parent
+		if( curr->proc != NULL ) {
+			iqueue_t *threads = &curr->proc->threads;
+			for( pcb_t *thr = IQ_FIRST(threads); thr != NULL;
+					thr = IQ_NEXT(threads,thr) ) {
+				thr->ppid = PID_INIT;
 			}
+		}
 
+		// see if this child is already undead
+		if( curr->state == Zombie ) {
+			// if it's already a zombie, remember it, so we
+			// can pass it on to 'init'; also, if there are
+			// two or more zombie children, it doesn't matter
+			// which one we pick here, as the others will be
+			// collected as 'init' loops
+			zombie = curr;
 		}
 	}
 
-	// every process must have a parent, even if it's 'init'
-	assert( parent != NULL );
-
 	/*
 	** If we found a child that was already terminated, we need to
 	** wake up the init process if it's already waiting.
@@ -344,21 +650,18 @@ void _pcb_zombify( pcb_t *victim )
 		// *****************************************************
 
 		// intrinsic return value is the PID
-		RET(_init_pcb) = zombie->pid;
+		VM_RET(_init_pcb) = zombie->pid;
 
 		// may also want to return the exit status
-		int32_t *ptr = (int32_t *) ARG(_init_pcb,2);
-
-		if( ptr != NULL ) {
-			// *****************************************************
-			// Potential VM issue here!  This code assigns the exit
-			// status into a variable in the parent's address space.
-			// This works in the baseline because we aren't using
-			// any type of memory protection.  If address space
-			// separation is implemented, this code will very likely
-			// STOP WORKING, and will need to be fixed.
-			// *****************************************************
-			*ptr = zombie->exit_status;
+		uint32_t ptr = VM_ARG(_init_pcb,2);
+
+		if( ptr != 0 ) {
+			// the status variable is in init's address space
+			int32_t *status = _vm_access( _init_pcb->proc->pgdir, ptr,
+					true );
+			if( status != NULL ) {
+				*status = zombie->exit_status;
+			}
 		}
 #if TRACING_EXIT
 		__cio_printf( "** zombify zombie %d given to init\n", zombie->pid );
@@ -384,7 +687,7 @@ void _pcb_zombify( pcb_t *victim )
 
 		// verify that the parent is either waiting for this process
 		// or is waiting for any of its children
-		uint32_t target = ARG(parent,1);
+		uint32_t target = VM_ARG(parent,1);
 
 		if( target == 0 || target == vicpid ) {
 
@@ -392,28 +695,23 @@ void _pcb_zombify( pcb_t *victim )
 			// for any of its children, so we can wake it up.
 
 			// intrinsic return value is the PID
-			RET(parent) = vicpid;
+			VM_RET(parent) = vicpid;
 
 			// may also want to return the exit status
-			int32_t *ptr = (int32_t *) ARG(parent,2);
-
-			if( ptr != NULL ) {
-				/*
-				********************************************************
-				** Potential VM issue here!  This code assigns the exit
-				** status into a variable in the parent's address space.
-				** This works in the baseline because we aren't using
-				** any type of memory protection.  If address space
-				** separation is implemented, this code will very likely
-				** STOP WORKING, and will need to be fixed.
-				********************************************************
-				*/
-				*ptr = victim->exit_status;
+			uint32_t ptr = VM_ARG(parent,2);
+
+			if( ptr != 0 ) {
+				// the status variable is in the parent's address space
+				int32_t *status = _vm_access( parent->proc->pgdir, ptr,
+						true );
+				if( status != NULL ) {
+					*status = victim->exit_status;
+				}
 			}
 
 #if TRACING_EXIT
 			__cio_printf( "** zombify victim %u given to parent %u\n",
-						vicpid, vicparent );
+						vicpid, victim->ppid );
 #endif
 
 			// all done - schedule the parent, and clean up the zombie
@@ -454,7 +752,7 @@ void _pcb_zombify( pcb_t *victim )
 fd_t _pcb_get_next_fd(pcb_t *pcb)
 {
 	for(int i = 0; i < VFS_MAX_OPEN_FILES; i++) {
-		if(pcb->open_files[i] == NULL) {
+		if(pcb->proc->open_files[i] == NULL) {
 			return i;
 		}
 	}
@@ -491,21 +789,15 @@ void _pcb_dump( const char *msg, register pcb_t *p ) {
 	}
 
 	// now, the contents
-	__cio_printf( " pids %d/%d state %d prio %d",
-				  p->pid, p->ppid, p->state, p->priority );
+	__cio_printf( " pids %d/%d state %d prio %d lvl %d",
+				  p->pid, p->ppid, p->state, p->priority, p->level );
 
-	__cio_printf( "\n ticks %d xit %d wake %08x",
-				  p->ticks_left, p->exit_status, p->wakeup );
+	__cio_printf( "\n ticks %d xit %d wake %08x vrt %u",
+				  p->ticks_left, p->exit_status, p->timer.tick.expires,
+				  p->vruntime );
 
-	__cio_printf( "\n context %08x stack %08x",
-				  (uint32_t) p->context, (uint32_t) p->stack );
-
-	// and the filler (just to be sure)
-	__cio_puts( " fill: " );
-	for( int i = 0; i < sizeof(p->filler); ++i ) {
-		__cio_printf( "%02x", p->filler[i] );
-	}
-	__cio_putchar( '\n' );
+	__cio_printf( "\n context %08x proc %08x slot %d\n",
+				  (uint32_t) p->context, (uint32_t) p->proc, p->slot );
 }
 
 /**
@@ -558,12 +850,14 @@ void _ctx_dump_all( const char *msg ) {
 	}
 
 	int n = 0;
-	register pcb_t *pcb = _processes;
-	for( int i = 0; i < N_PROCS; ++i, ++pcb ) {
-		if( pcb->state != Unused ) {
-			++n;
-			__cio_printf( "%2d(%d): ", n, pcb->pid );
-			_ctx_dump( NULL, pcb->context );
+	for( pcb_t *pcb = _pcb_first(); pcb != NULL; pcb = _pcb_next(pcb) ) {
+		++n;
+		__cio_printf( "%2d(%d): ", n, pcb->pid );
+		// the context is in the process' own address space
+		context_t ctx;
+		if( _vm_copyin(pcb->proc->pgdir,(uint32_t) pcb->context,
+				&ctx,sizeof(ctx)) == S_OK ) {
+			_ctx_dump( NULL, &ctx );
 		}
 	}
 }
@@ -584,39 +878,29 @@ void _ptable_dump( const char *msg, bool_t all ) {
 	__cio_putchar( ' ' );
 
 	int used = 0;
-	int empty = 0;
-
-	register pcb_t *pcb = _processes;
-	for( int i = 0; i < N_PROCS; ++i ) {
-		if( pcb->state == Unused ) {
 
-			// an empty slot
-			++empty;
+	for( pcb_t *pcb = _pcb_first(); pcb != NULL; pcb = _pcb_next(pcb) ) {
 
-		} else {
-
-			// a non-empty slot
-			++used;
+		++used;
 
-			// if not dumping everything, add commas if needed
-			if( !all && used ) {
-				__cio_putchar( ',' );
-			}
+		// if not dumping everything, add commas if needed
+		if( !all && used > 1 ) {
+			__cio_putchar( ',' );
+		}
 
-			// things that are always printed
-			__cio_printf( " #%d: %d/%d", i, pcb->pid, pcb->ppid );
-			if( pcb->state >= N_STATES ) {
-				__cio_printf( " UNKNOWN" );
-			} else {
-				__cio_printf( " %s", _state_str[pcb->state][ST_S_NAME] );
-			}
-			// do we want more info?
-			if( all ) {
-				__cio_printf( " wk %08x stk %08x ESP %08x EIP %08x\n",
-						pcb->wakeup, (uint32_t) pcb->stack,
-						pcb->context->esp,
-						pcb->context->eip );
-			}
+		// things that are always printed
+		__cio_printf( " %d/%d", pcb->pid, pcb->ppid );
+		if( pcb->state >= N_STATES ) {
+			__cio_printf( " UNKNOWN" );
+		} else {
+			__cio_printf( " %s", _state_str[pcb->state][ST_S_NAME] );
+		}
+		// do we want more info?
+		if( all ) {
+			__cio_printf( " wk %08x pd %08x ESP %08x EIP %08x\n",
+					pcb->timer.tick.expires, (uint32_t) pcb->proc->pgdir,
+					VM_REG(pcb,esp),
+					VM_REG(pcb,eip) );
 		}
 	}
 	// only need this if we're doing one-line output
@@ -624,9 +908,9 @@ void _ptable_dump( const char *msg, bool_t all ) {
 		__cio_putchar( '\n' );
 	}
 
-	// sanity check - make sure we saw the correct number of table slots
-	if( (used + empty) != N_PROCS ) {
-		__cio_printf( "Table size %d, used %d + empty %d = %d???\n",
-					  N_PROCS, used, empty, used + empty );
+	// sanity check - make sure we saw every PCB in use
+	if( used != _pcb_count ) {
+		__cio_printf( "PCBs in use %d, but %d in the PID table???\n",
+					  _pcb_count, used );
 	}
 }
@@ -13,6 +13,10 @@
 #include "common.h"
 #include "vfs/vfs.h"
 #include "util/slab_cache.h"
+#include "util/queues.h"
+#include "kern/timer.h"
+#include "kern/hrtimer.h"
+#include "mem/vm.h"
 
 /*
 ** General (C and/or assembly) definitions
@@ -43,7 +47,7 @@ enum state_e {
 	// ordinary states
 	Unused = 0, New,
 	// "active" states
-	Ready, Running, Sleeping, Blocked, Waiting,
+	Ready, Running, Sleeping, Blocked, Waiting, Joining,
 	// "dead" states
 	Killed, Zombie,
 	// sentinel - value equals the number of states
@@ -93,15 +97,36 @@ typedef struct context_s {
 
 typedef struct pcb_s pcb_t;
 
+// the scheduler's real-time state for a process (see sched.c)
+struct rt_s;
+
 #include "mem/stacks.h"
 
+/*
+** process-wide state, shared by all the threads of a process
+**
+** each thread has a PCB of its own; the first one's PID is the PID
+** of the process, and the others are its "threads"
+*/
+
+typedef struct process_s {
+	pde_t *pgdir;			// page directory of the process' address space
+	dirent_t *cwd;          // current working directory of the process
+	kfile_t **open_files;   // open file table (max open files is defined in params.h)
+	uint32_t refs;			// number of PCBs sharing this
+	uint32_t slots;			// stack slots in use (one bit per slot)
+	iqueue_t children;		// its child processes, living or Zombie
+	iqueue_t threads;		// its threads, other than the first
+	pid_t pid;				// PID of the process (of its first thread)
+} process_t;
+
 /*
 ** the process control block
 **
 ** fields are ordered by size to avoid padding
 **
-** ideally, its size should divide evenly into 1024 bytes;
-** currently, 32 bytes
+** PCBs come from a slab cache, so there is no limit on their number
+** other than memory; currently, each one is 104 bytes
 */
 
 struct pcb_s {
@@ -110,17 +135,27 @@ struct pcb_s {
 
 	// start with these eight bytes, for easy access in assembly
 	context_t *context;		// pointer to context save area on stack
-	stack_t *stack;			// pointer to process stack
+	process_t *proc;		// the process this is a thread of
 
 	status_t exit_status;	// termination status, for parent's use
-	time_t wakeup;			// wakeup time, for sleeping processes
+	uint32_t vruntime;		// virtual runtime, for the fair-share class
 
-	dirent_t *cwd;          // current working directory of the process
-	kfile_t **open_files;   // open file table (max open files is defined in params.h)
+	qlink_t qlink;			// links for the ready or SIO queue
+	qlink_t plink;			// links in the parent's list of children
+							// (for a thread, its process' list of threads)
+	pcb_t *hnext;			// next PCB in the same PID hash chain
+	struct rt_s *rt;		// real-time state, if it has a reservation
+
+	// wakeup timer, for sleeping processes:  sleep() uses the tick
+	// timer, usleep() the high-resolution one
+	union {
+		ktimer_t tick;
+		hrtimer_t hr;
+	} timer;
 
 	// two-byte fields
 	//
-	pid_t pid;				// PID of this process
+	pid_t pid;				// PID of this process (or thread)
 	pid_t ppid;				// PID of our parent process
 
 	// one-byte fields
@@ -128,21 +163,28 @@ struct pcb_s {
 	state_t state;			// process state
 	uint8_t ticks_left;		// ticks remaining in the current time slice
 	prio_t priority;		// process priority
-
-	// filler, to round us up to 32 bytes
-	// adjust this as fields are added/removed/changed
-	uint8_t filler[1];
+	uint8_t level;			// scheduling level (see sched.h)
+	uint8_t slot;			// stack slot (see vm.h)
 
 };
 
+// is this PCB one of the extra threads of a process?
+#define	IS_THREAD(pcb)	((pcb)->proc != NULL && (pcb)->pid != (pcb)->proc->pid)
+
 #define	SZ_PCB	sizeof(pcb_t)
 
+// where the queue links are, for the iqueues that hold PCBs
+#define	PCB_QLINK	IQ_OFFSET(pcb_t,qlink)
+
+// where the links are for the lists of children and of threads
+#define	PCB_PLINK	IQ_OFFSET(pcb_t,plink)
+
 /*
 ** Globals
 */
 
-// the process table
-extern pcb_t _processes[N_PROCS];
+// the number of PCBs in use
+extern uint32_t _pcb_count;
 
 // next available PID
 extern pid_t _next_pid;
@@ -150,6 +192,9 @@ extern pid_t _next_pid;
 // pointer to the PCB for the 'init' process
 extern pcb_t *_init_pcb;
 
+// pointer to the PCB for the idle process
+extern pcb_t *_idle_pcb;
+
 /*
 ** Prototypes
 */
@@ -169,9 +214,12 @@ void _pcb_init( void );
 **
 ** Allocates a PCB structure
 **
+** @param proc  The process the PCB is to be a thread of, or NULL if
+**              it is to be the first thread of a new process
+**
 ** @return A pointer to a "clean" PCB, or NULL
 */
-pcb_t *_pcb_alloc( void );
+pcb_t *_pcb_alloc( process_t *proc );
 
 /**
 ** Name:	_pcb_dealloc
@@ -182,6 +230,26 @@ pcb_t *_pcb_alloc( void );
 */
 void _pcb_dealloc( pcb_t *pcb );
 
+/**
+** Name:	_pcb_new_pid
+**
+** Choose a PID for a new process or thread
+**
+** @return a PID which no PCB is using
+*/
+pid_t _pcb_new_pid( void );
+
+/**
+** Name:	_pcb_enroll
+**
+** Enter a PCB whose PID and PPID have been set into the PID table,
+** and into its parent's list of children (or, for a thread, into its
+** process' list of threads)
+**
+** @param pcb  The PCB
+*/
+void _pcb_enroll( pcb_t *pcb );
+
 /**
 ** Name:	_pcb_find
 **
@@ -193,6 +261,37 @@ void _pcb_dealloc( pcb_t *pcb );
 */
 pcb_t *_pcb_find( pid_t pid );
 
+/**
+** Name:	_pcb_first
+**
+** Start walking through every PCB in use (in no particular order)
+**
+** @return the first PCB, or NULL if there are none
+*/
+pcb_t *_pcb_first( void );
+
+/**
+** Name:	_pcb_next
+**
+** Continue walking through every PCB in use
+**
+** @param pcb  The PCB the walk is at
+**
+** @return the PCB after it, or NULL if there are no more
+*/
+pcb_t *_pcb_next( pcb_t *pcb );
+
+/**
+** Name:	_pcb_joiner
+**
+** Find the thread which is joining a thread, if any
+**
+** @param thread  The thread
+**
+** @return the PCB of the thread joining it, or NULL
+*/
+pcb_t *_pcb_joiner( pcb_t *thread );
+
 /**
 ** Name:	_pcb_cleanup
 **
@@ -12,25 +12,115 @@
 
 #include "kernel.h"
 #include "sched.h"
+#include "clock.h"
+#include "mem/kmalloc.h"
+#include "util/slab_cache.h"
 
 /*
 ** PRIVATE DEFINITIONS
 */
 
+// bit n of _ready_map is set when _ready[n] is non-empty
+// (or, for LVL_FAIR, when the fair-share heap is)
+#define	LVL_BIT(n)		(1U << (n))
+
+// is a UserPrio process in the MLFQ user band?
+#define	IN_USER_BAND(p)	((p)->level >= LVL_USER_TOP && \
+						 (p)->level <= LVL_USER_BOT)
+
+// the level new UserPrio processes start at
+#ifdef SCHED_FAIR
+#define	LVL_USER_NEW	LVL_FAIR
+#else
+#define	LVL_USER_NEW	LVL_USER_TOP
+#endif
+
+// does process a come before process b in virtual runtime?
+// (compared this way so that wraparound doesn't matter)
+#define	VR_BEFORE(a,b)	((int32_t) ((a)->vruntime - (b)->vruntime) < 0)
+
+// a fair-share process that has been blocked starts no more than
+// one quantum's worth of virtual runtime behind the others; one
+// that far ahead of the next process in line is preempted
+#define	VR_SLICE		(Q_STD * VR_TICK)
+
+// the real-time state of a process (NULL if it has no reservation)
+#define	RT(p)			((p)->rt)
+
 /*
 ** PRIVATE DATA TYPES
 */
 
+// real-time parameters and state (all times are in ticks)
+typedef struct rt_s {
+	uint32_t period;		// length of each period
+	uint32_t runtime;		// budget for each period
+	uint32_t deadline;		// deadline, relative to the start of a period
+	uint32_t util;			// runtime / deadline, in thousandths
+	time_t due;				// absolute deadline in the current period
+	uint32_t budget;		// what's left of the budget in this period
+	uint32_t misses;		// deadlines missed
+	bool_t done;			// finished its work for this period?
+	bool_t parked;			// waiting for the next period?
+	ktimer_t release;		// starts the next period
+} rt_t;
+
 /*
 ** PRIVATE GLOBAL VARIABLES
 */
 
+// which ready queues have something in them
+static uint32_t _ready_map;
+
+// the quantum (in ticks) for each level
+static const uint8_t _quantum[N_LEVELS] = {
+	[ LVL_RT ]           = Q_STD,
+	[ LVL_SYS ]          = Q_STD,
+	[ LVL_USER_TOP ]     = Q_STD,
+	[ LVL_USER_TOP + 1 ] = 2 * Q_STD,
+	[ LVL_USER_TOP + 2 ] = 4 * Q_STD,
+	[ LVL_USER_TOP + 3 ] = 8 * Q_STD,
+	[ LVL_USER_BOT ]     = 16 * Q_STD,
+	[ LVL_FAIR ]         = Q_STD,
+	[ LVL_DEFERRED ]     = Q_STD
+};
+
+// virtual runtime charged per tick in the fair-share class:
+// VR_TICK * 1024 / weight, with weights of 3121, 1024 and 335
+// (in effect, "nice" values of -5, 0 and +5)
+static const uint32_t _vr_tick[N_PRIOS] = {
+	[ SysPrio ]      = 336,
+	[ UserPrio ]     = VR_TICK,
+	[ DeferredPrio ] = 3130
+};
+
+// the fair-share class:  a min-heap of its ready processes, ordered
+// by virtual runtime, and the smallest virtual runtime seen lately;
+// the heap grows (see _sch_reserve()) as the number of processes does
+static pcb_t **_fair;
+static uint32_t _fair_size;
+static uint32_t _fair_count;
+static uint32_t _fair_min;
+
+// the real-time class:  store for the state of the processes in it,
+// and the share of the CPU they have reserved in all
+static slab_cache_t _rt_states;
+static uint32_t _rt_util;
+
+// when the next boost of UserPrio processes is due
+static time_t _next_boost;
+
+// idle time accounting:  when the idle process was last dispatched,
+// and how long it ran in all before that
+static time_t _idle_since;
+static uint32_t _idle_total;
+
 /*
 ** PUBLIC GLOBAL VARIABLES
 */
 
-// the ready queue
-queue_t _ready[N_PRIOS];
+// the ready queues, one per level
+iqueue_t _ready[N_LEVELS];
 
 // the currently-executing process
 pcb_t *_current;
@@ -39,6 +129,186 @@ pcb_t *_current;
 ** PRIVATE FUNCTIONS
 */
 
+/**
+** Name:	_fair_push(pcb)
+**
+** Add a process to the fair-share heap
+**
+** @param pcb   The process
+*/
+static void _fair_push( pcb_t *pcb )
+{
+	uint32_t i = _fair_count++;
+
+	assert1( i < _fair_size );
+
+	// sift up
+	while( i > 0 ) {
+		uint32_t parent = (i - 1) / 2;
+		if( !VR_BEFORE(pcb,_fair[parent]) ) {
+			break;
+		}
+		_fair[i] = _fair[parent];
+		i = parent;
+	}
+	_fair[i] = pcb;
+}
+
+/**
+** Name:	_fair_pop()
+**
+** Remove the process with the smallest virtual runtime from the
+** fair-share heap, which must not be empty
+**
+** @return the process
+*/
+static pcb_t *_fair_pop( void )
+{
+	pcb_t *top = _fair[0];
+	pcb_t *last = _fair[--_fair_count];
+	uint32_t i = 0;
+
+	// sift the last entry down from the root
+	for( ;; ) {
+		uint32_t child = 2 * i + 1;
+		if( child >= _fair_count ) {
+			break;
+		}
+		if( child + 1 < _fair_count &&
+				VR_BEFORE(_fair[child + 1],_fair[child]) ) {
+			++child;
+		}
+		if( !VR_BEFORE(_fair[child],last) ) {
+			break;
+		}
+		_fair[i] = _fair[child];
+		i = child;
+	}
+	_fair[i] = last;
+
+	return top;
+}
+
+/**
+** Name:	_rt_earlier(p1,p2)
+**
+** Compare the current deadlines of two real-time processes
+**
+** @param p1   first PCB
+** @param p2   second PCB
+**
+** @return < 0, 0 or > 0 as p1's deadline is earlier than, the same
+**   as or later than p2's
+*/
+static int _rt_earlier( void *p1, void *p2 )
+{
+	return (int32_t) (RT((pcb_t *) p1)->due - RT((pcb_t *) p2)->due);
+}
+
+/**
+** Name:	_rt_release(timer,arg)
+**
+** Timer callback which starts a new period for a real-time process
+**
+** @param timer   The process' release timer
+** @param arg     The process' PCB
+*/
+static void _rt_release( ktimer_t *timer, void *arg )
+{
+	pcb_t *pcb = (pcb_t *) arg;
+	rt_t *rt = RT(pcb);
+
+	// work still unfinished from the last period is late
+	if( !rt->done ) {
+		rt->misses += 1;
+	}
+
+	_timer_arm( timer, timer->expires + rt->period );
+	rt->due = _system_time + rt->deadline;
+	rt->budget = rt->runtime;
+	rt->done = false;
+
+	if( rt->parked ) {
+
+		// it was waiting for this period to start
+		rt->parked = false;
+		assert( _schedule(pcb) == S_OK );
+
+	} else if( pcb->state == Ready ) {
+
+		// its deadline has changed; requeue it
+		assert( _iq_remove_ptr(&_ready[LVL_RT],pcb) == S_OK );
+		assert( _iq_insert(&_ready[LVL_RT],pcb) == S_OK );
+	}
+}
+
+/**
+** Name:	_sch_band(pcb)
+**
+** Make sure a process' level lies in the band for its priority;
+** if it doesn't, move it to the top of that band.  Processes in the
+** fair-share class stay there.
+**
+** @param pcb   The process
+*/
+static void _sch_band( pcb_t *pcb )
+{
+	if( pcb->level == LVL_FAIR ) {
+		return;
+	}
+
+	// only processes with a reservation are real-time (for example,
+	// a child doesn't inherit its parent's)
+	if( pcb->level == LVL_RT ) {
+		if( RT(pcb) != NULL ) {
+			return;
+		}
+		pcb->level = LVL_SYS;
+	}
+
+	switch( pcb->priority ) {
+	case SysPrio:
+		pcb->level = LVL_SYS;
+		break;
+	case UserPrio:
+		if( !IN_USER_BAND(pcb) ) {
+			pcb->level = LVL_USER_NEW;
+			pcb->vruntime = _fair_min;
+		}
+		break;
+	case DeferredPrio:
+		pcb->level = LVL_DEFERRED;
+		break;
+	default:
+		// check the priority for validity
+		assert( pcb->priority < N_PRIOS );
+	}
+}
+
+/**
+** Name:	_sch_boost()
+**
+** Move every ready UserPrio process (and the current one, if it is
+** a UserPrio process) to the top level of the user band.
+*/
+static void _sch_boost( void )
+{
+	pcb_t *pcb;
+
+	for( int n = LVL_USER_TOP + 1; n <= LVL_USER_BOT; ++n ) {
+		while( _iq_remove(&_ready[n],(void **)&pcb) == S_OK ) {
+			pcb->level = LVL_USER_TOP;
+			assert( _iq_insert(&_ready[LVL_USER_TOP],pcb) == S_OK );
+			_ready_map |= LVL_BIT(LVL_USER_TOP);
+		}
+		_ready_map &= ~LVL_BIT(n);
+	}
+
+	if( IN_USER_BAND(_current) ) {
+		_current->level = LVL_USER_TOP;
+	}
+}
+
 /*
 ** PUBLIC FUNCTIONS
 */
@@ -50,10 +320,21 @@ pcb_t *_current;
 */
 void _sch_init( void )
 {
-	// create all the ready queues as FIFO queues
-	for( int i = 0; i < N_PRIOS; ++i ) {
-		_que_create( &_ready[i], NULL );
+	// create all the ready queues as FIFO queues, except that
+	// real-time processes are kept in deadline order
+	for( int i = 0; i < N_LEVELS; ++i ) {
+		_iq_create( &_ready[i], i == LVL_RT ? _rt_earlier : NULL,
+				PCB_QLINK );
 	}
+	_ready_map = 0;
+	_fair_count = 0;
+	_fair_min = 0;
+	_rt_util = 0;
+
+	slab_init( &_rt_states, sizeof(rt_t), 0 );
+	slab_register( &_rt_states, "rt" );
+
+	_next_boost = _system_time + SCH_BOOST_TICKS;
 
 	// there is no current process (yet)
 	_current = NULL;
@@ -73,50 +354,108 @@ void _sch_init( void )
 status_t _schedule( pcb_t *pcb )
 {
 	// sanity check?
-	assert1( pcb != NULL );
+	assert1( pcb != NULL && pcb != _idle_pcb );
+
+	// if the clock was stopped while the CPU idled, get it going
+	// again; this process will want its time slices
+	_clk_resume();
 
 	// if this process has been killed, zombify it
 	if( pcb->state == Killed ) {
 		_pcb_zombify( pcb );
 		return S_OK;
 	}
-	
-	// get the scheduling priority for this process
-	prio_t n = pcb->priority;
 
-	// check the priority for validity?
-	assert( n >= SysPrio && n < N_PRIOS );
+	// find the scheduling level for this process
+	_sch_band( pcb );
+	uint8_t n = pcb->level;
+
+	if( n == LVL_FAIR ) {
+
+		// a process that hasn't been running doesn't get to
+		// bank the virtual runtime it missed
+		if( pcb->state != Running &&
+				(int32_t) (pcb->vruntime - (_fair_min - VR_SLICE)) < 0 ) {
+			pcb->vruntime = _fair_min - VR_SLICE;
+		}
+
+		pcb->state = Ready;
+		_fair_push( pcb );
+		_ready_map |= LVL_BIT(n);
+		return S_OK;
+	}
+
+	if( n == LVL_RT && (RT(pcb)->done || RT(pcb)->budget == 0) ) {
+
+		// it has had its turn in this period; it will be
+		// scheduled again when the next one starts
+		pcb->state = Blocked;
+		RT(pcb)->parked = true;
+		return S_OK;
+	}
 
 	// mark the process as ready to execute
 	pcb->state = Ready;
 
 	// add the process to the relevant queue
-	return _que_insert( &_ready[n], pcb );
+	status_t status = _iq_insert( &_ready[n], pcb );
+	if( status == S_OK ) {
+		_ready_map |= LVL_BIT(n);
+	}
+
+	return status;
 }
 
 /**
 ** Name:	_dispatch()
 **
-** Select the next process to run from the ready queue.
+** Select the next process to run from the ready queue, or the
+** idle process if there is none.
 */
 void _dispatch( void )
 {
 	pcb_t *pcb = NULL;
 
+	// if the CPU was idle, it isn't any more
+	if( _current == _idle_pcb ) {
+		_idle_total += _system_time - _idle_since;
+		_idle_pcb->state = Ready;
+	}
+
 	do {
 
-		// find an available process to dispatch
-		int n = SysPrio;
-		while( n < N_PRIOS && QUE_IS_EMPTY(&_ready[n]) ) {
-			++n;
+		// if nothing is ready, halt the CPU until something is
+		if( _ready_map == 0 ) {
+			_current = _idle_pcb;
+			_current->state = Running;
+			_idle_since = _system_time;
+			_vm_switch( _current->proc->pgdir );
+			return;
 		}
 
-		// if we don't have one, we are in deep trouble!
-		assert( n < N_PRIOS );
+		// the lowest set bit is the highest non-empty level
+		int n = __builtin_ctz( _ready_map );
 
-		// found one; pull it off the queue, but blow up
-		// if that fails
-		assert( _que_remove(&_ready[n],(void **)&pcb) == S_OK );
+		if( n == LVL_FAIR ) {
+
+			// the fair-share process that has had the least time
+			pcb = _fair_pop();
+			if( _fair_count == 0 ) {
+				_ready_map &= ~LVL_BIT(n);
+			}
+			if( (int32_t) (pcb->vruntime - _fair_min) > 0 ) {
+				_fair_min = pcb->vruntime;
+			}
+
+		} else {
+
+			// pull the first process off that queue, but blow up
+			// if that fails
+			assert( _iq_remove(&_ready[n],(void **)&pcb) == S_OK );
+			if( QUE_IS_EMPTY(&_ready[n]) ) {
+				_ready_map &= ~LVL_BIT(n);
+			}
+		}
 
 		// if this process has been killed, zombify it
 		if( pcb->state == Killed ) {
@@ -128,10 +467,366 @@ void _dispatch( void )
 
 	} while( pcb == NULL );
 
-	// found one - make it the current process
+	// found one - make it the current process, in its address space
 	_current = pcb;
+	_vm_switch( _current->proc->pgdir );
 
-	// now a running process with the standard quantum
+	// now a running process; a process that was preempted keeps
+	// what was left of its quantum, otherwise it gets a new one
 	_current->state = Running;
-	_current->ticks_left = Q_STD;
+	if( _current->ticks_left < 1 ) {
+		_current->ticks_left = _quantum[_current->level];
+	}
+}
+
+/**
+** Name:	_sch_setprio(pcb,prio)
+**
+** Change a process' priority, moving it to the top of the
+** corresponding band of levels.  The process must not be on a
+** ready queue.
+**
+** @param pcb    The process
+** @param prio   Its new priority
+*/
+void _sch_setprio( pcb_t *pcb, prio_t prio )
+{
+	pcb->priority = prio;
+	if( pcb->level != LVL_FAIR && pcb->level != LVL_RT ) {
+		pcb->level = LVL_SYS;
+	}
+	_sch_band( pcb );
+}
+
+/**
+** Name:	_sch_setpolicy(pcb,policy)
+**
+** Change a process' scheduling policy.  The process must not be on
+** a ready queue.
+**
+** @param pcb      The process
+** @param policy   Its new policy
+*/
+void _sch_setpolicy( pcb_t *pcb, int32_t policy )
+{
+	// leaving the real-time class gives up the reservation
+	if( pcb->level == LVL_RT && policy != PolicyRT ) {
+		(void) _sch_setrt( pcb, 0, 0, 0 );
+	}
+
+	if( policy == PolicyFair ) {
+		if( pcb->level != LVL_FAIR ) {
+			pcb->level = LVL_FAIR;
+			pcb->vruntime = _fair_min;
+		}
+	} else if( pcb->level == LVL_FAIR ) {
+		pcb->level = LVL_USER_TOP;
+		_sch_band( pcb );
+	}
+}
+
+/**
+** Name:	_sch_getpolicy(pcb)
+**
+** @param pcb   The process
+**
+** @return the process' scheduling policy
+*/
+int32_t _sch_getpolicy( pcb_t *pcb )
+{
+	switch( pcb->level ) {
+	case LVL_RT:	return PolicyRT;
+	case LVL_FAIR:	return PolicyFair;
+	default:		return PolicyMLFQ;
+	}
+}
+
+/**
+** Name:	_sch_setrt(pcb,period,runtime,deadline)
+**
+** Put a process in the real-time class, or change its parameters.
+** Its first period starts now.  A period of 0 takes it out of the
+** class (back to PolicyMLFQ).  The process must not be on a ready
+** queue.
+**
+** @param pcb        The process
+** @param period     The length of each period, in ticks
+** @param runtime    How many ticks it may run in each period
+** @param deadline   When in each period its work must be done
+**
+** @return S_OK, S_BAD_PARAM if the parameters are inconsistent,
+**   S_BAD_ACTION if admitting it would overcommit the class, or
+**   S_NOMEM if there is no memory for its real-time state
+*/
+status_t _sch_setrt( pcb_t *pcb, uint32_t period, uint32_t runtime,
+		uint32_t deadline )
+{
+	if( period == 0 ) {
+		_sch_forget( pcb );
+		if( pcb->level == LVL_RT ) {
+			pcb->level = LVL_SYS;
+			_sch_band( pcb );
+		}
+		return S_OK;
+	}
+
+	if( runtime == 0 || runtime > deadline || deadline > period ) {
+		return S_BAD_PARAM;
+	}
+
+	// admission control:  the class as a whole must leave some of
+	// the CPU for everyone else (rounding each share up).  A share
+	// is runtime / deadline rather than runtime / period:  with
+	// deadlines shorter than periods, work due at the same time can
+	// fit in the period but not before the deadline, and EDF only
+	// promises to meet deadlines when these shares sum to at most 1.
+	rt_t *rt = RT(pcb);
+	uint32_t util = (runtime * 1000 + deadline - 1) / deadline;
+	uint32_t had = rt != NULL ? rt->util : 0;
+	if( _rt_util - had + util > RT_UTIL_MAX ) {
+		return S_BAD_ACTION;
+	}
+
+	if( rt == NULL ) {
+		rt = slab_alloc( &_rt_states, SC_ALLOC_ZERO_MEM );
+		if( rt == NULL ) {
+			return S_NOMEM;
+		}
+		_timer_setup( &rt->release, _rt_release, pcb );
+		pcb->rt = rt;
+	}
+	_rt_util = _rt_util - had + util;
+
+	rt->period = period;
+	rt->runtime = runtime;
+	rt->deadline = deadline;
+	rt->util = util;
+
+	// start the first period
+	rt->due = _system_time + deadline;
+	rt->budget = runtime;
+	rt->done = false;
+	rt->parked = false;
+	_timer_arm( &rt->release, _system_time + period );
+
+	pcb->level = LVL_RT;
+
+	return S_OK;
+}
+
+/**
+** Name:	_sch_rtmisses(pcb)
+**
+** @param pcb   The process
+**
+** @return how many deadlines a real-time process has missed
+*/
+uint32_t _sch_rtmisses( pcb_t *pcb )
+{
+	return( RT(pcb) != NULL ? RT(pcb)->misses : 0 );
+}
+
+/**
+** Name:	_sch_forget(pcb)
+**
+** Release anything the scheduler holds for a process which is
+** exiting (e.g., its real-time reservation)
+**
+** @param pcb   The process
+*/
+void _sch_forget( pcb_t *pcb )
+{
+	rt_t *rt = RT(pcb);
+
+	if( rt != NULL ) {
+		(void) _timer_cancel( &rt->release );
+		_rt_util -= rt->util;
+		slab_free( &_rt_states, rt );
+		pcb->rt = NULL;
+	}
+}
+
+/**
+** Name:	_sch_reserve(count)
+**
+** Make sure the scheduler has room for count processes at once
+**
+** @param count   The number of processes
+**
+** @return S_OK, or S_NOMEM if memory ran out
+*/
+status_t _sch_reserve( uint32_t count )
+{
+	if( count <= _fair_size ) {
+		return S_OK;
+	}
+
+	// grow the fair-share heap by doubling it
+	uint32_t size = _fair_size > 0 ? _fair_size : N_PROCS;
+	while( size < count ) {
+		size *= 2;
+	}
+
+	pcb_t **fair = kmalloc( size * sizeof(pcb_t *), 0 );
+	if( fair == NULL ) {
+		return S_NOMEM;
+	}
+
+	if( _fair != NULL ) {
+		__memcpy( fair, _fair, _fair_count * sizeof(pcb_t *) );
+		kfree( _fair );
+	}
+	_fair = fair;
+	_fair_size = size;
+
+	return S_OK;
+}
+
+/**
+** Name:	_sch_yield(pcb)
+**
+** Note that a process is giving up the CPU voluntarily; a fair-share
+** process is moved behind the next one in line.
+**
+** @param pcb   The process
+*/
+void _sch_yield( pcb_t *pcb )
+{
+	if( pcb->level == LVL_RT ) {
+		rt_t *rt = RT(pcb);
+		if( (int32_t) (_system_time - rt->due) > 0 ) {
+			rt->misses += 1;
+		}
+		rt->done = true;
+	}
+
+	if( pcb->level == LVL_FAIR && _fair_count > 0 &&
+			!VR_BEFORE(_fair[0],pcb) ) {
+		pcb->vruntime = _fair[0]->vruntime + 1;
+	}
+	pcb->ticks_left = 0;
+}
+
+/**
+** Name:	_sch_blocked(pcb)
+**
+** Note that a process is about to block for I/O or sleep; this
+** moves it up a level and gives it a fresh quantum.
+**
+** @param pcb   The process
+*/
+void _sch_blocked( pcb_t *pcb )
+{
+	if( IN_USER_BAND(pcb) && pcb->level > LVL_USER_TOP ) {
+		pcb->level -= 1;
+	}
+	pcb->ticks_left = 0;
+}
+
+/**
+** Name:	_sch_idle()
+**
+** @return true if the current process is the idle process and
+**         nothing else is ready to run
+*/
+bool_t _sch_idle( void )
+{
+	return _current == _idle_pcb && _ready_map == 0;
+}
+
+/**
+** Name:	_sch_unidle()
+**
+** Called on the way out of every ISR.  If the CPU was idle and the
+** interrupt made a process ready, switch to it now, rather than at
+** the next clock tick.
+*/
+void _sch_unidle( void )
+{
+	if( _current == _idle_pcb && _ready_map != 0 ) {
+		_dispatch();
+	}
+}
+
+/**
+** Name:	_sch_idletime()
+**
+** @return the number of ticks the CPU has spent idle since boot
+*/
+uint32_t _sch_idletime( void )
+{
+	if( _current == _idle_pcb ) {
+		return _idle_total + (_system_time - _idle_since);
+	}
+	return _idle_total;
+}
+
+/**
+** Name:	_sch_tick()
+**
+** Charge the current clock tick to the current process.  Called
+** by the clock ISR; switches processes if the current one has used
+** up its quantum or a higher level has become ready.
+*/
+void _sch_tick( void )
+{
+	// periodically give everyone in the user band another chance
+	if( (int32_t) (_system_time - _next_boost) >= 0 ) {
+		_next_boost = _system_time + SCH_BOOST_TICKS;
+		_sch_boost();
+	}
+
+	// the idle process has no quantum; it runs until there is
+	// something else to do
+	if( _current == _idle_pcb ) {
+		_sch_unidle();
+		return;
+	}
+
+	// a real-time process runs until it uses up its budget, or
+	// one with an earlier deadline is ready
+	if( _current->level == LVL_RT ) {
+		pcb_t *first;
+		if( --RT(_current)->budget > 0 &&
+				(_iq_peek(&_ready[LVL_RT],(void **) &first) != S_OK ||
+				 _rt_earlier(first,_current) >= 0) ) {
+			return;
+		}
+		assert( _schedule(_current) == S_OK );
+		_dispatch();
+		return;
+	}
+
+	// decrement the current process' remaining quantum
+	_current->ticks_left -= 1;
+
+	// a fair-share process is also charged virtual runtime
+	bool_t behind = false;
+	if( _current->level == LVL_FAIR ) {
+		_current->vruntime += _vr_tick[_current->priority];
+		if( _fair_count > 0 ) {
+			behind = (int32_t) (_current->vruntime - _fair[0]->vruntime)
+					> VR_SLICE;
+		} else if( (int32_t) (_current->vruntime - _fair_min) > 0 ) {
+			_fair_min = _current->vruntime;
+		}
+	}
+
+	if( _current->ticks_left < 1 ) {
+
+		// it has expired; a UserPrio process drops a level
+		if( IN_USER_BAND(_current) && _current->level < LVL_USER_BOT ) {
+			_current->level += 1;
+		}
+
+	} else if( !behind &&
+			(_ready_map & (LVL_BIT(_current->level) - 1)) == 0 ) {
+
+		// nothing more important is waiting; carry on
+		return;
+	}
+
+	// put it back on its ready queue and pick a new current process
+	assert( _schedule(_current) == S_OK );
+	_dispatch();
 }
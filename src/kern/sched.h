@@ -18,6 +18,48 @@
 ** General (C and/or assembly) definitions
 */
 
+/*
+** Scheduling levels
+**
+** Level 0 is the highest, and holds the real-time class (see below).
+** SysPrio processes always run at LVL_SYS and DeferredPrio processes
+** at the last level; UserPrio processes
+** move between the levels in the user band:  down one level each time
+** they use up a quantum, and up one level each time they block for
+** I/O or sleep.  The quantum doubles at each level in the user band.
+**
+** Processes in the fair-share class (PolicyFair) run at LVL_FAIR,
+** whatever their priority; among themselves they are run in order of
+** virtual runtime, which advances more slowly the higher the priority.
+** They are kept in a heap rather than in _ready[LVL_FAIR].
+**
+** Processes in the real-time class (PolicyRT, entered through the
+** rtsched() system call) run at LVL_RT, earliest deadline first.
+** Each has a period, a budget of ticks it may run in each period,
+** and a deadline (relative to the start of each period) by which it
+** should finish its work; it marks the end of that work by yielding
+** (sleep(0)), and then waits for its next period.  A process which
+** uses up its budget also waits for its next period.
+*/
+#define	LVL_RT			0
+#define	LVL_SYS			1
+#define	LVL_USER_TOP	2
+#define	LVL_USER_BOT	6
+#define	LVL_FAIR		7
+#define	LVL_DEFERRED	8
+#define	N_LEVELS		9
+
+// virtual runtime charged per tick to a UserPrio fair-share process
+#define	VR_TICK			1024
+
+// the share of the CPU (in thousandths) the real-time class may claim,
+// counting each process' runtime against its deadline (see _sch_setrt())
+#define	RT_UTIL_MAX		900
+
+// how often every UserPrio process is boosted back to the top level,
+// so that CPU-bound processes can't be starved by interactive ones
+#define	SCH_BOOST_TICKS	SEC_TO_TICKS(1)
+
 #ifndef SP_ASM_SRC
 
 /*
@@ -32,8 +74,8 @@
 ** Globals
 */
 
-// the ready queue
-extern queue_t _ready[N_PRIOS];
+// the ready queues, one per level
+extern iqueue_t _ready[N_LEVELS];
 
 // the currently-executing process
 extern pcb_t *_current;
@@ -67,6 +109,142 @@ status_t _schedule( pcb_t *pcb );
 */
 void _dispatch( void );
 
+/**
+** Name:	_sch_setprio(pcb,prio)
+**
+** Change a process' priority, moving it to the top of the
+** corresponding band of levels.  The process must not be on a
+** ready queue.
+**
+** @param pcb    The process
+** @param prio   Its new priority
+*/
+void _sch_setprio( pcb_t *pcb, prio_t prio );
+
+/**
+** Name:	_sch_setpolicy(pcb,policy)
+**
+** Change a process' scheduling policy.  The process must not be on
+** a ready queue.
+**
+** @param pcb      The process
+** @param policy   Its new policy
+*/
+void _sch_setpolicy( pcb_t *pcb, int32_t policy );
+
+/**
+** Name:	_sch_getpolicy(pcb)
+**
+** @param pcb   The process
+**
+** @return the process' scheduling policy
+*/
+int32_t _sch_getpolicy( pcb_t *pcb );
+
+/**
+** Name:	_sch_setrt(pcb,period,runtime,deadline)
+**
+** Put a process in the real-time class, or change its parameters.
+** Its first period starts now.  A period of 0 takes it out of the
+** class (back to PolicyMLFQ).  The process must not be on a ready
+** queue.
+**
+** @param pcb        The process
+** @param period     The length of each period, in ticks
+** @param runtime    How many ticks it may run in each period
+** @param deadline   When in each period its work must be done
+**
+** @return S_OK, S_BAD_PARAM if the parameters are inconsistent,
+**   S_BAD_ACTION if admitting it would overcommit the class, or
+**   S_NOMEM if there is no memory for its real-time state
+*/
+status_t _sch_setrt( pcb_t *pcb, uint32_t period, uint32_t runtime,
+		uint32_t deadline );
+
+/**
+** Name:	_sch_rtmisses(pcb)
+**
+** @param pcb   The process
+**
+** @return how many deadlines a real-time process has missed
+*/
+uint32_t _sch_rtmisses( pcb_t *pcb );
+
+/**
+** Name:	_sch_forget(pcb)
+**
+** Release anything the scheduler holds for a process which is
+** exiting (e.g., its real-time reservation)
+**
+** @param pcb   The process
+*/
+void _sch_forget( pcb_t *pcb );
+
+/**
+** Name:	_sch_reserve(count)
+**
+** Make sure the scheduler has room for count processes at once
+**
+** @param count   The number of processes
+**
+** @return S_OK, or S_NOMEM if memory ran out
+*/
+status_t _sch_reserve( uint32_t count );
+
+/**
+** Name:	_sch_yield(pcb)
+**
+** Note that a process is giving up the CPU voluntarily; a fair-share
+** process is moved behind the next one in line, and a real-time one
+** has finished its work for this period.
+**
+** @param pcb   The process
+*/
+void _sch_yield( pcb_t *pcb );
+
+/**
+** Name:	_sch_blocked(pcb)
+**
+** Note that a process is about to block for I/O or sleep; this
+** moves it up a level and gives it a fresh quantum.
+**
+** @param pcb   The process
+*/
+void _sch_blocked( pcb_t *pcb );
+
+/**
+** Name:	_sch_idle()
+**
+** @return true if the current process is the idle process and
+**         nothing else is ready to run
+*/
+bool_t _sch_idle( void );
+
+/**
+** Name:	_sch_unidle()
+**
+** Called on the way out of every ISR.  If the CPU was idle and the
+** interrupt made a process ready, switch to it now, rather than at
+** the next clock tick.
+*/
+void _sch_unidle( void );
+
+/**
+** Name:	_sch_idletime()
+**
+** @return the number of ticks the CPU has spent idle since boot
+*/
+uint32_t _sch_idletime( void );
+
+/**
+** Name:	_sch_tick()
+**
+** Charge the current clock tick to the current process.  Called
+** by the clock ISR; switches processes if the current one has used
+** up its quantum or a higher level has become ready.
+*/
+void _sch_tick( void );
+
 #endif
 // !SP_ASM_SRC
 
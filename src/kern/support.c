@@ -244,6 +244,28 @@ void ( *__install_isr( int vector, void ( *handler )( int vector, int code ) ) )
     return old_handler;
 }
 
+/*
+** Name:    __install_task_gate
+*/
+void __install_task_gate( int vector, int selector ){
+    IDT_Gate *g = (IDT_Gate *)IDT_ADDRESS + vector;
+
+    g->offset_15_0 = 0;
+    g->segment_selector = selector;
+    g->flags = IDT_PRESENT | IDT_DPL_0 | IDT_TASK_GATE;
+    g->offset_31_16 = 0;
+}
+
+/*
+** Name:    __isr_stub
+*/
+unsigned int __isr_stub( int vector ){
+    IDT_Gate *g = (IDT_Gate *)IDT_ADDRESS + vector;
+
+    return (unsigned short) g->offset_15_0 |
+        (unsigned int) (unsigned short) g->offset_31_16 << 16;
+}
+
 /*
 ** Name:    __delay
 **
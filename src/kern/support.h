@@ -47,6 +47,27 @@ void __init_interrupts( void );
 */
 void ( *__install_isr( int vector, void ( *handler )( int vector, int code ) ) )( int vector, int code );
 
+/*
+** Name:    __install_task_gate
+**
+** Description: Make an interrupt vector switch to another task, rather
+**      than go through its isr stub.  The task's handler is then
+**      entirely responsible for the interrupt.
+** Arguments:   The interrupt vector number, and the GDT selector of the
+**      task's TSS
+*/
+void __install_task_gate( int vector, int selector );
+
+/*
+** Name:    __isr_stub
+**
+** Description: Find the isr stub an interrupt vector's IDT entry
+**      sends it to.
+** Arguments:   The interrupt vector number
+** Returns: The address of the stub (0 for a task gate)
+*/
+unsigned int __isr_stub( int vector );
+
 /*
 ** Name:    __delay
 **
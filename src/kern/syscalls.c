@@ -24,7 +24,10 @@
 #include "sched.h"
 #include "procs.h"
 #include "mem/stacks.h"
+#include "mem/kmalloc.h"
 #include "clock.h"
+#include "timer.h"
+#include "hrtimer.h"
 #include "io/cio.h"
 #include "io/sio.h"
 #include "io/vgatext.h"
@@ -111,6 +114,29 @@ SYSIMPL(exit)
 	_dispatch();
 }
 
+/**
+** _sys_wakeup - timer callback which ends a sleep() call
+**
+** @param timer   The sleeping process' wakeup timer
+** @param arg     The sleeping process' PCB
+*/
+static void _sys_wakeup( ktimer_t *timer, void *arg )
+{
+	assert( _schedule((pcb_t *) arg) == S_OK );
+}
+
+/**
+** _sys_hrwakeup - high-resolution timer callback which ends a
+** usleep() call
+**
+** @param timer   The sleeping process' wakeup timer
+** @param arg     The sleeping process' PCB
+*/
+static void _sys_hrwakeup( hrtimer_t *timer, void *arg )
+{
+	assert( _schedule((pcb_t *) arg) == S_OK );
+}
+
 /**
 ** _sys_sleep - put the current process to sleep for some length of time
 **
@@ -129,6 +155,7 @@ SYSIMPL(sleep)
 
 		// special case: yield the CPU
 		RET(_current) = E_SUCCESS;
+		_sch_yield( _current );
 		status = _schedule( _current );
 
 		// if _schedule() failed, we need to notify someone
@@ -143,26 +170,207 @@ SYSIMPL(sleep)
 
 	} else {
 
-		// calculate the wakeup time
-		_current->wakeup = _system_time + length;
+		// arm the wakeup timer
+		_timer_setup( &_current->timer.tick, _sys_wakeup, _current );
+		_timer_arm( &_current->timer.tick, _system_time + length );
+		_current->state = Sleeping;
+		_sch_blocked( _current );
 
-		// add to the sleep queue
-		status = _que_insert( &_sleeping, (void *) _current );
+	}
 
-		// if the insertion failed, notify someone
-		if( status != S_OK ) {
-			// oops!
-			__sprint( _b256, "PID %u sleep(%u) failed, code %d\n",
-					_current->pid, length, status );
-			WARNING( _b256 );
-			RET(_current) = E_FAILURE;
-			return;
+	// pick a new process to run for a while
+	_dispatch();
+}
+
+/**
+** _sys_spawnfd - create a new process running a different program
+**
+** implements:
+**		int32_t spawnfd( userfcn_t entry, int32_t prio, char *args[],
+**				uint32_t fds );
+**
+** returns:
+**		PID of the new child, or an error code
+**
+** Unlike fork() followed by exec(), the child starts out with a fresh
+** address space; nothing of the parent's stack is shared or copied.
+** The child inherits the parent's working directory, and the open
+** files whose descriptors are set in the 'fds' bitmask.
+*/
+SYSIMPL(spawnfd)
+{
+	uint32_t entry = ARG(_current,1);
+	int32_t prio = ARG(_current,2);
+	char **args = (char **) ARG(_current,3);
+	uint32_t fds = ARG(_current,4);
+
+	// -1 means "same as mine"
+	if( prio >= N_PRIOS || prio < -1 ) {
+		RET(_current) = E_BAD_PARAM;
+		return;
+	}
+
+	pcb_t *pcb = _pcb_alloc( NULL );
+	if( pcb == NULL ) {
+		RET(_current) = E_NO_PROCS;
+		return;
+	}
+	process_t *proc = pcb->proc;
+
+	// Lay out the child's stack in its own address space; the
+	// arguments are still in ours.  (Releasing the PCB releases
+	// the address space, too.)
+	proc->pgdir = _vm_create();
+	if( proc->pgdir == NULL ) {
+		_pcb_dealloc( pcb );
+		RET(_current) = E_NO_MEM;
+		return;
+	}
+
+	pcb->context = _stk_setup( proc->pgdir, VM_STACK_TOP, entry, args );
+	if( pcb->context == NULL ) {
+		_pcb_dealloc( pcb );
+		RET(_current) = E_NO_MEM;
+		return;
+	}
+	proc->slots = 1U << pcb->slot;
+
+	// Set the child's identity.
+	pcb->pid = proc->pid = _pcb_new_pid();
+	pcb->ppid = _current->proc->pid;
+	pcb->state = New;
+	_pcb_enroll( pcb );
+
+	// replicate things inherited from the parent
+	pcb->priority = _current->priority;
+	pcb->level = _current->level;
+	if( prio >= 0 ) {
+		_sch_setprio( pcb, prio );
+	}
+
+	proc->cwd = _current->proc->cwd;
+
+	for( fd_t fd = 0; fd < VFS_MAX_OPEN_FILES; ++fd ) {
+		kfile_t *file = _current->proc->open_files[fd];
+		if( (fds & (1U << fd)) != 0 && file != NULL ) {
+			file->kf_refs += 1;
+			proc->open_files[fd] = file;
 		}
+	}
+
+	// Schedule the child, and let the parent continue.
+	RET(_current) = pcb->pid;
+	_schedule( pcb );
+}
 
+/**
+** _sys_thrcreate - start a new thread in the current process
+**
+** implements:
+**		int32_t thrcreate( userfcn_t entry, char *args[] );
+**
+** returns:
+**		TID of the new thread, or an error code
+**
+** The thread shares everything with the rest of the process except
+** its stack, which is in a slot of its own in the process' address
+** space (see vm.h), and its scheduling state.
+*/
+SYSIMPL(thrcreate)
+{
+	uint32_t entry = ARG(_current,1);
+	char **args = (char **) ARG(_current,2);
+	process_t *proc = _current->proc;
+
+	// find a stack slot for it
+	uint8_t slot = 0;
+	while( slot < VM_SLOTS && (proc->slots & (1U << slot)) != 0 ) {
+		++slot;
 	}
 
-	// pick a new process to run for a while
-	_dispatch();
+	if( slot >= VM_SLOTS ) {
+		RET(_current) = E_NO_PROCS;
+		return;
+	}
+
+	pcb_t *pcb = _pcb_alloc( proc );
+	if( pcb == NULL ) {
+		RET(_current) = E_NO_PROCS;
+		return;
+	}
+
+	pcb->context = _stk_setup( proc->pgdir, VM_SLOT_TOP(slot), entry, args );
+	if( pcb->context == NULL ) {
+		_vm_slot_free( proc->pgdir, slot );
+		_pcb_dealloc( pcb );
+		RET(_current) = E_NO_MEM;
+		return;
+	}
+	pcb->slot = slot;
+	proc->slots |= 1U << slot;
+
+	// Its own TID, but the identity of the process.
+	pcb->pid = _pcb_new_pid();
+	pcb->ppid = _current->ppid;
+	pcb->state = New;
+	_pcb_enroll( pcb );
+
+	pcb->priority = _current->priority;
+	pcb->level = _current->level;
+
+	// Schedule the thread, and let this one continue.
+	RET(_current) = pcb->pid;
+	_schedule( pcb );
+}
+
+/**
+** _sys_thrjoin - wait for a thread of the current process to exit
+**
+** implements:
+**		int32_t thrjoin( pid_t tid, int32_t *status );
+**
+** returns:
+**		TID of the thread, or an error code (intrinsic)
+**		exit status of the thread via a non-NULL 'status' parameter
+*/
+SYSIMPL(thrjoin)
+{
+	pid_t tid = ARG(_current,1);
+
+	// must be one of our (other) threads, and nobody else may
+	// be joining it already
+	pcb_t *thread = _pcb_find( tid );
+	if( thread == NULL || thread == _current || !IS_THREAD(thread) ||
+			thread->proc != _current->proc ) {
+		RET(_current) = E_BAD_PARAM;
+		return;
+	}
+
+	if( _pcb_joiner(thread) != NULL ) {
+		RET(_current) = E_BAD_PARAM;
+		return;
+	}
+
+	// if it's still running, we wait for it (see _pcb_zombify())
+	if( thread->state != Zombie ) {
+		_current->state = Joining;
+		_dispatch();
+		return;
+	}
+
+	// it's done; collect its information and clean it up (unless
+	// the status can't be written, in which case it stays joinable)
+	uint32_t stat = ARG(_current,2);
+
+	if( stat != 0 && _vm_copyout(_current->proc->pgdir,stat,
+			&thread->exit_status,sizeof(thread->exit_status)) != S_OK ) {
+		RET(_current) = E_BAD_PARAM;
+		return;
+	}
+
+	RET(_current) = tid;
+
+	_pcb_cleanup( thread );
 }
 
 /**
@@ -246,9 +454,10 @@ SYSIMPL(read)
 
 		// mark it as blocked
 		_current->state = Blocked;
+		_sch_blocked( _current );
 
 		// put it on the SIO input queue
-		assert1( _que_insert(&_sio_readq,(void *)_current) == S_OK );
+		assert1( _iq_insert(&_sio_readq,(void *)_current) == S_OK );
 
 		// select a new current process
 		_dispatch();
@@ -324,6 +533,14 @@ SYSIMPL(waitpid)
 	** find one.
 	*/
 
+	// children belong to the process, not to its threads, which
+	// could otherwise collect each other's children; so this is
+	// only for a process with a single thread
+	if( _current->proc->refs > 1 ) {
+		RET(_current) = E_NOT_SUPPORTED;
+		SYSCALL_EXIT( E_NOT_SUPPORTED );
+	}
+
 	// verify that we aren't looking for ourselves!
 	pid_t target = ARG(_current,1);
 
@@ -344,7 +561,7 @@ SYSIMPL(waitpid)
 		if( child != NULL ) {
 
 			// found the process; is it one of our children:
-			if( child->ppid != _current->pid ) {
+			if( child->ppid != _current->pid || IS_THREAD(child) ) {
 				// NO, so we can't wait for it
 				RET(_current) = E_BAD_PARAM;
 				SYSCALL_EXIT( E_BAD_PARAM );
@@ -367,39 +584,20 @@ SYSIMPL(waitpid)
 	} else {
 
 		// looking for any child
-		int i;
-
-		// we need to find a process that is our child
-		// and has already exited
-
-		child = NULL;
-		bool_t found = false;
-
-		// save a bit of time
-		register pcb_t *curr = _processes;
-
-		for( i = 0; i < N_PROCS; ++i, ++curr ) {
-
-			if( curr != NULL && curr->ppid == _current->pid ) {
-
-				// found one!
-				found = true;
-
-				// has it already exited?
-				if( child->state == Zombie ) {
-					// yes, so we're done here
-					child = curr;
-					break;
-				}
-			}
-		}
+		iqueue_t *kids = &_current->proc->children;
 
-		if( !found ) {
-			// got through the loop without finding a child!
+		if( QUE_IS_EMPTY(kids) ) {
+			// we don't have any!
 			RET(_current) = E_NO_CHILDREN;
 			SYSCALL_EXIT( E_NO_CHILDREN );
 		}
 
+		// we need to find one that has already exited
+		child = IQ_FIRST( kids );
+		while( child != NULL && child->state != Zombie ) {
+			child = IQ_NEXT( kids, child );
+		}
+
 	}
 
 	/*
@@ -426,14 +624,19 @@ SYSIMPL(waitpid)
 	}
 
 	// found a Zombie; collect its information and clean it up
-	RET(_current) = child->pid;
-	int32_t *stat = (int32_t *) ARG(_current,2);
+	uint32_t stat = ARG(_current,2);
 
-	// if stat is NULL, the parent doesn't want the status
-	if( stat != NULL ) {
-		*stat = child->exit_status;
+	// if stat is NULL, the parent doesn't want the status; if the
+	// page it's on can't be written (e.g., there's no memory for a
+	// copy of a shared one), leave the child to be collected later
+	if( stat != 0 && _vm_copyout(_current->proc->pgdir,stat,
+			&child->exit_status,sizeof(child->exit_status)) != S_OK ) {
+		RET(_current) = E_BAD_PARAM;
+		SYSCALL_EXIT( E_BAD_PARAM );
 	}
 
+	RET(_current) = child->pid;
+
 	// clean up the child
 	_pcb_cleanup( child );
 
@@ -461,10 +664,15 @@ SYSIMPL(getdata)
 	} else {
 		// valid code, so return the requested info
 		switch( what ) {
-		case Pid:	RET(_current) = _current->pid; break;
+		case Pid:	RET(_current) = _current->proc->pid; break;
 		case PPid:	RET(_current) = _current->ppid; break;
 		case Prio:	RET(_current) = _current->priority; break;
 		case Time:	RET(_current) = _system_time; break;
+		case Policy:	RET(_current) = _sch_getpolicy( _current ); break;
+		case Misses:	RET(_current) = _sch_rtmisses( _current ); break;
+		case Idle:	RET(_current) = _sch_idletime(); break;
+		case Nanos:	RET(_current) = (uint32_t) _clk_ns(); break;
+		case Tid:	RET(_current) = _current->pid; break;
 		default:
 			// this is strange - the code is valid, but we
 			// don't recognize it; probably means we haven't
@@ -497,12 +705,26 @@ SYSIMPL(setdata)
 		// bad code
 		RET(_current) = E_BAD_PARAM;
 	} else {
-		// at the moment, the only one we allow is Prio
-		if( what == Prio ) {
+		// at the moment, the only ones we allow are Prio and Policy
+		if( what == Policy ) {
+			// entering the real-time class requires rtsched()
+			if( data < PolicyMLFQ || data >= N_POLICIES ||
+					(data == PolicyRT && _current->level != LVL_RT) ) {
+				RET(_current) = E_BAD_PARAM;
+				return;
+			}
+			RET(_current) = _sch_getpolicy( _current );
+			_sch_setpolicy( _current, data );
+		} else if( what == Prio ) {
+			// must be a real priority
+			if( data < SysPrio || data >= N_PRIOS ) {
+				RET(_current) = E_BAD_PARAM;
+				return;
+			}
 			// return the old value
 			RET(_current) = _current->priority;
 			// update the priority
-			_current->priority = data;
+			_sch_setprio( _current, data );
 		} else {
 			// this maybe a valid datum, but we're not allowing
 			// it at the moment
@@ -529,7 +751,7 @@ SYSIMPL(kill)
 	uint32_t pid = ARG(_current,1);
 
 	// must be a valid "ordinary user"PID, and can't be the current process
-	// QUESTION: what if it's the idle process?
+	// (this also protects the idle process, whose PID is PID_IDLE)
 	if( pid < FIRST_USER_PID || pid == _current->pid ) {
 		RET(_current) = E_FAILURE;
 		return;
@@ -579,7 +801,7 @@ SYSIMPL(fork)
 #endif
 
 	// Make sure there's room for another process!
-	pcb_t *pcb = _pcb_alloc();
+	pcb_t *pcb = _pcb_alloc( NULL );
 	if( pcb == NULL ) {
 		RET(_current) = E_NO_PROCS;
 #if TRACING_SYSRET
@@ -588,9 +810,10 @@ SYSIMPL(fork)
 		return;
 	}
 
-	// Create the stack for the child.
-	pcb->stack = _stk_alloc();
-	if( pcb->stack == NULL ) {
+	// Give the child a copy of the parent's address space; they
+	// share the stack pages until one of them writes to one.
+	pcb->proc->pgdir = _vm_fork( _current->proc->pgdir );
+	if( pcb->proc->pgdir == NULL ) {
 		_pcb_dealloc( pcb );
 		RET(_current) = E_NO_PROCS;
 #if TRACING_SYSRET
@@ -599,55 +822,55 @@ SYSIMPL(fork)
 		return;
 	}
 
-	// Duplicate the parent's stack.
-	__memcpy( (void *)pcb->stack, (void *)_current->stack, sizeof(stack_t) );
+	// Only the forking thread's stack goes with the child; the other
+	// threads' stack pages go back to being the parent's alone.
+	for( uint32_t slot = 0; slot < VM_SLOTS; ++slot ) {
+		if( slot != _current->slot ) {
+			_vm_slot_free( pcb->proc->pgdir, slot );
+		}
+	}
 
-	// Set the child's identity.
-	pcb->pid = _next_pid++;
-	pcb->ppid = _current->pid;
+	// The child's return value goes into its copy of the parent's
+	// context, which is on a page they now share; the child needs
+	// a page of its own for that, and there may not be one.
+	uint32_t *child_ret = _vm_access( pcb->proc->pgdir,
+			(uint32_t) &RET(_current), true );
+	if( child_ret == NULL ) {
+		_pcb_dealloc( pcb );
+		RET(_current) = E_NO_MEM;
+#if TRACING_SYSRET
+		__cio_printf( "<-- %08x\n", E_NO_MEM );
+#endif
+		return;
+	}
+
+	// Set the child's identity.  If a thread forked, the child's
+	// only thread is a copy of it, in the same stack slot.
+	pcb->pid = pcb->proc->pid = _pcb_new_pid();
+	pcb->ppid = _current->proc->pid;
 	pcb->state = New;
+	pcb->slot = _current->slot;
+	pcb->proc->slots = 1U << pcb->slot;
+	_pcb_enroll( pcb );
 
 	// replicate things inherited from the parent
 	pcb->priority = _current->priority;
+	pcb->level = _current->level;
 
-	pcb->cwd = _current->cwd;
+	pcb->proc->cwd = _current->proc->cwd;
 
 	/*
-	** Next, we need to update the ESP and EBP values in the child's
-	** stack.  The problem is that because we duplicated the parent's
-	** stack, these pointers are still pointing back into that stack,
-	** which will cause problems as the two processes continue to execute.
-	**
-	** Note: if there are other pointers to things in the parent's stack
-	** (e.g., pointers to local variables), we do NOT locate and update
-	** them, as that's impractical. As a result, user code that relies on
-	** such pointers may behave strangely after a fork().
+	** The child's stack is at the same address as the parent's, so
+	** its context is where the parent's is, and its saved ESP and
+	** EBP, its frame pointer chain, and any other pointers into its
+	** stack are already correct.
 	*/
 
-	// Figure out the byte offset from one stack to the other.
-	int32_t offset = (void *) pcb->stack - (void *) _current->stack;
-
-	// Add this to the child's context pointer.
-	pcb->context = (context_t *) (((void *)_current->context) + offset);
-
-	// Fix the child's ESP and EBP values IFF they're non-zero.
-	if( REG(pcb,ebp) != 0 ) {
-		REG(pcb,ebp) += offset;
-	}
-	if( REG(pcb,esp) != 0 ) {
-		REG(pcb,esp) += offset;
-	}
-
-	// Follow the EBP chain through the child's stack.
-	uint32_t *bp = (uint32_t *) REG(pcb,ebp);
-	while( bp && *bp ) {
-		*bp += offset;
-		bp = (uint32_t *) *bp;
-	}
+	pcb->context = _current->context;
 
 	// Set the return values for the two processes.
 	RET(_current) = pcb->pid;
-	RET(pcb) = 0;
+	*child_ret = 0;
 	// _ctx_dump( "fork: new", pcb->context );
 	// __delay(400);
 
@@ -679,16 +902,38 @@ SYSIMPL(exec)
 	__cio_printf( "--> _sys_execp, pid %d\n", _current->pid );
 #endif
 
-	// Set up the new stack for the user.
-	context_t *ctx = _stk_setup( _current->stack, entry, args );
-	assert( ctx != NULL );
+	// The other threads would be left with nothing to run.
+	if( _current->proc->refs > 1 ) {
+		RET(_current) = E_NOT_SUPPORTED;
+		return;
+	}
+
+	// Set up a new address space, with the new stack for the user;
+	// the arguments are still in the old one.
+	pde_t *pgdir = _vm_create();
+	if( pgdir == NULL ) {
+		RET(_current) = E_NO_MEM;
+		return;
+	}
+
+	context_t *ctx = _stk_setup( pgdir, VM_STACK_TOP, entry, args );
+	if( ctx == NULL ) {
+		_vm_free( pgdir );
+		RET(_current) = E_NO_MEM;
+		return;
+	}
+
+	// Out with the old, in with the new.
+	pde_t *old = _current->proc->pgdir;
+	_current->proc->pgdir = pgdir;
+	_current->slot = 0;
+	_current->proc->slots = 1U << 0;
+	_vm_switch( pgdir );
+	_vm_free( old );
 
 	// Copy the context pointer into the current PCB.
 	_current->context = ctx;
 
-	// It's also the current ESP for the process.
-	_current->context->esp = (uint32_t) ctx;
-
 	/*
 	** Decision:
 	**	(A) schedule this process and dispatch another,
@@ -893,7 +1138,7 @@ SYSIMPL(ciogetspecialdown)
 ** Check for common file descriptor invalidities
 */
 #define IS_BAD_FD(fd) \
-	((fd) < 0 || (fd) >= VFS_MAX_OPEN_FILES || _current->open_files[(fd)] == NULL)
+	((fd) < 0 || (fd) >= VFS_MAX_OPEN_FILES || _current->proc->open_files[(fd)] == NULL)
 
 /**
  * @brief Translate a kernel-internal status to a syscall error code.
@@ -993,6 +1238,7 @@ SYSIMPL(fopen)
 	file->kf_inode = target;
 	file->kf_ops = target->i_file_ops;
 	file->kf_mode = mode;
+	file->kf_refs = 1;
 
 	// Actually call into the driver that provides the target inode
 	// being opened
@@ -1017,7 +1263,7 @@ SYSIMPL(fopen)
 
 	// Store a pointer to the file in the current pcb's open
 	// file table
-	_current->open_files[fd] = file;
+	_current->proc->open_files[fd] = file;
 
 	RET(_current) = fd;
 }
@@ -1040,38 +1286,10 @@ SYSIMPL(fclose)
 		return;
 	}
 
-	// TODO(Adin): Reference counting
-
-	// Grab the file, and if the backing driver supports it, call
-	// the close operation: allowing the driver to perform any cleanup
-	// it likes
-	kfile_t *file = _current->open_files[fd];
-	if(file->kf_ops && file->kf_ops->close) {
-		// TODO(Adin): If this fails, how should it be reported to
-		// 			   userspace?
-		file->kf_ops->close(file);
-	}
-
-	// Free any read or write locks the file had on the inode
-	if(file->kf_inode->i_type != S_TYPE_DEV) {
-		if(file->kf_mode & O_READ) {
-			file->kf_inode->i_nr_readers--;
-		}
-
-		if(file->kf_mode & O_WRITE) {
-			file->kf_inode->i_has_writer = false;
-		}
-	}
-
-	// Useful debugging print: do not remove
-	// __cio_printf(
-	// 	"close fd %d: nr_writers: %d, has_writer %d\n",
-	// 	fd, file->kf_inode->i_nr_readers, file->kf_inode->i_has_writer
-	// );
-
-	// Free the resources associated with the open file
-	_current->open_files[fd] = NULL;
-	_vfs_free_file(file);
+	// Other processes may still have the file open (see spawnfd())
+	kfile_t *file = _current->proc->open_files[fd];
+	_current->proc->open_files[fd] = NULL;
+	_vfs_close_file(file);
 
 	RET(_current) = E_SUCCESS;
 }
@@ -1102,7 +1320,7 @@ SYSIMPL(fread)
 	}
 
 	// Grab the file and make sure it's open with read capabilities
-	kfile_t *target = _current->open_files[fd];
+	kfile_t *target = _current->proc->open_files[fd];
 	if(!(target->kf_mode & O_READ)) {
 		RET(_current) = 0;
 		if(status) {
@@ -1164,7 +1382,7 @@ SYSIMPL(fwrite)
 	}
 
 	// Grab the file and ensure it's opened for writing
-	kfile_t *target = _current->open_files[fd];
+	kfile_t *target = _current->proc->open_files[fd];
 	if(!(target->kf_mode & O_WRITE)) {
 		RET(_current) = 0;
 		if(status) {
@@ -1226,7 +1444,7 @@ SYSIMPL(flistdir)
 
 	// Grab the file and validate is is a directory whose backing driver supports
 	// iteration
-	kfile_t *target = _current->open_files[fd];
+	kfile_t *target = _current->proc->open_files[fd];
 
 	if(!target->kf_ops || !target->kf_ops->iterate_shared || target->kf_inode->i_type != S_TYPE_DIR) {
 		RET(_current) = 0;
@@ -1275,7 +1493,7 @@ SYSIMPL(fcreate)
 	uint32_t type  = ARG(_current, 2);
 	uint32_t flags = ARG(_current, 3);
 
-	char *split_path = _km_slice_alloc();
+	char *split_path = kmalloc(__strlen(path) + 1, KM_ZERO);
 	__memcpy(split_path, path, __strlen(path));
 
 	// Quick and dirty last index of for dirname/basename
@@ -1336,7 +1554,7 @@ SYSIMPL(fioctl)
 	}
 
 	// Ensure the backing driver supports fioctl action(s)
-	kfile_t *target = _current->open_files[fd];
+	kfile_t *target = _current->proc->open_files[fd];
 	if(!target->kf_ops || !target->kf_ops->ioctl) {
 		RET(_current) = E_NOT_SUPPORTED;
 		return;
@@ -1376,7 +1594,7 @@ SYSIMPL(fseek)
 
 	// Grab the file, ensure the required backing driver operation is supported
 	// and ensure the file sin't a device (which don't use offsets or r/w heads)
-	kfile_t *target = _current->open_files[fd];
+	kfile_t *target = _current->proc->open_files[fd];
 
 	if(target->kf_inode->i_type == S_TYPE_DEV ||
 	   !target->kf_ops ||
@@ -1480,7 +1698,7 @@ SYSIMPL(fchdir)
 		return;
 	}
 
-	_current->cwd = new_cwd;
+	_current->proc->cwd = new_cwd;
 	RET(_current) = E_SUCCESS;
 }
 
@@ -1507,12 +1725,69 @@ SYSIMPL(fgetcwd)
 
 	// Generate the path and place it in buffer
 	__memclr(buffer, buffer_len);
-	_vfs_dirent_to_pathname(_current->cwd, buffer);
+	_vfs_dirent_to_pathname(_current->proc->cwd, buffer);
 
 	RET(_current) = __strlen(buffer);
 }
 
 
+/**
+** _sys_rtsched - enter (or leave) the real-time scheduling class
+**
+** implements:
+**		int32_t rtsched( uint32_t period, uint32_t runtime,
+**				uint32_t deadline );
+**
+** returns:
+**		success, or why the request was refused
+*/
+SYSIMPL(rtsched)
+{
+	uint32_t period = ARG(_current,1);
+	uint32_t runtime = ARG(_current,2);
+	uint32_t deadline = ARG(_current,3);
+
+	switch( _sch_setrt(_current, MS_TO_TICKS(period),
+			MS_TO_TICKS(runtime), MS_TO_TICKS(deadline)) ) {
+	case S_OK:			RET(_current) = E_SUCCESS; break;
+	case S_BAD_PARAM:	RET(_current) = E_BAD_PARAM; break;
+	case S_NOMEM:		RET(_current) = E_NO_MEM; break;
+	default:			RET(_current) = E_FAILURE;
+	}
+}
+
+/**
+** _sys_usleep - put the current process to sleep for some number
+** of microseconds
+**
+** implements:
+**		int32_t usleep( uint32_t us );
+**
+** if us == 0, just yields the CPU
+*/
+SYSIMPL(usleep)
+{
+	uint32_t length = ARG(_current,1);
+
+	if( length == 0 ) {
+		// sleep(0) does exactly what we want
+		_sys_sleep();
+		return;
+	}
+
+	// arm the wakeup timer
+	hrtimer_t *timer = &_current->timer.hr;
+	_hrt_setup( timer, _sys_hrwakeup, _current );
+	_hrt_arm( timer, _clk_ns() + (uint64_t) length * 1000 );
+	_current->state = Sleeping;
+	_sch_blocked( _current );
+	RET(_current) = E_SUCCESS;
+
+	// pick a new process to run for a while
+	_dispatch();
+}
+
+
 // The system call jump table
 //
 // Initialized using designated initializers to ensure the entries
@@ -1559,6 +1834,11 @@ static void (* const _syscalls[N_SYSCALLS])( void ) = {
 
 	[ SYS_fchdir    ]			   = _sys_fchdir,
 	[ SYS_fgetcwd   ]			   = _sys_fgetcwd,
+	[ SYS_rtsched   ]			   = _sys_rtsched,
+	[ SYS_usleep    ]			   = _sys_usleep,
+	[ SYS_spawnfd   ]			   = _sys_spawnfd,
+	[ SYS_thrcreate ]			   = _sys_thrcreate,
+	[ SYS_thrjoin   ]			   = _sys_thrjoin,
 };
 
 /**
@@ -61,9 +61,15 @@
 #define SYS_fchdir                  34
 #define SYS_fgetcwd                 35
 
+#define SYS_rtsched                 36
+#define SYS_usleep                  37
+#define SYS_spawnfd                 38
+#define SYS_thrcreate               39
+#define SYS_thrjoin                 40
+
 
 // UPDATE THIS DEFINITION IF MORE SYSCALLS ARE ADDED!
-#define N_SYSCALLS      36
+#define N_SYSCALLS      41
 
 // dummy system call code for testing our ISR
 #define SYS_bogus       0xbad
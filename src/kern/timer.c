@@ -0,0 +1,279 @@
+/**
+** @file	timer.c
+**
+** @brief	Kernel timer implementation
+**
+** Pending timers live on a hierarchical timing wheel.  Level 0 has
+** one slot per tick for the next TW_SLOTS ticks; each slot of level N
+** covers TW_SLOTS times as many ticks as a slot of level N-1.  A timer
+** goes into the lowest level whose span reaches its expiration time.
+** Whenever level N-1 wraps around, the timers in the next slot of
+** level N are redistributed ("cascaded") into the lower levels, so
+** each timer is moved at most TW_LEVELS-1 times before it fires.
+**
+** Each slot is an intrusive queue, and each timer remembers which
+** slot it is in; arming and cancelling are O(1).
+*/
+
+#define SP_KERNEL_SRC
+
+#include "common.h"
+
+#include "timer.h"
+
+#include "clock.h"
+#include "kernel.h"
+#include "util/queues.h"
+
+/*
+** PRIVATE DEFINITIONS
+*/
+
+// where the wheel links are in a timer
+#define TIMER_QLINK		IQ_OFFSET(ktimer_t,link)
+
+/*
+** PRIVATE GLOBAL VARIABLES
+*/
+
+// the wheel itself
+static iqueue_t _tw_wheel[TW_LEVELS][TW_SLOTS];
+
+// timers which have come due and are about to be run
+static iqueue_t _tw_expired;
+
+// the next tick the wheel will process
+static time_t _tw_next;
+
+// number of pending timers
+static uint32_t _tw_count;
+
+/*
+** PRIVATE FUNCTIONS
+*/
+
+/**
+** Name:	_tw_place
+**
+** Put a timer into the wheel slot for its expiration time
+**
+** @param timer   The timer
+*/
+static void _tw_place( ktimer_t *timer ) {
+	time_t when = timer->expires;
+	uint32_t delta = when - _tw_next;
+
+	if( (int32_t) delta < 0 ) {
+		// already due; run it on the next tick we process
+		when = _tw_next;
+		delta = 0;
+	} else if( delta > TW_RANGE ) {
+		when = _tw_next + TW_RANGE;
+		delta = TW_RANGE;
+	}
+
+	// find the lowest level whose span reaches that far
+	int level = 0;
+	while( delta >= (1U << (TW_BITS * (level + 1))) ) {
+		++level;
+	}
+
+	timer->slot = &_tw_wheel[level][(when >> (TW_BITS * level)) & TW_MASK];
+	assert( _iq_insert(timer->slot,timer) == S_OK );
+}
+
+/**
+** Name:	_tw_cascade
+**
+** Redistribute the timers in one slot of an upper level
+**
+** @param slot   The slot
+*/
+static void _tw_cascade( iqueue_t *slot ) {
+	ktimer_t *timer;
+
+	while( _iq_remove(slot,(void **) &timer) == S_OK ) {
+		_tw_place( timer );
+	}
+}
+
+/*
+** PUBLIC FUNCTIONS
+*/
+
+/**
+** Name:	_timer_init
+**
+** Initializes the timer module
+*/
+void _timer_init( void ) {
+
+	for( int level = 0; level < TW_LEVELS; ++level ) {
+		for( int i = 0; i < TW_SLOTS; ++i ) {
+			_iq_create( &_tw_wheel[level][i], NULL, TIMER_QLINK );
+		}
+	}
+	_iq_create( &_tw_expired, NULL, TIMER_QLINK );
+
+	_tw_next = _system_time;
+	_tw_count = 0;
+}
+
+/**
+** Name:	_timer_setup
+**
+** Prepare a timer for use
+**
+** @param timer   The timer
+** @param func    The function to call when it expires
+** @param arg     The argument to pass to func
+*/
+void _timer_setup( ktimer_t *timer, ktimer_fn_t func, void *arg ) {
+	assert1( timer != NULL && func != NULL );
+
+	timer->link.prev = timer->link.next = NULL;
+	timer->expires = 0;
+	timer->func = func;
+	timer->arg = arg;
+	timer->slot = NULL;
+}
+
+/**
+** Name:	_timer_arm
+**
+** Arm a timer to fire at a given system time; a pending timer is
+** moved to the new time.  A time which has already passed fires on
+** the next tick.
+**
+** @param timer     The timer
+** @param expires   When it should fire
+*/
+void _timer_arm( ktimer_t *timer, time_t expires ) {
+	assert1( timer != NULL );
+
+	if( timer->slot != NULL ) {
+		assert( _iq_remove_ptr(timer->slot,timer) == S_OK );
+	} else {
+		++_tw_count;
+	}
+
+	timer->expires = expires;
+	_tw_place( timer );
+}
+
+/**
+** Name:	_timer_cancel
+**
+** Disarm a timer
+**
+** @param timer   The timer
+**
+** @return S_OK if it was pending, else S_NOTFOUND
+*/
+status_t _timer_cancel( ktimer_t *timer ) {
+	assert1( timer != NULL );
+
+	if( timer->slot == NULL ) {
+		return S_NOTFOUND;
+	}
+
+	assert( _iq_remove_ptr(timer->slot,timer) == S_OK );
+	timer->slot = NULL;
+	--_tw_count;
+
+	return S_OK;
+}
+
+/**
+** Name:	_timer_pending
+**
+** @param timer   The timer
+**
+** @return true if the timer is armed and has not yet fired
+*/
+bool_t _timer_pending( ktimer_t *timer ) {
+	return timer->slot != NULL;
+}
+
+/**
+** Name:	_timer_count
+**
+** @return the number of pending timers
+*/
+uint32_t _timer_count( void ) {
+	return _tw_count;
+}
+
+/**
+** Name:	_timer_next
+**
+** How long the wheel can go without being advanced.  This looks only
+** at level 0, and stops where level 0 next wraps around (when the
+** upper levels must be cascaded), so it may come up short of the
+** next expiration, but never beyond it.
+**
+** @param max   The most ticks the caller is interested in
+**
+** @return the number of ticks from now until the next tick at which
+**         _timer_tick() has work to do, or max if that is later
+*/
+uint32_t _timer_next( uint32_t max ) {
+	time_t when = _tw_next;
+
+	// anything already due makes the answer easy
+	if( (int32_t) (_system_time - when) >= 0 ) {
+		return 1;
+	}
+
+	while( when - _system_time < max ) {
+		uint32_t index = when & TW_MASK;
+		if( index == 0 || QUE_LENGTH(&_tw_wheel[0][index]) > 0 ) {
+			break;
+		}
+		++when;
+	}
+
+	return when - _system_time;
+}
+
+/**
+** Name:	_timer_tick
+**
+** Run every timer which has come due.  Called by the clock ISR after
+** it advances the system time.
+*/
+void _timer_tick( void ) {
+
+	while( (int32_t) (_system_time - _tw_next) >= 0 ) {
+
+		uint32_t index = _tw_next & TW_MASK;
+
+		// level 0 has wrapped; refill it from the level above,
+		// and that one from the level above it if it wrapped too
+		if( index == 0 ) {
+			uint32_t i;
+			int level = 1;
+			do {
+				i = (_tw_next >> (TW_BITS * level)) & TW_MASK;
+				_tw_cascade( &_tw_wheel[level][i] );
+				++level;
+			} while( i == 0 && level < TW_LEVELS );
+		}
+
+		++_tw_next;
+
+		// move the due timers aside first, so that anything the
+		// callbacks arm lands in a later slot rather than this one
+		ktimer_t *timer;
+		while( _iq_remove(&_tw_wheel[0][index],(void **) &timer) == S_OK ) {
+			timer->slot = &_tw_expired;
+			assert( _iq_insert(&_tw_expired,timer) == S_OK );
+		}
+
+		while( _iq_remove(&_tw_expired,(void **) &timer) == S_OK ) {
+			timer->slot = NULL;
+			--_tw_count;
+			timer->func( timer, timer->arg );
+		}
+	}
+}
@@ -0,0 +1,153 @@
+/**
+** @file	timer.h
+**
+** @brief	Kernel timer declarations
+**
+** Kernel timers call a function (in interrupt context) once the
+** system time reaches a given tick.  Pending timers are kept on a
+** hierarchical timing wheel, so arming and cancelling a timer take
+** constant time no matter how many are pending; the clock ISR
+** advances the wheel once per tick.
+*/
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include "common.h"
+
+#include "util/queues.h"
+
+/*
+** General (C and/or assembly) definitions
+*/
+
+// wheel geometry:  TW_LEVELS levels of TW_SLOTS slots each; each
+// level's slots span TW_SLOTS times as many ticks as the one below
+#define TW_BITS		6
+#define TW_SLOTS	(1 << TW_BITS)
+#define TW_MASK		(TW_SLOTS - 1)
+#define TW_LEVELS	5
+
+// the furthest into the future a timer can be armed; anything
+// later is treated as expiring at the end of this range
+#define TW_RANGE	((1U << (TW_BITS * TW_LEVELS)) - 1)
+
+#ifndef SP_ASM_SRC
+
+/*
+** Start of C-only definitions
+*/
+
+/*
+** Types
+*/
+
+typedef struct ktimer_s ktimer_t;
+
+// the function called when a timer expires; it may re-arm the timer
+typedef void (*ktimer_fn_t)( ktimer_t *timer, void *arg );
+
+/*
+** A kernel timer
+**
+** Usually embedded in whatever structure it belongs to.  Set it up
+** once with _timer_setup(); after that, it can be armed and cancelled
+** any number of times.
+*/
+struct ktimer_s {
+	qlink_t link;			// links in the wheel slot
+	time_t expires;			// system time at which it fires
+	ktimer_fn_t func;		// what to call then
+	void *arg;				// and what to pass to it
+	iqueue_t *slot;			// the slot holding it (NULL if not pending)
+};
+
+/*
+** Globals
+*/
+
+/*
+** Prototypes
+*/
+
+/**
+** Name:	_timer_init
+**
+** Initializes the timer module
+*/
+void _timer_init( void );
+
+/**
+** Name:	_timer_setup
+**
+** Prepare a timer for use
+**
+** @param timer   The timer
+** @param func    The function to call when it expires
+** @param arg     The argument to pass to func
+*/
+void _timer_setup( ktimer_t *timer, ktimer_fn_t func, void *arg );
+
+/**
+** Name:	_timer_arm
+**
+** Arm a timer to fire at a given system time; a pending timer is
+** moved to the new time.  A time which has already passed fires on
+** the next tick.
+**
+** @param timer     The timer
+** @param expires   When it should fire
+*/
+void _timer_arm( ktimer_t *timer, time_t expires );
+
+/**
+** Name:	_timer_cancel
+**
+** Disarm a timer
+**
+** @param timer   The timer
+**
+** @return S_OK if it was pending, else S_NOTFOUND
+*/
+status_t _timer_cancel( ktimer_t *timer );
+
+/**
+** Name:	_timer_pending
+**
+** @param timer   The timer
+**
+** @return true if the timer is armed and has not yet fired
+*/
+bool_t _timer_pending( ktimer_t *timer );
+
+/**
+** Name:	_timer_count
+**
+** @return the number of pending timers
+*/
+uint32_t _timer_count( void );
+
+/**
+** Name:	_timer_next
+**
+** How long the wheel can go without being advanced
+**
+** @param max   The most ticks the caller is interested in
+**
+** @return the number of ticks from now until the next tick at which
+**         _timer_tick() has work to do, or max if that is later
+*/
+uint32_t _timer_next( uint32_t max );
+
+/**
+** Name:	_timer_tick
+**
+** Run every timer which has come due.  Called by the clock ISR after
+** it advances the system time.
+*/
+void _timer_tick( void );
+
+#endif
+// !SP_ASM_SRC
+
+#endif
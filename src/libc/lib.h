@@ -323,6 +323,97 @@ unsigned int __get_flags( void );
 */
 void __pause( void );
 
+/**
+** Name:    __rdtsc
+**
+** Description: Read the processor's time-stamp counter
+**
+** @return The 64-bit TSC value
+*/
+unsigned long long __rdtsc( void );
+
+/**
+** Name:    __cpuid
+**
+** Description: Execute CPUID for one leaf (with a subleaf of 0)
+**
+** @param leaf  The leaf to query
+** @param regs  Where to put EAX, EBX, ECX and EDX, in that order
+*/
+void __cpuid( unsigned int leaf, unsigned int regs[4] );
+
+/**
+** Name:    __rdmsr
+**
+** Description: Read a model-specific register
+**
+** @param msr  The MSR to read
+**
+** @return The 64-bit MSR value
+*/
+unsigned long long __rdmsr( unsigned int msr );
+
+/**
+** Name:    __wrmsr
+**
+** Description: Write a model-specific register
+**
+** @param msr    The MSR to write
+** @param value  The 64-bit value to write to it
+*/
+void __wrmsr( unsigned int msr, unsigned long long value );
+
+/**
+** Name:    __get_cr0, __set_cr0, __get_cr4, __set_cr4
+**
+** Description: Read or write a processor control register
+**
+** @param value  (set only) The new register contents
+**
+** @return (get only) The register contents
+*/
+unsigned int __get_cr0( void );
+void __set_cr0( unsigned int value );
+unsigned int __get_cr4( void );
+void __set_cr4( unsigned int value );
+
+/**
+** Name:    __get_cr2
+**
+** Description: Get the address whose access caused the last page fault
+**
+** @return The contents of CR2
+*/
+unsigned int __get_cr2( void );
+
+/**
+** Name:    __set_cr3
+**
+** Description: Load the page directory base register; this also
+**              flushes all non-global TLB entries
+**
+** @param pgdir  Physical address of the new page directory
+*/
+void __set_cr3( unsigned int pgdir );
+
+/**
+** Name:    __invlpg
+**
+** Description: Flush the TLB entry for one page
+**
+** @param addr  An address within the page
+*/
+void __invlpg( unsigned int addr );
+
+/**
+** Name:    __ltr
+**
+** Description: Load the task register
+**
+** @param sel  GDT selector of the TSS for the running task
+*/
+void __ltr( unsigned int sel );
+
 /**
 ** __get_ra:
 **
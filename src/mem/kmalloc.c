@@ -0,0 +1,147 @@
+/**
+** @file	kmalloc.c
+**
+** @author	CSCI-452 class of 20235
+**
+** @brief	General-purpose kernel memory allocator implementation
+**
+** Small requests are rounded up to the next power of two and taken
+** from the slab cache for that size class.  Each slab records the
+** cache that owns it, so freeing an element just means finding its
+** slab header.  Requests larger than KMA_MAX_SMALL bytes get whole
+** pages; those are the only kmalloc() blocks which start on a page
+** boundary and are also the start of a page allocation (slab elements
+** always follow a slab header), which is how kfree() tells them apart.
+*/
+
+#define SP_KERNEL_SRC
+
+#include "common.h"
+
+#include "kern/kernel.h"
+#include "kmalloc.h"
+#include "util/slab_cache.h"
+
+/*
+** PRIVATE DEFINITIONS
+*/
+
+// log2 of the smallest size class
+
+#define LOG2_MIN_SMALL  3
+
+/*
+** PRIVATE GLOBAL VARIABLES
+*/
+
+// the size-class caches; _kma_caches[i] holds blocks of 8 << i bytes
+static slab_cache_t _kma_caches[KMA_N_CACHES];
+
+// their names in the slab cache registry
+static const char *_kma_names[KMA_N_CACHES] = {
+	"kmalloc-8", "kmalloc-16", "kmalloc-32", "kmalloc-64", "kmalloc-128",
+	"kmalloc-256", "kmalloc-512", "kmalloc-1024", "kmalloc-2048"
+};
+
+/*
+** PRIVATE FUNCTIONS
+*/
+
+/**
+** Name:    _kma_class
+**
+** Find the size class for a request
+**
+** @param size  Number of bytes requested (1 through KMA_MAX_SMALL)
+**
+** @return the index of the cache to use
+*/
+static int _kma_class( uint32_t size ) {
+	int index = 0;
+
+	while( (KMA_MIN_SMALL << index) < size ) {
+		++index;
+	}
+
+	return( index );
+}
+
+/*
+** PUBLIC FUNCTIONS
+*/
+
+/**
+** Name:    _kma_init
+**
+** Initialize the kmalloc size-class caches
+**
+** Dependencies:
+**    Must be called after _km_init()
+*/
+void _kma_init( void ) {
+
+	for( int i = 0; i < KMA_N_CACHES; ++i ) {
+		// these must all use page-based slabs so that kfree()
+		// can find the slab header through the page allocator
+		status_t stat = slab_init( &_kma_caches[i],
+				KMA_MIN_SMALL << i, SC_INIT_LARGE_SLABS );
+		assert( stat == E_SUCCESS );
+		slab_register( &_kma_caches[i], _kma_names[i] );
+	}
+
+	__cio_puts( " KMA" );
+}
+
+/**
+** Name:    kmalloc
+**
+** Allocate a block of memory of (at least) the specified size
+**
+** @param size   Number of bytes needed
+** @param flags  KM_* allocation flags (e.g., KM_ZERO)
+**
+** @return a pointer to the memory, or NULL
+*/
+void *kmalloc( uint32_t size, uint32_t flags ) {
+
+	if( size == 0 ) {
+		return( NULL );
+	}
+
+	// big requests go straight to the page allocator
+	if( size > KMA_MAX_SMALL ) {
+		return( _km_page_alloc_flags((size + SZ_PAGE - 1) / SZ_PAGE, flags) );
+	}
+
+	return( slab_alloc( &_kma_caches[_kma_class(size)],
+			(flags & KM_ZERO) ? SC_ALLOC_ZERO_MEM : 0 ) );
+}
+
+/**
+** Name:    kfree
+**
+** Release a block obtained from kmalloc()
+**
+** @param ptr  The block (NULL is ignored)
+*/
+void kfree( void *ptr ) {
+
+	if( ptr == NULL ) {
+		return;
+	}
+
+	// is this the start of a multi-page block?
+	if( ((uint32_t) ptr & (SZ_PAGE - 1)) == 0 &&
+			_km_page_lookup(ptr, NULL) == ptr ) {
+		_km_page_free( ptr );
+		return;
+	}
+
+	// no - it belongs to one of the caches
+	slab_cache_t *cache = slab_element_cache( ptr, true );
+
+	assert1( cache >= &_kma_caches[0] &&
+			cache < &_kma_caches[KMA_N_CACHES] );
+
+	slab_free( cache, ptr );
+}
@@ -0,0 +1,81 @@
+/**
+** @file	kmalloc.h
+**
+** @author	CSCI-452 class of 20235
+**
+** @brief	General-purpose kernel memory allocator declarations
+**
+** Requests of up to KMA_MAX_SMALL bytes are satisfied from a family
+** of slab caches whose element sizes are the powers of two from
+** KMA_MIN_SMALL through KMA_MAX_SMALL; larger requests are satisfied
+** directly by the page allocator.  The size of an allocation is
+** recovered when it is freed, so kfree() needs only the pointer.
+*/
+
+#ifndef KMALLOC_H_
+#define KMALLOC_H_
+
+#define SP_KERNEL_SRC
+
+#include "common.h"
+
+#include "kmem.h"
+
+/*
+** General (C and/or assembly) definitions
+*/
+
+// smallest and largest sizes handled by the slab caches
+
+#define KMA_MIN_SMALL   8
+#define KMA_MAX_SMALL   2048
+
+// number of slab caches (8, 16, 32, ..., 2048)
+
+#define KMA_N_CACHES    9
+
+#ifndef SP_ASM_SRC
+
+/*
+** Start of C-only definitions
+*/
+
+/*
+** Prototypes
+*/
+
+/**
+** Name:    _kma_init
+**
+** Initialize the kmalloc size-class caches
+**
+** Dependencies:
+**    Must be called after _km_init()
+*/
+void _kma_init( void );
+
+/**
+** Name:    kmalloc
+**
+** Allocate a block of memory of (at least) the specified size
+**
+** @param size   Number of bytes needed
+** @param flags  KM_* allocation flags (e.g., KM_ZERO)
+**
+** @return a pointer to the memory, or NULL
+*/
+void *kmalloc( uint32_t size, uint32_t flags );
+
+/**
+** Name:    kfree
+**
+** Release a block obtained from kmalloc()
+**
+** @param ptr  The block (NULL is ignored)
+*/
+void kfree( void *ptr );
+
+#endif
+// !SP_ASM_SRC
+
+#endif
@@ -13,24 +13,42 @@
 ** allocation of either 4096-byte ("page") or 1024-byte ("slice")
 ** chunks of memory from the free pool.  The free pool is initialized
 ** using the memory map provided by the BIOS during the boot sequence,
-** and contains a series of blocks which are multiples of 4K bytes and
-** which are aligned at 4K boundaries; they are held in the free list
-** in order by base address.
+** and is managed as a binary buddy system.
 **
 ** The "page" allocator allows allocation of one or more 4K blocks
-** at a time.  Requests are made for a specific number of 4K pages;
-** the allocator locates the first free list entry that contains at
-** least the requested amount of space.  If that entry is the exact
-** size requested, it is unlinked and returned; otherwise, the entry
-** is split into a chunk of the requested size and the remainder.
-** The chunk is returned, and the remainder replaces the original
-** block in the free list.  On deallocation, the block is inserted
-** at the appropriate place in the free list, and physically adjacent
-** blocks are coalesced into single, larger blocks.  If a multi-page
-** block is allocated, it should be deallocated one page at a time,
-** because there is no record of the size of the original allocation -
-** all we know is that it is N*4K bytes in length, so it's up to the
-** requesting code to figure this out.
+** at a time.  Free memory is held in a set of free lists, one per
+** "order"; a block of order k is 2^k pages long and is aligned on a
+** 2^k page boundary.  Requests are made for a specific number of 4K
+** pages; the request is rounded up to the next order, and the first
+** non-empty free list at or above that order supplies the block.  If
+** the block is larger than needed, it is split in half repeatedly;
+** the unused halves ("buddies") go back onto the lower-order lists.
+** Any pages beyond the requested count are returned to the free pool
+** immediately, so callers get exactly what they asked for.
+**
+** On deallocation, the block's buddy is located arithmetically (its
+** page frame number differs only in bit k); if the buddy is also free,
+** the two are merged and the process repeats at the next order up.
+** Both allocation and deallocation are O(log n) in the size of the
+** largest block.
+**
+** Every page frame has an entry in a page table (indexed by page
+** frame number) which is carved out of free memory at startup.  The
+** entry for the first page of a free block records the block's order,
+** which is how we know whether a buddy is free; the entry for the
+** first page of an allocated block records the length of the
+** allocation and who made it.  This allows a multi-page block to be
+** freed with a single call, and lets debugging code find the
+** allocation that any address belongs to.
+**
+** Callers which need zero-filled memory can ask for it with the
+** KM_ZERO flag.  To keep the cost of zeroing off of the allocation
+** path, a small pool of pre-zeroed blocks (of orders 0 through
+** ZP_MAX_ORDER) is kept on the side.  The pool is topped up by
+** _km_scrub(), which is called when the system would otherwise be
+** idle; it takes blocks from the buddy system, clears them, and
+** adds them to the pool.  If the pool can't satisfy a KM_ZERO
+** request, the memory is cleared inline, as before.
 **
 ** The "slice" allocator operates by taking blocks from the "page"
 ** allocator and splitting them into four 1K slices, which it then
@@ -40,7 +58,10 @@
 ** slices, and the slices are added to the free list, after which the
 ** first one is returned.  The slice free list is a simple linked list
 ** of these 1K blocks; because they are all the same size, no ordering
-** is done on the free list, and no coalescing is performed.
+** is done on the free list, and no coalescing is performed.  Slices
+** are always returned zero-filled; freshly-carved slices come from
+** zeroed pages, and freed slices are kept on a separate "dirty" list
+** until they are needed or _km_scrub() gets around to clearing them.
 **
 */
 
@@ -76,16 +97,19 @@
 #define P2B(x)   ((x) << LOG2_OF_PAGE_SIZE)
 #define B2P(x)   ((x) >> LOG2_OF_PAGE_SIZE)
 
-/*
-** Name:    adjacent
-**
-** Arguments:   addresses of two blocks
-**
-** Description: Determines whether the second block immediately
-**      follows the first one.
-*/
-#define adjacent(first,second)  \
-	( (void *) (first) + P2B((first)->pages) == (void *) (second) )
+// converters:  addresses to page frame numbers, and back again
+
+#define A2PFN(a)    B2P((uint32_t) (a))
+#define PFN2A(p)    ((void *) P2B((uint32_t) (p)))
+
+// number of pages in a block of order 'k'
+
+#define ORDER_PAGES(k)  (1U << (k))
+
+// zero pool parameters:  largest order kept, and blocks kept per order
+
+#define ZP_MAX_ORDER    2
+#define ZP_TARGET       8
 
 /*
 ** PRIVATE DATA TYPES
@@ -93,12 +117,15 @@
 
 /*
 ** This structure keeps track of a single block of memory.  All blocks
-** are multiples of the base size (currently, 4KB).
+** are multiples of the base size (currently, 4KB).  Free page blocks
+** are doubly-linked so that a buddy can be unlinked in O(1) time when
+** it is merged.
 */
 
 typedef struct blkinfo_s {
 	uint32_t pages;           // length of this block, in pages
 	struct   blkinfo_s *next; // pointer to the next free block
+	struct   blkinfo_s *prev; // pointer to the previous free block
 } Blockinfo;
 
 /*
@@ -154,13 +181,47 @@ typedef struct memregion_s {
 #define ADDR_32_MAX     ADDR_LOW_HALF
 #define ADDR_64_FIRST   ADDR_BIT_32
 
+// one past the highest address we will use; the host-side test
+// build gets its arena from the host, which may put it anywhere
+
+#ifdef HOST_TEST
+#define KM_TOP          ADDR_BIT_32
+#else
+#define KM_TOP          ((uint64_t) KM_LIMIT)
+#endif
+
+// where the BIOS memory map is; the host-side test build has no
+// BIOS, so its shim (prog/HostShim.c) builds a map and tells us
+
+#ifdef HOST_TEST
+extern int32_t *_host_mmap;
+#define KM_MMAP         ((uint32_t) _host_mmap)
+#else
+#define KM_MMAP         MMAP_ADDRESS
+#endif
+
 /*
 ** PRIVATE GLOBAL VARIABLES
 */
 
 // freespace pools
-static Blockinfo *_free_pages;
+static Blockinfo *_free_pages[KM_N_ORDERS];
 static Blockinfo *_free_slices;
+static Blockinfo *_dirty_slices;
+
+// pre-zeroed blocks, and how many of each order we have
+static Blockinfo *_zero_pool[ZP_MAX_ORDER + 1];
+static uint32_t _zero_count[ZP_MAX_ORDER + 1];
+
+// the page table, indexed by page frame number
+static kpage_t *_pages;
+
+// where the page table lives, and how much space it occupies
+static uint32_t _map_base;
+static uint32_t _map_length;
+
+// one past the highest page frame number we manage
+static uint32_t _max_pfn;
 
 // initialization status
 static int _km_initialized = 0;
@@ -179,16 +240,170 @@ extern int _end;    // end of the BSS section - provided by the linker
 ** FREE LIST MANAGEMENT
 */
 
+/**
+** Name:    _push_block
+**
+** Put a block on the free list for its order
+**
+** @param block  The block
+** @param order  Order of the block
+*/
+static void _push_block( Blockinfo *block, uint32_t order ) {
+
+	block->pages = ORDER_PAGES(order);
+	block->prev = NULL;
+	block->next = _free_pages[order];
+	if( block->next != NULL ) {
+		block->next->prev = block;
+	}
+	_free_pages[order] = block;
+}
+
+/**
+** Name:    _unlink_block
+**
+** Remove a block from the free list for its order
+**
+** @param block  The block
+** @param order  Order of the block
+*/
+static void _unlink_block( Blockinfo *block, uint32_t order ) {
+
+	if( block->prev != NULL ) {
+		block->prev->next = block->next;
+	} else {
+		assert1( _free_pages[order] == block );
+		_free_pages[order] = block->next;
+	}
+
+	if( block->next != NULL ) {
+		block->next->prev = block->prev;
+	}
+
+	block->next = block->prev = NULL;
+}
+
+/**
+** Name:    _buddy_free
+**
+** Return a block to the buddy system, merging it with its buddy
+** (and that block's buddy, etc.) as far as possible
+**
+** @param pfn    Page frame number of the block
+** @param order  Order of the block
+*/
+static void _buddy_free( uint32_t pfn, uint32_t order ) {
+
+	// this page is about to become either a free head or an interior page
+	_pages[pfn].flags = 0;
+
+	while( order < KM_MAX_ORDER ) {
+		uint32_t buddy = pfn ^ ORDER_PAGES(order);
+
+		// the buddy must exist, be free, and be exactly our size
+		if( buddy >= _max_pfn || (_pages[buddy].flags & KPG_FREE) == 0 ||
+				_pages[buddy].order != order ) {
+			break;
+		}
+
+		// it is - pull it off its list and merge
+		_unlink_block( (Blockinfo *) PFN2A(buddy), order );
+		_pages[buddy].flags = 0;
+
+		pfn &= ~ORDER_PAGES(order);
+		++order;
+	}
+
+	_pages[pfn].flags = KPG_FREE;
+	_pages[pfn].order = order;
+	_push_block( (Blockinfo *) PFN2A(pfn), order );
+}
+
+/**
+** Name:    _buddy_alloc
+**
+** Take a block of the specified order from the buddy system,
+** splitting larger blocks if necessary
+**
+** @param order  Order of the desired block
+**
+** @return the page frame number of the block, or 0 on failure
+*/
+static uint32_t _buddy_alloc( uint32_t order ) {
+	uint32_t k;
+
+	// find the smallest order which has something available
+	for( k = order; k < KM_N_ORDERS; ++k ) {
+		if( _free_pages[k] != NULL ) {
+			break;
+		}
+	}
+
+	if( k >= KM_N_ORDERS ) {
+		return( 0 );
+	}
+
+	Blockinfo *block = _free_pages[k];
+	_unlink_block( block, k );
+
+	uint32_t pfn = A2PFN(block);
+	_pages[pfn].flags = 0;
+
+	// split it down to size, freeing the upper halves
+	while( k > order ) {
+		--k;
+		uint32_t buddy = pfn + ORDER_PAGES(k);
+		_pages[buddy].flags = KPG_FREE;
+		_pages[buddy].order = k;
+		_push_block( (Blockinfo *) PFN2A(buddy), k );
+	}
+
+	return( pfn );
+}
+
+/**
+** Name:    _free_range
+**
+** Return a run of pages to the buddy system in
+** naturally-aligned power-of-two pieces
+**
+** @param pfn    Page frame number of the first page
+** @param pages  Number of pages in the run
+*/
+static void _free_range( uint32_t pfn, uint32_t pages ) {
+
+	while( pages > 0 ) {
+		uint32_t order = KM_MAX_ORDER;
+
+		// shrink the order until the block is aligned and fits
+		while( (pfn & (ORDER_PAGES(order) - 1)) != 0 ||
+				ORDER_PAGES(order) > pages ) {
+			--order;
+		}
+
+		_buddy_free( pfn, order );
+
+		pfn += ORDER_PAGES(order);
+		pages -= ORDER_PAGES(order);
+	}
+}
+
 /**
 ** Name:    _add_block
 **
-** Add a block to the free list
+** Add a block to the free pool
+**
+** The block is broken into the largest naturally-aligned
+** power-of-two pieces possible, each of which is freed into
+** the buddy system (and merged with any neighbors already there).
+**
+** Pages which are never given to us stay marked "in use" in the
+** page table, so nothing will ever try to merge with them.
 **
 ** @param base   Base address of the block
 ** @param length Block length, in bytes
 */
 static void _add_block( uint32_t base, uint32_t length ) {
-	Blockinfo *block;
 
 	// don't add it if it isn't at least 4K
 	if( length < SZ_PAGE ) {
@@ -201,57 +416,105 @@ static void _add_block( uint32_t base, uint32_t length ) {
 		length &= 0xfffff000;
 	}
 
-	// create the "block"
+	_free_range( A2PFN(base), B2P(length) );
+}
 
-	block = (Blockinfo *) base;
-	block->pages = B2P(length);
-	block->next = NULL;
+/**
+** Name:    _usable_region
+**
+** Decide whether or not a BIOS memory region is usable, and
+** trim it to the part we can actually use
+**
+** @param region  The region descriptor
+** @param cutoff  Lowest address we are willing to use
+** @param b32     (output) Base address of the usable part
+** @param l32     (output) Length of the usable part
+**
+** @return true if the region (or part of it) is usable, else false
+*/
+static bool_t _usable_region( region_t *region, uint64_t cutoff,
+		uint32_t *b32, uint32_t *l32 ) {
 
 	/*
-	** We maintain the free list in order by address, to simplify
-	** coalescing adjacent free blocks.
+	** Determine whether or not we should ignore this region.
 	**
-	** Handle the easiest case first.
+	** We ignore regions for several reasons:
+	**
+	**  ACPI indicates it should be ignored
+	**  ACPI indicates it's non-volatile memory
+	**  Region type isn't "usable"
+	**  Region is above the 4GB address limit
+	**
+	** Currently, only "normal" (type 1) regions are considered
+	** "usable" for our purposes.  We could potentially expand
+	** this to include ACPI "reclaimable" memory.
 	*/
 
-	if( _free_pages == NULL ) {
-		_free_pages = block;
-		return;
+	// first, check the ACPI one-bit flags
+
+	if( ((region->acpi) & REGION_IGNORE) == 0 ) {
+		return( false );
 	}
 
-	/*
-	** Unfortunately, it's not always that easy....
-	**
-	** Find the correct insertion spot.
-	*/
+	if( ((region->acpi) & REGION_NONVOL) != 0 ) {
+		return( false );  // we'll ignore this, too
+	}
 
-	Blockinfo *prev, *curr;
+	// next, the region type
 
-	prev = NULL;
-	curr = _free_pages;
+	if( (region->type) != REGION_USABLE ) {
+		return( false );  // we won't attempt to reclaim ACPI memory (yet)
+	}
 
-	while( curr && curr < block ) {
-		prev = curr;
-		curr = curr->next;
+	// OK, we have a "normal" memory region - verify that it's usable
+
+	// ignore it if it's above 4GB
+	if( region->base.HIGH != 0 ) {
+		return( false );
 	}
 
-	// the new block always points to its successor
-	block->next = curr;
+	// grab the two 64-bit values to simplify things
+	uint64_t base   = region->base.all;
+	uint64_t length = region->length.all;
 
-	/*
-	** If prev is NULL, we're adding at the front; otherwise,
-	** we're adding after some other entry (middle or end).
-	*/
+	// see if it's below our arbitrary cutoff point
+	if( base < cutoff ) {
 
-	if( prev == NULL ) {
-		// sanity check - both pointers can't be NULL
-		assert( curr );
-		// add at the beginning
-		_free_pages = block;
-	} else {
-		// inserting in the middle or at the end
-		prev->next = block;
+		// is the whole thing too low, or just part?
+		if( (base + length) < cutoff ) {
+			// it's all below the cutoff!
+			return( false );
+		}
+
+		// recalculate the length, starting at our cutoff point
+		uint64_t loss = cutoff - base;
+
+		// reset the length and the base address
+		length -= loss;
+		base = cutoff;
 	}
+
+	// see if it extends beyond the 4GB boundary, or our own limit
+
+	if( base >= KM_TOP ) {
+		return( false );
+	}
+
+	if( (base + length) > KM_TOP ) {
+
+		// OK, it extends beyond the limit; figure out
+		// how far over it goes, and lop off that portion
+
+		uint64_t loss = (base + length) - KM_TOP;
+		length -= loss;
+	}
+
+	// we survived the gauntlet
+
+	*b32 = base   & ADDR_LOW_HALF;
+	*l32 = length & ADDR_LOW_HALF;
+
+	return( true );
 }
 
 /**
@@ -266,15 +529,23 @@ static void _add_block( uint32_t base, uint32_t length ) {
 */
 void _km_init( void ) {
 	int32_t entries;
-	region_t *region;
+	region_t *regions;
 	uint64_t cutoff;
+	uint32_t b32, l32;
 
 	// announce that we're starting initialization
 	__cio_puts( " Kmem" );
 
 	// initially, nothing in the free lists
 	_free_slices = NULL;
-	_free_pages = NULL;
+	_dirty_slices = NULL;
+	for( int k = 0; k < KM_N_ORDERS; ++k ) {
+		_free_pages[k] = NULL;
+	}
+	for( int k = 0; k <= ZP_MAX_ORDER; ++k ) {
+		_zero_pool[k] = NULL;
+		_zero_count[k] = 0;
+	}
 
 	/*
 	** We ignore all memory below the end of our OS.  In theory,
@@ -292,94 +563,73 @@ void _km_init( void ) {
 	}
 
 	// get the list length
-	entries = *((int32_t *) MMAP_ADDRESS);
+	entries = *((int32_t *) KM_MMAP);
 
 	// if there are no entries, we have nothing to do!
 	if( entries < 1 ) {  // note: entries == -1 could occur!
 		return;
 	}
 
-	// iterate through the entries, adding things to the freelist
-
-	region = ((region_t *) (MMAP_ADDRESS + 4));
+	regions = ((region_t *) (KM_MMAP + 4));
 
-	for( int i = 0; i < entries; ++i, ++region ) {
-
-		/*
-		** Determine whether or not we should ignore this region.
-		**
-		** We ignore regions for several reasons:
-		**
-		**  ACPI indicates it should be ignored
-		**  ACPI indicates it's non-volatile memory
-		**  Region type isn't "usable"
-		**  Region is above the 4GB address limit
-		**
-		** Currently, only "normal" (type 1) regions are considered
-		** "usable" for our purposes.  We could potentially expand
-		** this to include ACPI "reclaimable" memory.
-		*/
+	/*
+	** First pass:  find the top of usable memory, so that we
+	** know how large the page table must be.
+	*/
 
-		// first, check the ACPI one-bit flags
+	_max_pfn = 0;
 
-		if( ((region->acpi) & REGION_IGNORE) == 0 ) {
-			continue;
-		}
-
-		if( ((region->acpi) & REGION_NONVOL) != 0 ) {
-			continue;  // we'll ignore this, too
+	for( int i = 0; i < entries; ++i ) {
+		if( _usable_region(&regions[i],cutoff,&b32,&l32) ) {
+			uint32_t top = A2PFN(b32) + B2P(l32);
+			if( top > _max_pfn ) {
+				_max_pfn = top;
+			}
 		}
+	}
 
-		// next, the region type
+	// one entry per page frame, rounded up to a whole page
+	_map_length = _max_pfn * sizeof(kpage_t);
+	_map_length = P2B( B2P(_map_length + SZ_PAGE - 1) );
 
-		if( (region->type) != REGION_USABLE ) {
-			continue;  // we won't attempt to reclaim ACPI memory (yet)
-		}
+	/*
+	** Second pass:  steal space for the page table from the
+	** beginning of the first region that is large enough.
+	*/
 
-		// OK, we have a "normal" memory region - verify that it's usable
+	_map_base = 0;
 
-		// ignore it if it's above 4GB
-		if( region->base.HIGH != 0 ) {
-			continue;
+	for( int i = 0; i < entries; ++i ) {
+		if( _usable_region(&regions[i],cutoff,&b32,&l32) &&
+				l32 >= _map_length + SZ_PAGE ) {
+			_map_base = b32;
+			break;
 		}
+	}
 
-		// grab the two 64-bit values to simplify things
-		uint64_t base   = region->base.all;
-		uint64_t length = region->length.all;
+	// no room for the page table means no memory to speak of
+	assert( _map_base != 0 );
 
-		// see if it's below our arbitrary cutoff point
-		if( base < cutoff ) {
+	// every page starts out "in use" until we learn otherwise
+	_pages = (kpage_t *) _map_base;
+	__memclr( (void *) _pages, _map_length );
 
-			// is the whole thing too low, or just part?
-			if( (base + length) < cutoff ) {
-				// it's all below the cutoff!
-				continue;
-			}
+	/*
+	** Third pass:  give every usable region to the buddy system.
+	*/
 
-			// recalculate the length, starting at our cutoff point
-			uint64_t loss = cutoff - base;
+	for( int i = 0; i < entries; ++i ) {
 
-			// reset the length and the base address
-			length -= loss;
-			base = cutoff;
+		if( !_usable_region(&regions[i],cutoff,&b32,&l32) ) {
+			continue;
 		}
 
-		// see if it extends beyond the 4GB boundary
-
-		if( (base + length) > ADDR_32_MAX ) {
-
-			// OK, it extends beyond the 32-bit limit; figure out
-			// how far over it goes, and lop off that portion
-
-			uint64_t loss = (base + length) - ADDR_64_FIRST;
-			length -= loss;
+		// skip over the page table
+		if( b32 == _map_base ) {
+			b32 += _map_length;
+			l32 -= _map_length;
 		}
 
-		// we survived the gauntlet - add the new block
-
-		uint32_t b32 = base   & ADDR_LOW_HALF;
-		uint32_t l32 = length & ADDR_LOW_HALF;
-
 		_add_block( b32, l32 );
 	}
 
@@ -390,20 +640,29 @@ void _km_init( void ) {
 /**
 ** Name:    _km_dump
 **
-** Dump the current contents of the free list to the console
+** Dump the current contents of the free lists to the console
 */
 void _km_dump( void ) {
 	Blockinfo *block;
 
-	__cio_printf( "&_free_pages=%08x\n", &_free_pages );
+	__cio_printf( "&_free_pages=%08x\n", _free_pages );
+
+	for( int k = 0; k < KM_N_ORDERS; ++k ) {
+		int n = 0;
+		for( block = _free_pages[k]; block != NULL; block = block->next ) {
+			++n;
+		}
+		__cio_printf( "order %2d (%4d pages): %d free\n",
+				k, ORDER_PAGES(k), n );
+	}
 
-	for( block = _free_pages; block != NULL; block = block->next ) {
-		__cio_printf(
-			"block @ 0x%08x 0x%08x pages (ends at 0x%08x) next @ 0x%08x\n",
-				block, block->pages, P2B(block->pages) + (uint32_t) block,
-				block->next );
+	int dirty = 0;
+	for( block = _dirty_slices; block != NULL; block = block->next ) {
+		++dirty;
 	}
 
+	__cio_printf( "zero pool: %d/%d/%d blocks, %d dirty slices\n",
+			_zero_count[0], _zero_count[1], _zero_count[2], dirty );
 }
 
 /*
@@ -411,96 +670,148 @@ void _km_dump( void ) {
 */
 
 /**
-** Name:    _km_page_alloc
+** Name:    _zero_pool_drain
 **
-** Allocate a page of memory from the free list.
+** Return everything in the zero pool to the buddy system
+**
+** Used when the buddy system has nothing left; zeroed pages
+** are better than no pages at all.
+**
+** @return true if anything was released, else false
+*/
+static bool_t _zero_pool_drain( void ) {
+	bool_t released = false;
+
+	for( int k = 0; k <= ZP_MAX_ORDER; ++k ) {
+		while( _zero_pool[k] != NULL ) {
+			Blockinfo *block = _zero_pool[k];
+			_zero_pool[k] = block->next;
+			_free_range( A2PFN(block), ORDER_PAGES(k) );
+			released = true;
+		}
+		_zero_count[k] = 0;
+	}
+
+	return( released );
+}
+
+/**
+** Name:    _page_alloc
+**
+** Common code for the page allocation functions
 **
 ** @param count  Number of contiguous pages desired
+** @param flags  KM_* allocation flags
+** @param owner  Who is asking for the pages
 **
 ** @return a pointer to the beginning of the first allocated page,
 **         or NULL if no memory is available
 */
-void *_km_page_alloc( unsigned int count ) {
+static void *_page_alloc( uint32_t count, uint32_t flags, void *owner ) {
 
 	assert( _km_initialized );
 
 	// make sure we actually need to do something!
-	if( count < 1 ) {
+	if( count < 1 || count > ORDER_PAGES(KM_MAX_ORDER) ) {
 		return( NULL );
 	}
 
-	/*
-	** Look for the first entry that is large enough.
-	*/
-
-	// pointer to the current block
-	Blockinfo *block = _free_pages;
-
-	// pointer to where the pointer to the current block is
-	Blockinfo **pointer = &_free_pages;
-
-	while( block != NULL && block->pages < count ){
-		pointer = &block->next;
-		block = *pointer;
+	// find the smallest order that will hold the request
+	uint32_t order = 0;
+	while( ORDER_PAGES(order) < count ) {
+		++order;
 	}
 
-	// did we find a big enough block?
-	if( block == NULL ){
-		// nope!
-		return( NULL );
+	uint32_t pfn = 0;
+	bool_t clean = false;
+
+	// zeroed requests for an exact pool block size come from the pool
+	if( (flags & KM_ZERO) != 0 && order <= ZP_MAX_ORDER &&
+			count == ORDER_PAGES(order) && _zero_pool[order] != NULL ) {
+		Blockinfo *block = _zero_pool[order];
+		_zero_pool[order] = block->next;
+		_zero_count[order] -= 1;
+		// only the linkage was ever written into it
+		__memclr( (void *) block, sizeof(Blockinfo) );
+		pfn = A2PFN(block);
+		clean = true;
 	}
 
-	// found one!  check the length
-
-	if( block->pages == count ) {
-
-		// exactly the right size - unlink it from the list
-
-		*pointer = block->next;
-
-	} else {
-
-		// bigger than we need - carve the amount we need off
-		// the beginning of this block
+	if( pfn == 0 ) {
+		pfn = _buddy_alloc( order );
+		if( pfn == 0 && _zero_pool_drain() ) {
+			pfn = _buddy_alloc( order );
+		}
+		if( pfn == 0 ) {
+			return( NULL );
+		}
 
-		// remember where this chunk begins
-		Blockinfo *chunk = block;
+		/*
+		** Give back anything beyond the requested length, so that
+		** we don't waste up to half of the block.
+		*/
 
-		// how much space will be left over?
-		int excess = block->pages - count;
+		_free_range( pfn + count, ORDER_PAGES(order) - count );
+	}
 
-		// find the start of the new fragment
-		Blockinfo *fragment = (Blockinfo *) ( (uint8_t *) block + P2B(count) );
+	// record the allocation
+	_pages[pfn].flags = KPG_ALLOC;
+	_pages[pfn].order = order;
+	_pages[pfn].pages = count;
+	_pages[pfn].refs = 0;
+	_pages[pfn].owner = owner;
 
-		// set the length and link for the new fragment
-		fragment->pages = excess;
-		fragment->next  = block->next;
+	if( (flags & KM_ZERO) != 0 && !clean ) {
+		__memclr( PFN2A(pfn), P2B(count) );
+	}
 
-		// replace this chunk with the fragment
-		*pointer = fragment;
+	return( PFN2A(pfn) );
+}
 
-		// return this chunk
-		block = chunk;
-	}
+/**
+** Name:    _km_page_alloc
+**
+** Allocate a page of memory from the free list.
+**
+** The caller's return address is recorded as the owner of the
+** allocation; see _km_page_lookup().
+**
+** @param count  Number of contiguous pages desired
+**
+** @return a pointer to the beginning of the first allocated page,
+**         or NULL if no memory is available
+*/
+void *_km_page_alloc( unsigned int count ) {
+	return( _page_alloc(count, 0, __builtin_return_address(0)) );
+}
 
-	return( block );
+/**
+** Name:    _km_page_alloc_flags
+**
+** Allocate pages of memory, with options.
+**
+** @param count  Number of contiguous pages desired
+** @param flags  KM_* allocation flags (e.g., KM_ZERO)
+**
+** @return a pointer to the beginning of the first allocated page,
+**         or NULL if no memory is available
+*/
+void *_km_page_alloc_flags( unsigned int count, uint32_t flags ) {
+	return( _page_alloc(count, flags, __builtin_return_address(0)) );
 }
 
 /**
 ** Name:    _km_page_free
 **
-** Returns a memory block to the list of available blocks,
-** combining it with adjacent blocks if they're present.
+** Returns a memory block to the buddy system, combining it
+** with its buddy (and so on) if they're free.
 **
-** CRITICAL ASSUMPTION:  multi-page blocks will be freed one page
-** at a time!
+** The entire block which was allocated is released; the length
+** is taken from the page table.
 **
-** @param block   Pointer to the page to be returned to the free list
+** @param block   Pointer to the block to be returned to the free list
 */
 void _km_page_free( void *block ){
-	Blockinfo *used;
-	Blockinfo *prev;
-	Blockinfo *curr;
 
 	assert( _km_initialized );
 
@@ -511,103 +822,146 @@ void _km_page_free( void *block ){
 		return;
 	}
 
-	used = (Blockinfo *) block;
+	uint32_t pfn = A2PFN(block);
 
-	/*
-	** CRITICAL ASSUMPTION
-	**
-	** We assume that any multi-page block that is being freed will
-	** be freed one page at a time.  We make this assumption because we
-	** don't track allocation sizes.  We can't use the simple "allocate
-	** four extra bytes before the returned pointer" scheme to do this
-	** because we're managing pages, and the pointers we return must point
-	** to page boundaries, so we would wind up allocating an extra page
-	** for each allocation.
-	**
-	** Alternatively, we could keep an array of addresses and block
-	** sizes ourselves, but that feels clunky, and would risk running out
-	** of table entries if there are lots of allocations (assuming we use
-	** a 4KB page to hold the table, at eight bytes per entry we would have
-	** 512 entries per page).
-	**
-	** IF THIS ASSUMPTION CHANGES, THIS CODE MUST BE FIXED!!!
-	*/
+	// it must be the beginning of something we gave out
+	assert1( ((uint32_t) block & (SZ_PAGE - 1)) == 0 );
+	assert1( pfn < _max_pfn );
+	assert( (_pages[pfn].flags & KPG_ALLOC) != 0 );
 
-	used->pages = 1;
-
-	/*
-	** Advance through the list until current and previous
-	** straddle the place where the new block should be inserted.
-	*/
-	prev = NULL;
-	curr = _free_pages;
-
-	while( curr != NULL && curr < used ){
-		prev = curr;
-		curr = curr->next;
+	// someone else still has it
+	if( _pages[pfn].refs > 0 ) {
+		_pages[pfn].refs -= 1;
+		return;
 	}
 
-	/*
-	** At this point, we have the following list structure:
-	**
-	**   ....    BLOCK       BLOCK      ....
-	**          (*prev)  ^  (*curr)
-	**                   |
-	**                "used" goes here
-	**
-	** We may need to merge the inserted block with either its
-	** predecessor or its successor (or both).
-	*/
+	_free_range( pfn, _pages[pfn].pages );
+}
 
-	/*
-	** If this is not the first block in the resulting list,
-	** we may need to merge it with its predecessor.
-	*/
-	if( prev != NULL ){
+/**
+** Name:    _km_page_share
+**
+** Add a reference to an allocated block; each reference must be
+** released with its own call to _km_page_free()
+**
+** @param block   Pointer to the beginning of the block
+*/
+void _km_page_share( void *block ) {
+	uint32_t pfn = A2PFN(block);
 
-		// There is a predecessor.  Check to see if we need to merge.
-		if( adjacent( prev, used ) ){
+	assert1( pfn < _max_pfn );
+	assert( (_pages[pfn].flags & KPG_ALLOC) != 0 );
 
-			// yes - merge them
-			prev->pages += used->pages;
+	_pages[pfn].refs += 1;
+}
 
-			// the predecessor becomes the "newly inserted" block,
-			// because we still need to check to see if we should
-			// merge with the successor
-			used = prev;
+/**
+** Name:    _km_page_refs
+**
+** @param block   Pointer to the beginning of an allocated block
+**
+** @return the number of references to the block (at least 1)
+*/
+uint32_t _km_page_refs( void *block ) {
+	uint32_t pfn = A2PFN(block);
 
-		} else {
+	assert1( pfn < _max_pfn );
+	assert( (_pages[pfn].flags & KPG_ALLOC) != 0 );
 
-			// Not adjacent - just insert the new block
-			// between the predecessor and the successor.
-			used->next = prev->next;
-			prev->next = used;
+	return( _pages[pfn].refs + 1 );
+}
 
-		}
+/**
+** Name:    _km_page_lookup
+**
+** Locate the page allocation which contains an address
+**
+** @param addr   The address of interest
+** @param info   (output) Description of the allocation, or NULL
+**
+** @return the beginning of the allocated block containing 'addr',
+**         or NULL if 'addr' isn't in an allocated block
+*/
+void *_km_page_lookup( void *addr, kpage_t *info ) {
 
-	} else {
+	assert( _km_initialized );
 
-		// Yes, it is first.  Update the list pointer to insert it.
-		used->next = _free_pages;
-		_free_pages = used;
+	uint32_t pfn = A2PFN(addr);
 
+	if( pfn >= _max_pfn ) {
+		return( NULL );
 	}
 
 	/*
-	** If this is not the last block in the resulting list,
-	** we may (also) need to merge it with its successor.
+	** Only the first page of each block is marked, so we walk
+	** backward to the nearest one; no block is longer than the
+	** largest order, which bounds the search.
 	*/
-	if( curr != NULL ){
 
-		// No.  Check to see if it should be merged with the successor.
-		if( adjacent( used, curr ) ){
+	uint32_t limit = pfn > ORDER_PAGES(KM_MAX_ORDER) ?
+			pfn - ORDER_PAGES(KM_MAX_ORDER) : 0;
+
+	for( uint32_t head = pfn; ; --head ) {
+
+		if( (_pages[head].flags & KPG_ALLOC) != 0 ) {
+			if( pfn >= head + _pages[head].pages ) {
+				return( NULL );  // in a free tail, or unmanaged
+			}
+			if( info != NULL ) {
+				*info = _pages[head];
+			}
+			return( PFN2A(head) );
+		}
+
+		if( (_pages[head].flags & KPG_FREE) != 0 || head == limit ) {
+			return( NULL );
+		}
+	}
+}
+
+/**
+** Name:    _km_scrub
+**
+** Do one unit of deferred zeroing work:  either top up the zero
+** pool by one block, or clear one dirty slice.  Intended to be
+** called when the CPU has nothing better to do.
+**
+** @return true if any work was done, else false
+*/
+bool_t _km_scrub( void ) {
 
-			// Yes, combine them.
-			used->next = curr->next;
-			used->pages += curr->pages;
+	if( !_km_initialized ) {
+		return( false );
+	}
 
+	// refill the pool, smallest blocks first
+	for( int k = 0; k <= ZP_MAX_ORDER; ++k ) {
+		if( _zero_count[k] < ZP_TARGET ) {
+			uint32_t pfn = _buddy_alloc( k );
+			if( pfn == 0 ) {
+				return( false );  // don't make memory pressure worse
+			}
+			__memclr( PFN2A(pfn), P2B(ORDER_PAGES(k)) );
+			Blockinfo *block = (Blockinfo *) PFN2A(pfn);
+			block->pages = ORDER_PAGES(k);
+			block->next = _zero_pool[k];
+			_zero_pool[k] = block;
+			_zero_count[k] += 1;
+			return( true );
 		}
 	}
+
+	// then clean up a freed slice
+	if( _dirty_slices != NULL ) {
+		Blockinfo *slice = _dirty_slices;
+		_dirty_slices = slice->next;
+		__memclr( (void *) slice, SZ_SLICE );
+		slice->next = _free_slices;
+		_free_slices = slice;
+		return( true );
+	}
+
+	return( false );
 }
 
 /*
@@ -630,15 +984,18 @@ static void _carve_slices( void ) {
 	void *page;
 
 	// get a page
-	page = _km_page_alloc( 1 );
+	page = _page_alloc( 1, KM_ZERO, __builtin_return_address(0) );
 
 	// allocation failure is a show-stopping problem
 	assert( page );
 
-	// we have the page; create the four slices from it
+	// we have the page; create the four (clean) slices from it
 	uint8_t *ptr = (uint8_t *) page;
 	for( int i = 0; i < 4; ++i ) {
-		_km_slice_free( (void *) ptr );
+		Blockinfo *slice = (Blockinfo *) ptr;
+		slice->pages = SZ_SLICE;
+		slice->next = _free_slices;
+		_free_slices = slice;
 		ptr += SZ_SLICE;
 	}
 }
@@ -656,17 +1013,26 @@ void *_km_slice_alloc( void ) {
 
 	assert( _km_initialized );
 
+	// prefer slices that are already clean
+	if( _free_slices != NULL ) {
+		slice = _free_slices;
+		_free_slices = slice->next;
+		// only the linkage was ever written into it
+		__memclr( (void *) slice, sizeof(Blockinfo) );
+		return( slice );
+	}
+
 	// if we are out of slices, create a few more
-	if( _free_slices == NULL ) {
+	if( _dirty_slices == NULL ) {
 		_carve_slices();
+		return( _km_slice_alloc() );
 	}
 
-	// take the first one from the free list
-	slice = _free_slices;
-	assert( slice != NULL );
+	// take the first one from the dirty list
+	slice = _dirty_slices;
 
 	// unlink it
-	_free_slices = slice->next;
+	_dirty_slices = slice->next;
 
 	// make it nice and shiny for the caller
 	__memclr( (void *) slice, SZ_SLICE );
@@ -689,8 +1055,168 @@ void _km_slice_free( void *block ) {
 
 	assert( _km_initialized );
 
-	// just add it to the front of the free list
+	// just add it to the front of the dirty list
 	slice->pages = SZ_SLICE;
-	slice->next = _free_slices;
-	_free_slices = slice;
+	slice->next = _dirty_slices;
+	_dirty_slices = slice;
 }
+
+#ifdef KMEM_BENCH
+
+/*
+** ALLOCATOR BENCHMARK
+*/
+
+/*
+** The original first-fit allocator, kept here (operating on a private
+** arena) so that the buddy allocator can be compared against it.
+*/
+
+#define BENCH_ARENA_ORDER   8
+#define BENCH_SLOTS         32
+#define BENCH_ROUNDS        4096
+#define BENCH_BIG_PAGES     4
+
+static Blockinfo *_ff_free;
+
+static void *_ff_alloc( uint32_t count ) {
+	Blockinfo *block = _ff_free;
+	Blockinfo **pointer = &_ff_free;
+
+	while( block != NULL && block->pages < count ) {
+		pointer = &block->next;
+		block = *pointer;
+	}
+
+	if( block == NULL ) {
+		return( NULL );
+	}
+
+	if( block->pages == count ) {
+		*pointer = block->next;
+	} else {
+		Blockinfo *fragment = (Blockinfo *) ((uint8_t *) block + P2B(count));
+		fragment->pages = block->pages - count;
+		fragment->next  = block->next;
+		*pointer = fragment;
+	}
+
+	return( block );
+}
+
+static void _ff_page_free( void *page ) {
+	Blockinfo *used = (Blockinfo *) page;
+	Blockinfo *prev = NULL;
+	Blockinfo *curr = _ff_free;
+
+	used->pages = 1;
+
+	while( curr != NULL && curr < used ) {
+		prev = curr;
+		curr = curr->next;
+	}
+
+	if( prev != NULL && (void *) prev + P2B(prev->pages) == (void *) used ) {
+		prev->pages += 1;
+		used = prev;
+	} else {
+		used->next = curr;
+		if( prev != NULL ) {
+			prev->next = used;
+		} else {
+			_ff_free = used;
+		}
+	}
+
+	if( curr != NULL && (void *) used + P2B(used->pages) == (void *) curr ) {
+		used->next = curr->next;
+		used->pages += curr->pages;
+	}
+}
+
+/*
+** Run the same pseudo-random stream of 1- and 4-page
+** allocations and page-at-a-time frees through an allocator.
+*/
+static uint32_t _bench_run( void *(*alloc)(uint32_t), void (*release)(void *) ) {
+	void *slot[BENCH_SLOTS];
+	uint32_t size[BENCH_SLOTS];
+	uint32_t seed = 0x1234567;
+
+	for( int i = 0; i < BENCH_SLOTS; ++i ) {
+		slot[i] = NULL;
+	}
+
+	uint64_t start = __rdtsc();
+
+	for( int r = 0; r < BENCH_ROUNDS; ++r ) {
+		seed = seed * 1103515245 + 12345;
+		int i = (seed >> 16) % BENCH_SLOTS;
+
+		if( slot[i] == NULL ) {
+			size[i] = (seed & 0x100) ? BENCH_BIG_PAGES : 1;
+			slot[i] = alloc( size[i] );
+		} else {
+			for( uint32_t p = 0; p < size[i]; ++p ) {
+				release( (uint8_t *) slot[i] + P2B(p) );
+			}
+			slot[i] = NULL;
+		}
+	}
+
+	for( int i = 0; i < BENCH_SLOTS; ++i ) {
+		if( slot[i] != NULL ) {
+			for( uint32_t p = 0; p < size[i]; ++p ) {
+				release( (uint8_t *) slot[i] + P2B(p) );
+			}
+		}
+	}
+
+	return( (uint32_t) (__rdtsc() - start) );
+}
+
+static void *_buddy_bench_alloc( uint32_t count ) {
+	return( _km_page_alloc(count) );
+}
+
+/*
+** The buddy allocator frees each block with a single call, so the
+** "release" step only needs to look at the first page of each block.
+*/
+static void _buddy_bench_free( void *page ) {
+	if( (_pages[A2PFN(page)].flags & KPG_ALLOC) != 0 ) {
+		_km_page_free( page );
+	}
+}
+
+/**
+** Name:    _km_bench
+**
+** Compare the buddy allocator against the first-fit allocator it
+** replaced, reporting the TSC cycles each took for the same workload
+*/
+void _km_bench( void ) {
+
+	assert( _km_initialized );
+
+	// give the first-fit allocator a private arena, pre-fragmented
+	// by freeing it a page at a time (as the old code required)
+	uint8_t *arena = _km_page_alloc( ORDER_PAGES(BENCH_ARENA_ORDER) );
+	assert( arena != NULL );
+
+	_ff_free = NULL;
+	for( uint32_t p = 0; p < ORDER_PAGES(BENCH_ARENA_ORDER); ++p ) {
+		_ff_page_free( arena + P2B(p) );
+	}
+
+	uint32_t ff = _bench_run( _ff_alloc, _ff_page_free );
+	uint32_t buddy = _bench_run( _buddy_bench_alloc, _buddy_bench_free );
+
+	_km_page_free( arena );
+
+	__cio_printf( "\nkmem bench: %d ops, first-fit %u cycles, buddy %u cycles\n",
+			BENCH_ROUNDS, ff, buddy );
+}
+
+#endif
+/* KMEM_BENCH */
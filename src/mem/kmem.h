@@ -7,14 +7,12 @@
 **
 ** @brief	Support for dynamic memory allocation within the OS.
 **
-** The list of free blocks is ordered by address to facilitate
-** combining freed blocks with adjacent blocks that are already
-** free.
+** Free pages are managed by a binary buddy system:  there is one
+** free list per block order (a block of order k is 2^k pages), and
+** freed blocks are combined with their buddies whenever possible.
 **
-** All requests for memory are satisfied with blocks that are
-** an integral number of 4-byte words.  More memory may be
-** provided than was requested if the fragment left over after
-** the allocation would not be large enough to be useable.
+** All page requests are satisfied with exactly the number of pages
+** requested; slices are always SZ_SLICE bytes long.
 */
 
 #ifndef KMEM_H_
@@ -38,6 +36,20 @@
 #define SZ_SLAB     SZ_PAGE
 #define SZ_SLICE    (SZ_SLAB / 4)
 
+// Page allocation flags
+
+#define KM_ZERO         0x01    // memory must be zero-filled
+
+// Physical memory at or above this address is never allocated:  the
+// VM module uses the virtual addresses from here up for process stacks
+
+#define KM_LIMIT        0xbfc00000
+
+// Buddy system block orders:  0 (one page) through KM_MAX_ORDER
+
+#define KM_MAX_ORDER    10
+#define KM_N_ORDERS     (KM_MAX_ORDER + 1)
+
 #ifndef SP_ASM_SRC
 
 /*
@@ -48,6 +60,31 @@
 ** Types
 */
 
+/*
+** Page table entry
+**
+** There is one of these for every page frame in the system.  Only
+** the entry for the first page of a block (free or allocated) is
+** meaningful; the entries for the remaining pages are left clear.
+**
+** An allocated block may be shared (e.g., a stack page mapped into
+** two address spaces after a fork); 'refs' counts the holders beyond
+** the first, and the block is only freed when the last one lets go.
+*/
+
+typedef struct kpage_s {
+	uint8_t  flags;   // KPG_* bits
+	uint8_t  order;   // block order (free), or rounded-up order (allocated)
+	uint16_t pages;   // length of the allocation, in pages
+	uint32_t refs;    // additional references to an allocated block
+	void    *owner;   // where the allocation was made
+} kpage_t;
+
+// page table entry flags
+
+#define KPG_FREE    0x01    // first page of a free block
+#define KPG_ALLOC   0x02    // first page of an allocated block
+
 /*
 ** Globals
 */
@@ -75,6 +112,16 @@ void _km_init( void );
 */
 void _km_dump( void );
 
+#ifdef KMEM_BENCH
+/**
+** Name:    _km_bench
+**
+** Compare the buddy allocator against the first-fit allocator it
+** replaced, reporting the TSC cycles each took for the same workload
+*/
+void _km_bench( void );
+#endif
+
 /*
 ** Functions that manipulate free memory blocks.
 */
@@ -84,6 +131,9 @@ void _km_dump( void );
 **
 ** Allocate a page of memory from the free list.
 **
+** The caller's return address is recorded as the owner of the
+** allocation; see _km_page_lookup().
+**
 ** @param count  Number of contiguous pages desired
 **
 ** @return a pointer to the beginning of the first allocated page,
@@ -91,19 +141,76 @@ void _km_dump( void );
 */
 void *_km_page_alloc( unsigned int count );
 
+/**
+** Name:    _km_page_alloc_flags
+**
+** Allocate pages of memory, with options.
+**
+** @param count  Number of contiguous pages desired
+** @param flags  KM_* allocation flags (e.g., KM_ZERO)
+**
+** @return a pointer to the beginning of the first allocated page,
+**         or NULL if no memory is available
+*/
+void *_km_page_alloc_flags( unsigned int count, uint32_t flags );
+
 /**
 ** Name:    _km_page_free
 **
-** Returns a memory block to the list of available blocks,
-** combining it with adjacent blocks if they're present.
+** Returns a memory block to the buddy system, combining it
+** with its buddy (and so on) if they're free.
 **
-** CRITICAL ASSUMPTION:  multi-page blocks will be freed one page
-** at a time!
+** The entire block which was allocated is released; the length
+** is taken from the page table.  A shared block just loses one
+** reference.
 **
-** @param block   Pointer to the page to be returned to the free list
+** @param block   Pointer to the block to be returned to the free list
 */
 void _km_page_free( void *block );
 
+/**
+** Name:    _km_page_share
+**
+** Add a reference to an allocated block; each reference must be
+** released with its own call to _km_page_free()
+**
+** @param block   Pointer to the beginning of the block
+*/
+void _km_page_share( void *block );
+
+/**
+** Name:    _km_page_refs
+**
+** @param block   Pointer to the beginning of an allocated block
+**
+** @return the number of references to the block (at least 1)
+*/
+uint32_t _km_page_refs( void *block );
+
+/**
+** Name:    _km_page_lookup
+**
+** Locate the page allocation which contains an address
+**
+** @param addr   The address of interest
+** @param info   (output) Description of the allocation, or NULL
+**
+** @return the beginning of the allocated block containing 'addr',
+**         or NULL if 'addr' isn't in an allocated block
+*/
+void *_km_page_lookup( void *addr, kpage_t *info );
+
+/**
+** Name:    _km_scrub
+**
+** Do one unit of deferred zeroing work:  either top up the zero
+** pool by one block, or clear one dirty slice.  Intended to be
+** called when the CPU has nothing better to do.
+**
+** @return true if any work was done, else false
+*/
+bool_t _km_scrub( void );
+
 /**
 ** Name:    _km_slice_alloc
 **
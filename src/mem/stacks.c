@@ -11,8 +11,13 @@
 ** in the process module.
 **
 ** If compiled without that symbol, this module dynamically allocates
-** stacks for processes as needed, and keeps deallocated stacks in
-** a free list for quick re-use.
+** stacks for processes as needed, and returns deallocated stacks to
+** the page allocator, which zeroes them in the background so that
+** the next allocation doesn't have to.
+**
+** Process stacks themselves now belong to the process' address space
+** (see vm.h); this module lays out their initial contents, and
+** manages the stack the OS itself runs on.
 */
 
 #define	SP_KERNEL_SRC
@@ -21,6 +26,7 @@
 
 #include "kern/kernel.h"
 #include "stacks.h"
+#include "kmalloc.h"
 
 #include "bootstrap.h"
 
@@ -135,18 +141,17 @@ stack_t *_stk_alloc( void )
 		assert( _free_stacks != NULL );
 #endif
 
-		// must allocate a new stack
-		new = (uint32_t *) _km_page_alloc( PGS_PER_STACK );
+		// must allocate a new stack; the allocator hands us one
+		// that is already clean (usually from its pre-zeroed pool)
+		new = (uint32_t *) _km_page_alloc_flags( PGS_PER_STACK, KM_ZERO );
 
 	} else {
 
 		// can re-use an existing stack
 		new = _free_stacks;
 		_free_stacks = (uint32_t *) *new;
-	}
 
-	// if we succeeded, clean up the space for the caller
-	if( new != NULL ) {
+		// clean up the space for the caller
 		__memclr( new, sizeof(stack_t) );
 	}
 
@@ -164,33 +169,33 @@ void _stk_dealloc( stack_t *stk )
 	// sanity check
 	assert1( stk != NULL );
 
+#ifdef STATIC_STACKS
 	uint32_t *tmp = (uint32_t *) stk;
 
 	// link it into the free list
 	*tmp = (uint32_t) _free_stacks;
 	_free_stacks = tmp;
+#else
+	// give it back; it will be scrubbed when the system is idle
+	_km_page_free( stk );
+#endif
 }
 
 /**
-** _stk_setup - set up the stack for a new process
+** _stk_setup - set up the stack for a new process (or thread)
 **
-** @param stk    - The stack to be set up
+** @param pgdir  - The address space whose stack is to be set up
+** @param top    - The top of the stack (see VM_SLOT_TOP())
 ** @param entry  - Entry point for the new process
 ** @param args   - Argument vector to be put in place
 **
 ** @return A pointer to the context_t on the stack, or NULL
 */
-context_t *_stk_setup( stack_t *stk, uint32_t entry, char *args[] )
+context_t *_stk_setup( pde_t *pgdir, uint32_t top, uint32_t entry,
+		char *args[] )
 {
 
 	/*
-	** We must duplicate the argv array here, because the first
-	** thing we do before setting up the new stack for the user
-	** is to clear out the old contents.  This is a potential
-	** problem if we are called via the _sys_exec() system call,
-	** because "args" is actually on the user stack that we're
-	** about to clear!
-	**
 	** Figure out how many arguments & argument chars there are.
 	*/
 
@@ -205,8 +210,8 @@ context_t *_stk_setup( stack_t *stk, uint32_t entry, char *args[] )
 	argbytes = (argbytes + 3) & 0xfffffffc;
 
 #if TRACING_STACK
-	__cio_printf( "=== _stk_setup(%08x,%08x) %d args:",
-			(uint32_t) stk, entry, argc );
+	__cio_printf( "=== _stk_setup(%08x,%08x,%08x) %d args:",
+			(uint32_t) pgdir, top, entry, argc );
 	for( int i = 0; i < argc; ++i ) {
 		__cio_printf( " '%s'", args[i] );
 	}
@@ -214,66 +219,35 @@ context_t *_stk_setup( stack_t *stk, uint32_t entry, char *args[] )
 #endif
 
 	/*
-	** Allocate the arrays.  We are safe using dynamic arrays here
-	** because we're using the OS stack, not the user stack.
+	** The stack is at the same address in every process (for its
+	** first thread, anyway), but it
+	** is only visible at that address in its own address space,
+	** which may not be the current one.  (If we were called via the
+	** _sys_exec() system call, 'args' is on the current stack, which
+	** is being replaced.)  So, we build the initial stack contents
+	** in a kmalloc() block, laid out exactly as they will be at the
+	** top of the new stack, and copy them into place afterward.
 	**
-	** We want the argstrings and argv arrays to contain all zeroes.
-	** The C standard states, in section 6.7.8, that
-	**
-	**   "21 If there are fewer initializers in a brace-enclosed list
-	**       than there are elements or members of an aggregate, or
-	**       fewer characters in a string literal used to initialize an
-	**       array of known size than there are elements in the array,
-	**       the remainder of the aggregate shall be initialized
-	**       implicitly the same as objects that have static storage
-	**       duration."
-	**
-	** Sadly, because we're using variable-sized arrays, we can't
-	** rely on this, so we have to call __memclr() instead. :-(  In
-	** truth, it doesn't really cost us much more time, but it's an
-	** annoyance.
+	** The block must hold the argv strings and the trailing pointer,
+	** the argv array with its NULL, argc and argv, the "return
+	** address", a context_t, and up to 16 bytes of alignment.  We
+	** want it to contain all zeroes to begin with, so we ask
+	** kmalloc() to clear it for us.
 	*/
 
-	char argstrings[ argbytes ];
-	char *argv[ argc + 1 ];
-
-	CLEAR( argstrings );
-	CLEAR( argv );
+	uint32_t len = argbytes + (argc + 5) * sizeof(uint32_t) + 16 +
+			sizeof(context_t);
 
-	// Next, duplicate the argument strings, and create pointers to
-	// each one in our argv.
-	char *tmp = argstrings;
-	for( int i = 0; i < argc; ++i ) {
-		int nb = __strlen(args[i]) + 1; // bytes (incl. NUL) in this string
-		__strcpy( tmp, args[i] );   // add to our buffer
-		argv[i] = tmp;              // remember where it was
-		tmp += nb;                  // move on
+	uint8_t *image = (uint8_t *) kmalloc( len, KM_ZERO );
+	if( image == NULL ) {
+		return( NULL );
 	}
 
-	// trailing NULL pointer
-	argv[argc] = NULL;
+	// where the beginning of the block will be on the stack
+	uint32_t base = top - len;
 
-#if TRACING_STACK
-	__cio_puts( "=== buffer: '" );
-	for( int i = 0; i < argbytes; ++i ) {
-		__put_char_or_code( argstrings[i] );
-	}
-	__cio_printf( "'\n=== _stk_setup, temp %d args (%d bytes):",
-			argc, argbytes );
-	for( int i = 0; i <= argc; ++i ) {
-		__cio_printf( " [%d] ", i );
-		if( argv[i] ) {
-			__cio_printf( "'%s'", argv[i] );
-		} else {
-			__cio_puts( "NULL" );
-		}
-	}
-	__cio_putchar( '\n' );
-#endif
-
-	// Now that we have duplicated the strings, we can clear out the
-	// old contents of the stack.
-	__memclr( stk, sizeof(stack_t) );
+	// where something on the stack is in the block
+#define	IMAGE(va)	((void *) (image + ((uint32_t) (va) - base)))
 
 	/*
 	** Set up the initial stack contents for a (new) user process.
@@ -303,10 +277,12 @@ context_t *_stk_setup( stack_t *stk, uint32_t entry, char *args[] )
 	** Stack alignment rules for the SysV ABI i386 supplement dictate that
 	** the 'argc' parameter must be at an address that is a multiple of 16;
 	** see below for more information.
+	**
+	** All the pointers below are stack addresses in the new process.
 	*/
 
 	// Pointer to the last word in stack.
-	uint32_t *ptr = ((uint32_t *)( stk + 1 )) - 1;
+	uint32_t *ptr = ((uint32_t *) top) - 1;
 
 	// Pointer to where the arg strings should be filled in.
 	char *strings = (char *) ( (uint32_t) ptr - argbytes );
@@ -316,9 +292,6 @@ context_t *_stk_setup( stack_t *stk, uint32_t entry, char *args[] )
 	// next smaller address whose low-order two bits are zeroes
 	strings = (char *) ((uint32_t) strings & 0xfffffffcU);
 
-	// Copy over the argv strings.
-	__memcpy( (void *)strings, argstrings, argbytes );
-
 	/*
 	** Next, we need to copy over the argv pointers.  Start by
 	** determining where 'argc' should go.
@@ -355,36 +328,32 @@ context_t *_stk_setup( stack_t *stk, uint32_t entry, char *args[] )
 	acptr = (uint32_t *) ( ((uint32_t)acptr) & 0xfffffff0 );
 
 	// copy in 'argc'
-	*acptr = argc;
+	*(uint32_t *) IMAGE(acptr) = argc;
 
 	// next, 'argv', which follows 'argc'; 'argv' points to the
 	// word that follows it in the stack
 	uint32_t *avptr = acptr + 2;
-	*(acptr+1) = (uint32_t) avptr;
+	*(uint32_t *) IMAGE(acptr+1) = (uint32_t) avptr;
 
-	/*
-	** Next, we copy in all argc+1 pointers.  This is complicated slightly
-	** by the need to adjust the pointers; they currently point into the
-	** local argstrings array.  We do this by adding the distance between
-	** the start of the argstrings array and the duplicate of that data on
-	** the stack.
-	*/
-
-	// Calculate the distance between the two argstring arrays.
-	int32_t distance = strings - &argstrings[0];
-
-	// Adjust and copy the string pointers.
-	for( int i = 0; i <= argc; ++i ) {
-		if( argv[i] != NULL ) {
-			// an actual pointer - adjust it and copy it in
-			*avptr = ((uint32_t) argv[i]) + distance;
-		} else {
-			// end of the line!
-			*avptr = NULL;
-		}
+	// Copy over the argv strings, and the pointers to them.
+	char *tmp = strings;
+	for( int i = 0; i < argc; ++i ) {
+		__strcpy( IMAGE(tmp), args[i] );
+		*(uint32_t *) IMAGE(avptr) = (uint32_t) tmp;
+		tmp += __strlen( args[i] ) + 1;
 		++avptr;
 	}
 
+	// the trailing NULL pointer is already there
+
+#if TRACING_STACK
+	__cio_puts( "=== buffer: '" );
+	for( int i = 0; i < argbytes; ++i ) {
+		__put_char_or_code( ((char *) IMAGE(strings))[i] );
+	}
+	__cio_puts( "'\n" );
+#endif
+
 	/*
 	** We now have to set up the stack so it looks like the user main()
 	** function was called from a 'startup' function. We do this by
@@ -395,7 +364,7 @@ context_t *_stk_setup( stack_t *stk, uint32_t entry, char *args[] )
 
 	// return address will be pushed right above 'argc' on the stack
 	avptr = acptr - 1;
-	*avptr = (uint32_t) fake_exit;
+	*(uint32_t *) IMAGE(avptr) = (uint32_t) fake_exit;
 
 	/*
 	** Now, we need to set up the initial context for the executing
@@ -411,18 +380,35 @@ context_t *_stk_setup( stack_t *stk, uint32_t entry, char *args[] )
 
 	// Locate the context save area on the stack.
 	context_t *ctx = ((context_t *) avptr) - 1;
+	context_t *c = (context_t *) IMAGE(ctx);
 
 	/*
-	** We cleared the entire stack earlier, so all the context
+	** The block started out all zeroes, so all the context
 	** fields currently contain zeroes.  We now need to fill in
 	** all the important fields.
 	*/
 
-	ctx->eflags = DEFAULT_EFLAGS;    // IE enabled, PPL 0
-	ctx->eip = entry;                // initial EIP
-	ctx->cs = GDT_CODE;              // segment registers
-	ctx->ss = GDT_STACK;
-	ctx->ds = ctx->es = ctx->fs = ctx->gs = GDT_DATA;
+	c->eflags = DEFAULT_EFLAGS;    // IE enabled, PPL 0
+	c->eip = entry;                // initial EIP
+	c->cs = GDT_CODE;              // segment registers
+	c->ss = GDT_STACK;
+	c->ds = c->es = c->fs = c->gs = GDT_DATA;
+
+	// it's also the ESP for the process
+	c->esp = (uint32_t) ctx;
+
+	// Put it all in place.
+	status_t status = _vm_copyout( pgdir, (uint32_t) ctx, c,
+			top - (uint32_t) ctx );
+
+	// we're done with our copy
+	kfree( image );
+
+#undef	IMAGE
+
+	if( status != S_OK ) {
+		return( NULL );
+	}
 
 	/*
 	** Return the new context pointer to the caller.  It will be our
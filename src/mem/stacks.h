@@ -11,8 +11,13 @@
 ** in the process module.
 **
 ** If compiled without that symbol, this module dynamically allocates
-** stacks for processes as needed, and keeps deallocated stacks in
-** a free list for quick re-use.
+** stacks for processes as needed, and returns deallocated stacks to
+** the page allocator, which zeroes them in the background so that
+** the next allocation doesn't have to.
+**
+** Process stacks themselves now belong to the process' address space
+** (see vm.h); this module lays out their initial contents, and
+** manages the stack the OS itself runs on.
 **
 ** Note: the dependencies for the non-static version are different
 ** due to its need for working dynamic storage.
@@ -29,7 +34,7 @@
 ** General (C and/or assembly) definitions
 */
 
-// stacks are 16KB
+// the OS stack is 16KB (process stacks are sized in vm.h)
 #define	PGS_PER_STACK	4
 #define	SZ_STACK		(PGS_PER_STACK * SZ_PAGE)
 #define	STACK_WORDS		(SZ_STACK / sizeof(uint32_t))
@@ -55,6 +60,10 @@ typedef uint32_t stack_t[STACK_WORDS];
 ** Globals
 */
 
+// the OS stack, and the initial stack pointer for it
+extern stack_t *_kstack;
+extern uint32_t *_kesp;
+
 /*
 ** Prototypes
 */
@@ -96,17 +105,19 @@ stack_t *_stk_alloc( void );
 void _stk_dealloc( stack_t *stk );
 
 /**
-** _stk_setup(stk,entry,args)
+** _stk_setup(pgdir,top,entry,args)
 **
-** Sets up the stack for a new process.
+** Sets up the stack for a new process (or thread).
 **
-** @param stk    - The stack to be set up
+** @param pgdir  - The address space whose stack is to be set up
+** @param top    - The top of the stack (see VM_SLOT_TOP())
 ** @param entry  - Entry point for the new process
 ** @param args   - Argument vector to be put in place
 **
 ** @return A pointer to the context_t on the stack, or NULL
 */
-context_t *_stk_setup( stack_t *stk, uint32_t entry, char *args[] );
+context_t *_stk_setup( pde_t *pgdir, uint32_t top, uint32_t entry,
+		char *args[] );
 
 /**
 ** _stk_dump(msg,stk,lim)
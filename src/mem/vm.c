@@ -0,0 +1,784 @@
+/**
+** @file	vm.c
+**
+** @brief	Virtual memory implementation
+**
+** Page directories and page tables are single pages from the page
+** allocator; as all physical memory is mapped at its own address in
+** every address space, the kernel can reach any of them (and any
+** process' stack page) directly.
+**
+** A shared stack page is read-only in every address space which maps
+** it, and is marked PG_COW; the page allocator's reference count says
+** how many address spaces that is.  The last one to write to it just
+** gets it back, writable.
+**
+** Stack pages are allocated when they are first touched.  A process
+** which faults on the guard page below its stack (or on a stack page
+** when no memory is left) is sent off to _vm_kill() instead of back
+** to the faulting instruction.
+**
+** Page faults are handled by a task of their own, with its own stack
+** (see isr_stubs.S), as the fault may have come from pushing onto
+** the stack which needs copying, or which isn't there yet.
+**
+** As processes run at privilege level 0, an interrupt pushes its
+** frame onto the process' stack, so that push can take the fault.
+** The CPU then restarts the interrupted instruction once the fault
+** is handled, but an external interrupt has already been taken from
+** the interrupt controller, and would be lost (and, never having
+** been acknowledged, would block everything of lower priority).  So
+** the fault handler looks for an interrupt in service while the
+** faulting code had interrupts enabled, which can only be one whose
+** delivery faulted, and delivers it itself.
+*/
+
+#define SP_KERNEL_SRC
+
+#include "common.h"
+
+#include "vm.h"
+
+#include "stacks.h"
+
+#include "bootstrap.h"
+#include "x86arch.h"
+#include "x86pic.h"
+#include "io/lapic.h"
+#include "kern/kernel.h"
+#include "kern/sched.h"
+
+/*
+** PRIVATE DEFINITIONS
+*/
+
+// CPUID leaf 1 feature bits:  4MB pages, and global pages
+#define CPUID_1_EDX_PSE		(1 << 3)
+#define CPUID_1_EDX_PGE		(1 << 13)
+
+// where the page fault task starts, and where it sends processes
+// which are to be killed (see isr_stubs.S)
+void __isr_page_fault_task( void );
+void __isr_vm_abort( void );
+
+// the first vectors the PICs deliver (see init_pic() in support.c)
+#define	VM_PIC_PRI_VEC	0x20
+#define	VM_PIC_SEC_VEC	0x28
+
+// is this per-process address in the room given to a stack, or in
+// the guard page below it?
+#define	IN_STACK(va)	(((va) & (VM_SLOT_SIZE - 1)) >= SZ_PAGE)
+
+/*
+** PRIVATE DATA TYPES
+*/
+
+/*
+** A 32-bit task state segment
+**
+** The CPU saves the state of the task being left here, and loads the
+** state of the task being entered from here - except for CR3, which
+** it loads but never saves.
+*/
+typedef struct tss_s {
+	uint32_t link;			// TSS selector of the task which called this one
+	uint32_t esp0, ss0;		// stacks for privilege level changes
+	uint32_t esp1, ss1;
+	uint32_t esp2, ss2;
+	uint32_t cr3;
+	uint32_t eip;
+	uint32_t eflags;
+	uint32_t eax, ecx, edx, ebx;
+	uint32_t esp, ebp, esi, edi;
+	uint32_t es, cs, ss, ds, fs, gs;
+	uint32_t ldt;
+	uint16_t trap;
+	uint16_t iomap;			// offset of the I/O permission bitmap
+} tss_t;
+
+/*
+** PRIVATE GLOBAL VARIABLES
+*/
+
+// the kernel's page directory:  the identity map, with no stack
+static pde_t *_vm_kpd;
+
+// the address space the CPU is using now
+static pde_t *_vm_cr3;
+
+// the running task, and the page fault task
+static tss_t _vm_tss_kern;
+static tss_t _vm_tss_fault;
+
+// why the fault handler last gave up on a process, and where
+static const char *_vm_why;
+static uint32_t _vm_where;
+
+/*
+** PRIVATE FUNCTIONS
+*/
+
+/**
+** Name:	_vm_gdt_tss
+**
+** Fill in the GDT entry describing a TSS
+**
+** @param sel   The entry's selector
+** @param tss   The TSS
+*/
+static void _vm_gdt_tss( uint32_t sel, tss_t *tss ) {
+	uint8_t *d = (uint8_t *) (GDT_ADDRESS + (sel & SEG_SEL_IX));
+	uint32_t base = (uint32_t) tss;
+	uint32_t limit = sizeof(tss_t) - 1;
+
+	d[0] = limit & 0xff;
+	d[1] = (limit >> 8) & 0xff;
+	d[2] = base & 0xff;
+	d[3] = (base >> 8) & 0xff;
+	d[4] = (base >> 16) & 0xff;
+	d[5] = SEG_ACCESS_P_BIT | SEG_DPL_0 | SEG_S_SYSTEM |
+			SEG_SYS_32BIT_TSS_AVAIL;
+	d[6] = SEG_GRAN_BYTE | ((limit >> 16) & SEG_SIZE_LIM_19_16);
+	d[7] = (base >> 24) & 0xff;
+}
+
+/**
+** Name:	_vm_pte
+**
+** Find the page table entry for a per-process address
+**
+** @param pgdir   The address space
+** @param va      The address
+**
+** @return the entry, or NULL if the address is not in the per-process
+**         region, or the address space has no such region
+*/
+static pte_t *_vm_pte( pde_t *pgdir, uint32_t va ) {
+
+	if( PD_INDEX(va) != PD_INDEX(VM_REGION) ||
+			(pgdir[PD_INDEX(va)] & PG_PRESENT) == 0 ) {
+		return NULL;
+	}
+
+	pte_t *pt = (pte_t *) (pgdir[PD_INDEX(va)] & PG_FRAME);
+
+	return &pt[PT_INDEX(va)];
+}
+
+/**
+** Name:	_vm_unshare
+**
+** Give an address space a private, writable copy of a shared page
+**
+** @param pte   The page's entry in that address space
+**
+** @return true on success, false if there wasn't enough memory
+*/
+static bool_t _vm_unshare( pte_t *pte ) {
+	void *page = (void *) (*pte & PG_FRAME);
+
+	// if nobody else has it any more, it's ours to write to
+	if( _km_page_refs(page) > 1 ) {
+		void *copy = _km_page_alloc( 1 );
+		if( copy == NULL ) {
+			return false;
+		}
+		__memcpy( copy, page, SZ_PAGE );
+		_km_page_free( page );
+		page = copy;
+	}
+
+	*pte = (uint32_t) page | PG_PRESENT | PG_WRITE;
+
+	return true;
+}
+
+/**
+** Name:	_vm_grow
+**
+** Give an address space a page where its stack hasn't been yet
+**
+** @param pte   The page's entry in that address space
+**
+** @return true on success, false if there wasn't enough memory
+*/
+static bool_t _vm_grow( pte_t *pte ) {
+	void *page = _km_page_alloc_flags( 1, KM_ZERO );
+
+	if( page == NULL ) {
+		return false;
+	}
+
+	*pte = (uint32_t) page | PG_PRESENT | PG_WRITE;
+
+	return true;
+}
+
+/**
+** Name:	_vm_lost_irq
+**
+** Find the external interrupt (if any) which the faulting task was
+** being interrupted by when it faulted.  The fault handler only asks
+** when the task had interrupts enabled; the OS never does while it is
+** handling an interrupt, so anything in service then must be one
+** whose delivery faulted.
+**
+** @return its vector, or -1 if there is none
+*/
+static int _vm_lost_irq( void ) {
+
+	// the local APIC's own interrupts (e.g., its timer)
+	if( _lapic != NULL ) {
+		for( int i = 7; i >= 0; --i ) {
+			uint32_t isr = LAPIC( LAPIC_REG_ISR + 0x10 * i );
+			if( isr != 0 ) {
+				return 32 * i + 31 - __builtin_clz( isr );
+			}
+		}
+	}
+
+	// then the PICs'; one on the secondary is in service on the
+	// primary's cascade line, too
+	__outb( PIC_PRI_CMD_PORT, PIC_READISR );
+	uint32_t pri = __inb( PIC_PRI_CMD_PORT );
+	__outb( PIC_PRI_CMD_PORT, PIC_READIRR );
+
+	if( (pri & PIC_PRI_SEC_LINE) != 0 ) {
+		__outb( PIC_SEC_CMD_PORT, PIC_READISR );
+		uint32_t sec = __inb( PIC_SEC_CMD_PORT );
+		__outb( PIC_SEC_CMD_PORT, PIC_READIRR );
+		if( sec != 0 ) {
+			return VM_PIC_SEC_VEC + __builtin_ctz( sec );
+		}
+	}
+
+	if( pri != 0 ) {
+		return VM_PIC_PRI_VEC + __builtin_ctz( pri );
+	}
+
+	return -1;
+}
+
+/**
+** Name:	_vm_redeliver
+**
+** After a page fault has been dealt with, make sure an external
+** interrupt whose delivery took the fault isn't lost:  push the frame
+** the CPU couldn't, and send the faulting task to the interrupt's
+** isr stub, with interrupts disabled, as the CPU would have.  If it
+** can't be delivered (the process is going away, or there's no
+** memory for the frame), it is at least acknowledged, so it doesn't
+** block the ones behind it.
+**
+** @param deliver  Whether the faulting task will carry on
+**
+** @return true on success (or if there was nothing to deliver), false
+**         if the interrupt had to be dropped
+*/
+static bool_t _vm_redeliver( bool_t deliver ) {
+
+	if( (_vm_tss_kern.eflags & EFLAGS_IF) == 0 ) {
+		return true;
+	}
+
+	int vector = _vm_lost_irq();
+	if( vector < 0 ) {
+		return true;
+	}
+
+	// EIP, CS and EFLAGS, from the lowest address up
+	uint32_t frame[3] = {
+		_vm_tss_kern.eip, _vm_tss_kern.cs, _vm_tss_kern.eflags
+	};
+	uint32_t esp = _vm_tss_kern.esp - sizeof(frame);
+
+	if( !deliver ||
+			_vm_copyout(_vm_cr3,esp,frame,sizeof(frame)) != S_OK ) {
+		if( vector >= VM_PIC_PRI_VEC && vector < VM_PIC_SEC_VEC + 8 ) {
+			if( vector >= VM_PIC_SEC_VEC ) {
+				__outb( PIC_SEC_CMD_PORT, PIC_EOI );
+			}
+			__outb( PIC_PRI_CMD_PORT, PIC_EOI );
+		} else {
+			LAPIC_ACK();
+		}
+		return false;
+	}
+
+	_vm_tss_kern.esp = esp;
+	_vm_tss_kern.eip = __isr_stub( vector );
+	_vm_tss_kern.eflags &= ~(EFLAGS_IF | EFLAGS_TF);
+
+	return true;
+}
+
+/**
+** Name:	_vm_fpu
+**
+** ISR for "device not available" exceptions.  Every task switch sets
+** CR0.TS, after which the first FPU instruction raises one of these;
+** we don't keep any FPU state, so we just clear TS again.
+**
+** @param vector   Vector number for the interrupt
+** @param code     Error code (0 for this interrupt)
+*/
+static void _vm_fpu( int vector, int code ) {
+	(void) vector;
+	(void) code;
+
+	__set_cr0( __get_cr0() & ~CR0_TS );
+}
+
+/*
+** PUBLIC FUNCTIONS
+*/
+
+/**
+** Name:	_vm_init
+**
+** Build the kernel's page directory, set up the page fault handler,
+** and turn on paging
+**
+** Dependencies:
+**    Must be called after kmem is initialized
+**    Must be called before any process creation is done
+*/
+void _vm_init( void ) {
+	unsigned int regs[4];
+
+	// the identity map is made of 4MB pages
+	__cpuid( 1, regs );
+	assert( (regs[3] & CPUID_1_EDX_PSE) != 0 );
+
+	// it never changes, so it may as well stay in the TLB
+	uint32_t global = 0;
+	if( (regs[3] & CPUID_1_EDX_PGE) != 0 ) {
+		global = PG_GLOBAL;
+	}
+
+	_vm_kpd = (pde_t *) _km_page_alloc_flags( 1, KM_ZERO );
+	assert( _vm_kpd != NULL );
+
+	for( uint32_t i = 0; i < VM_ENTRIES; ++i ) {
+		if( i == PD_INDEX(VM_REGION) ) {
+			continue;
+		}
+		_vm_kpd[i] = (i * SZ_LARGE) | PG_PRESENT | PG_WRITE |
+				PG_LARGE | global;
+		// above the region, there's nothing but devices and firmware
+		if( i > PD_INDEX(VM_REGION) ) {
+			_vm_kpd[i] |= PG_NOCACHE;
+		}
+	}
+
+	/*
+	** The page fault task runs on a stack of its own, with
+	** interrupts disabled, in the kernel's address space.
+	*/
+
+	uint8_t *stack = (uint8_t *) _km_page_alloc( 1 );
+	assert( stack != NULL );
+
+	_vm_tss_fault.cr3 = (uint32_t) _vm_kpd;
+	_vm_tss_fault.eip = (uint32_t) __isr_page_fault_task;
+	_vm_tss_fault.eflags = EFLAGS_MB1;
+	_vm_tss_fault.esp = (uint32_t) (stack + SZ_PAGE);
+	_vm_tss_fault.cs = GDT_CODE;
+	_vm_tss_fault.ss = GDT_STACK;
+	_vm_tss_fault.ds = _vm_tss_fault.es = GDT_DATA;
+	_vm_tss_fault.fs = _vm_tss_fault.gs = GDT_DATA;
+	_vm_tss_fault.iomap = sizeof(tss_t);
+
+	// whatever is running is the task the faults come from
+	_vm_tss_kern.iomap = sizeof(tss_t);
+
+	_vm_gdt_tss( GDT_TSS_KERN, &_vm_tss_kern );
+	_vm_gdt_tss( GDT_TSS_FAULT, &_vm_tss_fault );
+	__ltr( GDT_TSS_KERN );
+
+	__install_task_gate( INT_VEC_PAGE_FAULT, GDT_TSS_FAULT );
+	__install_isr( INT_VEC_DEVICE_NOT_AVAILABLE, _vm_fpu );
+
+	// turn on paging; with CR0.WP, the kernel can't write to
+	// read-only pages either
+	__set_cr4( __get_cr4() | CR4_PSE | (global ? CR4_PGE : 0) );
+	_vm_switch( _vm_kpd );
+	__set_cr0( __get_cr0() | CR0_PG | CR0_WP );
+
+	__cio_puts( " VM" );
+}
+
+/**
+** Name:	_vm_create
+**
+** Create a new address space, with an empty stack
+**
+** @return its page directory, or NULL if there wasn't enough memory
+*/
+pde_t *_vm_create( void ) {
+
+	pde_t *pgdir = (pde_t *) _km_page_alloc( 1 );
+	if( pgdir == NULL ) {
+		return NULL;
+	}
+
+	pte_t *pt = (pte_t *) _km_page_alloc_flags( 1, KM_ZERO );
+	if( pt == NULL ) {
+		_km_page_free( pgdir );
+		return NULL;
+	}
+
+	// the stack pages come later, as they are touched
+	__memcpy( pgdir, _vm_kpd, SZ_PAGE );
+	pgdir[PD_INDEX(VM_REGION)] = (uint32_t) pt | PG_PRESENT | PG_WRITE;
+
+	return pgdir;
+}
+
+/**
+** Name:	_vm_fork
+**
+** Duplicate an address space; the stack pages are shared, copy on
+** write, by the two copies
+**
+** @param pgdir   The address space to duplicate
+**
+** @return the new page directory, or NULL if there wasn't enough memory
+*/
+pde_t *_vm_fork( pde_t *pgdir ) {
+
+	pde_t *new = (pde_t *) _km_page_alloc( 1 );
+	if( new == NULL ) {
+		return NULL;
+	}
+
+	pte_t *pt = (pte_t *) _km_page_alloc( 1 );
+	if( pt == NULL ) {
+		_km_page_free( new );
+		return NULL;
+	}
+
+	__memcpy( new, _vm_kpd, SZ_PAGE );
+	new[PD_INDEX(VM_REGION)] = (uint32_t) pt | PG_PRESENT | PG_WRITE;
+
+	// both copies get the same pages, and neither may write to them
+	pte_t *old = (pte_t *) (pgdir[PD_INDEX(VM_REGION)] & PG_FRAME);
+	for( uint32_t i = 0; i < VM_ENTRIES; ++i ) {
+		if( (old[i] & PG_PRESENT) != 0 ) {
+			if( (old[i] & PG_WRITE) != 0 ) {
+				old[i] = (old[i] & ~PG_WRITE) | PG_COW;
+			}
+			_km_page_share( (void *) (old[i] & PG_FRAME) );
+		}
+		pt[i] = old[i];
+	}
+
+	// the TLB may still say the original is writable
+	if( pgdir == _vm_cr3 ) {
+		__set_cr3( (uint32_t) pgdir );
+	}
+
+	return new;
+}
+
+/**
+** Name:	_vm_free
+**
+** Release an address space and everything in it
+**
+** @param pgdir   The address space
+*/
+void _vm_free( pde_t *pgdir ) {
+
+	assert1( pgdir != NULL && pgdir != _vm_kpd );
+
+	// we can't release the page directory we're using
+	if( pgdir == _vm_cr3 ) {
+		_vm_switch( _vm_kpd );
+	}
+
+	pte_t *pt = (pte_t *) (pgdir[PD_INDEX(VM_REGION)] & PG_FRAME);
+	for( uint32_t i = 0; i < VM_ENTRIES; ++i ) {
+		if( (pt[i] & PG_PRESENT) != 0 ) {
+			_km_page_free( (void *) (pt[i] & PG_FRAME) );
+		}
+	}
+
+	_km_page_free( pt );
+	_km_page_free( pgdir );
+}
+
+/**
+** Name:	_vm_slot_free
+**
+** Release the stack pages in one slot of an address space
+**
+** @param pgdir   The address space
+** @param slot    The slot
+*/
+void _vm_slot_free( pde_t *pgdir, uint32_t slot ) {
+
+	assert1( slot < VM_SLOTS );
+
+	pte_t *pt = (pte_t *) (pgdir[PD_INDEX(VM_REGION)] & PG_FRAME);
+	uint32_t first = PT_INDEX(VM_SLOT_TOP(slot) - VM_SLOT_SIZE);
+
+	for( uint32_t i = first; i < first + VM_SLOT_SIZE / SZ_PAGE; ++i ) {
+		if( (pt[i] & PG_PRESENT) != 0 ) {
+			_km_page_free( (void *) (pt[i] & PG_FRAME) );
+		}
+		pt[i] = 0;
+	}
+
+	// the other threads may still be using this address space
+	if( pgdir == _vm_cr3 ) {
+		__set_cr3( (uint32_t) pgdir );
+	}
+}
+
+/**
+** Name:	_vm_switch
+**
+** Make an address space the current one
+**
+** @param pgdir   The address space
+*/
+void _vm_switch( pde_t *pgdir ) {
+
+	if( pgdir != _vm_cr3 ) {
+		_vm_cr3 = pgdir;
+		// the CPU won't save this when a page fault switches tasks
+		_vm_tss_kern.cr3 = (uint32_t) pgdir;
+		__set_cr3( (uint32_t) pgdir );
+	}
+}
+
+/**
+** Name:	_vm_access
+**
+** Find an address in some address space, as the kernel can reach it
+** from any address space.  For a write, a shared page is unshared
+** first, and a stack page which hasn't been touched yet is allocated.
+**
+** @param pgdir   The address space
+** @param va      The address in that space
+** @param write   Will the caller be writing there?
+**
+** @return the kernel's address for it, or NULL if it isn't mapped
+**         (or couldn't be)
+*/
+void *_vm_access( pde_t *pgdir, uint32_t va, bool_t write ) {
+
+	// everything outside the per-process region is the same everywhere
+	if( PD_INDEX(va) != PD_INDEX(VM_REGION) ) {
+		return (void *) va;
+	}
+
+	pte_t *pte = _vm_pte( pgdir, va );
+	if( pte == NULL ) {
+		return NULL;
+	}
+
+	// reading an untouched stack page would only find zeroes, but
+	// writing one means it's time to allocate it
+	if( (*pte & PG_PRESENT) == 0 ) {
+		if( !write || !IN_STACK(va) || !_vm_grow(pte) ) {
+			return NULL;
+		}
+	} else if( write && (*pte & PG_COW) != 0 ) {
+		if( !_vm_unshare(pte) ) {
+			return NULL;
+		}
+		if( pgdir == _vm_cr3 ) {
+			__invlpg( va );
+		}
+	}
+
+	return (void *) ((*pte & PG_FRAME) | (va & (SZ_PAGE - 1)));
+}
+
+/**
+** Name:	_vm_context
+**
+** Find a word of a process' saved context (for VM_RET() and friends)
+**
+** @param pgdir   The process' address space
+** @param va      The word's address in that space
+** @param write   Will the caller be writing there?
+**
+** @return the kernel's address for it
+*/
+uint32_t *_vm_context( pde_t *pgdir, uint32_t va, bool_t write ) {
+	uint32_t *word = _vm_access( pgdir, va, write );
+
+	// see vm.h for why this can't fail
+	assert( word != NULL );
+
+	return word;
+}
+
+/**
+** Name:	_vm_copyin
+**
+** Copy data out of some address space
+**
+** @param pgdir   The address space
+** @param va      Where the data is in that space
+** @param buf     Where to put it
+** @param len     How many bytes to copy
+**
+** @return S_OK, or S_BAD_PARAM if part of the data wasn't mapped
+*/
+status_t _vm_copyin( pde_t *pgdir, uint32_t va, void *buf, uint32_t len ) {
+	uint8_t *dst = (uint8_t *) buf;
+
+	while( len > 0 ) {
+		// one page at a time
+		uint32_t n = SZ_PAGE - (va & (SZ_PAGE - 1));
+		if( n > len ) {
+			n = len;
+		}
+		void *src = _vm_access( pgdir, va, false );
+		if( src == NULL ) {
+			return S_BAD_PARAM;
+		}
+		__memcpy( dst, src, n );
+		dst += n;
+		va += n;
+		len -= n;
+	}
+
+	return S_OK;
+}
+
+/**
+** Name:	_vm_copyout
+**
+** Copy data into some address space
+**
+** @param pgdir   The address space
+** @param va      Where the data goes in that space
+** @param buf     The data
+** @param len     How many bytes to copy
+**
+** @return S_OK, or S_BAD_PARAM if part of the range wasn't mapped
+*/
+status_t _vm_copyout( pde_t *pgdir, uint32_t va, const void *buf,
+		uint32_t len ) {
+	const uint8_t *src = (const uint8_t *) buf;
+
+	while( len > 0 ) {
+		// one page at a time
+		uint32_t n = SZ_PAGE - (va & (SZ_PAGE - 1));
+		if( n > len ) {
+			n = len;
+		}
+		void *dst = _vm_access( pgdir, va, true );
+		if( dst == NULL ) {
+			return S_BAD_PARAM;
+		}
+		__memcpy( dst, src, n );
+		src += n;
+		va += n;
+		len -= n;
+	}
+
+	return S_OK;
+}
+
+/**
+** Name:	_vm_fault
+**
+** Page fault handler; runs as a task of its own (see isr_stubs.S)
+**
+** This runs in the kernel's address space, not the faulting one;
+** the CPU flushes the TLB when it switches back, so the faulting
+** task will see whatever we change.
+**
+** @param code   The error code for the fault
+*/
+void _vm_fault( uint32_t code ) {
+	uint32_t va = __get_cr2();
+	pte_t *pte = _vm_pte( _vm_cr3, va );
+
+	_vm_why = NULL;
+
+	if( pte != NULL && (code & PF_PRESENT) == 0 && IN_STACK(va) ) {
+
+		// the stack has grown into a page it hasn't used before
+		if( !_vm_grow(pte) ) {
+			_vm_why = "no memory to grow the stack";
+		}
+
+	} else if( pte != NULL && (code & PF_WRITE) != 0 &&
+			(*pte & PG_COW) != 0 ) {
+
+		// a write to a shared page
+		if( !_vm_unshare(pte) ) {
+			_vm_why = "no memory for a copy-on-write page";
+		}
+
+	} else if( pte != NULL && !IN_STACK(va) ) {
+
+		// it ran off the bottom of its stack
+		_vm_why = "stack overflow";
+
+	} else {
+
+		// not something a process can cause
+		_vm_why = "";
+	}
+
+	// the fault may have kept an interrupt from being delivered
+	if( !_vm_redeliver(_vm_why == NULL) && _vm_why == NULL ) {
+		_vm_why = "no memory for an interrupt frame";
+	}
+
+	if( _vm_why == NULL ) {
+		return;
+	}
+
+	/*
+	** If a process did this on its own stack (rather than the OS
+	** doing it on the process' behalf), the process can just go.
+	** Instead of retrying the instruction, it resumes in
+	** __isr_vm_abort, on the OS stack, with interrupts off.
+	*/
+
+	if( *_vm_why != '\0' && _current != NULL &&
+			PD_INDEX(_vm_tss_kern.esp) == PD_INDEX(VM_REGION) ) {
+		_vm_where = va;
+		_vm_tss_kern.eip = (uint32_t) __isr_vm_abort;
+		_vm_tss_kern.esp = (uint32_t) _kesp;
+		_vm_tss_kern.eflags = EFLAGS_MB1;
+		return;
+	}
+
+	// anything else is a bug
+	if( *_vm_why != '\0' ) {
+		__cio_printf( "\n*** %s", _vm_why );
+	}
+	__cio_printf( "\n*** page fault at %08x, code %x, EIP %08x, pid %d\n",
+			va, code, _vm_tss_kern.eip,
+			_current == NULL ? -1 : (int) _current->pid );
+	_kpanic( "page fault" );
+}
+
+/**
+** Name:	_vm_kill
+**
+** Get rid of the current process after a page fault it can't recover
+** from; the fault handler sends the process here (see isr_stubs.S),
+** on the OS stack
+*/
+void _vm_kill( void ) {
+
+	__sprint( _b256, "pid %d killed: %s at %08x", _current->pid,
+			_vm_why, _vm_where );
+	WARNING( _b256 );
+
+	_current->exit_status = EXIT_KILLED;
+	_pcb_zombify( _current );
+
+	_dispatch();
+}
@@ -0,0 +1,246 @@
+/**
+** @file	vm.h
+**
+** @brief	Virtual memory declarations
+**
+** Every process has a page directory of its own.  All of them map
+** the whole 4GB address space onto itself with 4MB pages (everything
+** runs at privilege level 0, so there is nothing to protect there),
+** except for one 4MB region at KM_LIMIT, which has a page table of
+** its own in each address space.  Each process' stack lives at the
+** top of that region, so its stack is at the same address in every
+** process.
+**
+** The region is divided into VM_SLOTS slots, one for the stack of
+** each of a process' threads; the first thread's stack is in slot 0,
+** at the top.  A stack is given room to grow to VM_STACK_PAGES pages,
+** but a page is only allocated the first time it is touched, by the
+** page fault handler.  The lowest page of each slot is never mapped;
+** a thread which runs into it has overflowed its stack, and is killed.
+**
+** fork() shares the parent's stack pages with the child, marking them
+** read-only in both; the first write to one of them takes a page
+** fault, and the handler gives the writer a private copy.
+*/
+
+#ifndef VM_H_
+#define VM_H_
+
+#include "common.h"
+
+#include "kmem.h"
+
+/*
+** General (C and/or assembly) definitions
+*/
+
+// page directory and page table entry bits
+#define	PG_PRESENT		0x001
+#define	PG_WRITE		0x002
+#define	PG_NOCACHE		0x018	// cache disable and write-through
+#define	PG_LARGE		0x080	// (directory entries) maps a 4MB page
+#define	PG_GLOBAL		0x100	// survives CR3 reloads
+#define	PG_COW			0x200	// (ours) shared, copy on write
+
+#define	PG_FRAME		0xfffff000
+
+// page fault error code bits
+#define	PF_PRESENT		0x1		// the page was present
+#define	PF_WRITE		0x2		// the access was a write
+
+// entries per page directory and per page table
+#define	VM_ENTRIES		1024
+
+// size of the region mapped by one page directory entry
+#define	SZ_LARGE		(VM_ENTRIES * SZ_PAGE)
+
+// indices into a page directory, and into a page table
+#define	PD_INDEX(va)	(((uint32_t) (va)) >> 22)
+#define	PT_INDEX(va)	((((uint32_t) (va)) >> 12) & (VM_ENTRIES - 1))
+
+// the per-process region, and the stack slots in it
+#define	VM_REGION		KM_LIMIT
+#define	VM_SLOTS		8
+#define	VM_SLOT_SIZE	(SZ_LARGE / VM_SLOTS)
+#define	VM_STACK_PAGES	(VM_SLOT_SIZE / SZ_PAGE - 1)	// less the guard page
+#define	VM_STACK_TOP	(VM_REGION + SZ_LARGE)
+#define	VM_SLOT_TOP(n)	(VM_STACK_TOP - (n) * VM_SLOT_SIZE)
+
+#ifndef SP_ASM_SRC
+
+/*
+** Start of C-only definitions
+*/
+
+// RET(), ARG() and REG() (see kdefs.h) for a process whose address
+// space may not be the current one (see _vm_context() for when they
+// may be used)
+#define	VM_RET(pcb)		(*_vm_context( (pcb)->proc->pgdir, \
+							(uint32_t) &RET(pcb), true ))
+#define	VM_ARG(pcb,n)	(*_vm_context( (pcb)->proc->pgdir, \
+							(uint32_t) &ARG(pcb,n), false ))
+#define	VM_REG(pcb,x)	(*_vm_context( (pcb)->proc->pgdir, \
+							(uint32_t) &REG(pcb,x), false ))
+
+/*
+** Types
+*/
+
+typedef uint32_t pde_t;		// page directory entry
+typedef uint32_t pte_t;		// page table entry
+
+/*
+** Globals
+*/
+
+/*
+** Prototypes
+*/
+
+/**
+** Name:	_vm_init
+**
+** Build the kernel's page directory, set up the page fault handler,
+** and turn on paging
+**
+** Dependencies:
+**    Must be called after kmem is initialized
+**    Must be called before any process creation is done
+*/
+void _vm_init( void );
+
+/**
+** Name:	_vm_create
+**
+** Create a new address space, with an empty stack
+**
+** @return its page directory, or NULL if there wasn't enough memory
+*/
+pde_t *_vm_create( void );
+
+/**
+** Name:	_vm_fork
+**
+** Duplicate an address space; the stack pages are shared, copy on
+** write, by the two copies
+**
+** @param pgdir   The address space to duplicate
+**
+** @return the new page directory, or NULL if there wasn't enough memory
+*/
+pde_t *_vm_fork( pde_t *pgdir );
+
+/**
+** Name:	_vm_free
+**
+** Release an address space and everything in it
+**
+** @param pgdir   The address space
+*/
+void _vm_free( pde_t *pgdir );
+
+/**
+** Name:	_vm_slot_free
+**
+** Release the stack pages in one slot of an address space
+**
+** @param pgdir   The address space
+** @param slot    The slot
+*/
+void _vm_slot_free( pde_t *pgdir, uint32_t slot );
+
+/**
+** Name:	_vm_switch
+**
+** Make an address space the current one
+**
+** @param pgdir   The address space
+*/
+void _vm_switch( pde_t *pgdir );
+
+/**
+** Name:	_vm_access
+**
+** Find an address in some address space, as the kernel can reach it
+** from any address space.  For a write, a shared page is unshared
+** first, and a stack page which hasn't been touched yet is allocated.
+**
+** @param pgdir   The address space
+** @param va      The address in that space
+** @param write   Will the caller be writing there?
+**
+** @return the kernel's address for it, or NULL if it isn't mapped
+**         (or couldn't be)
+*/
+void *_vm_access( pde_t *pgdir, uint32_t va, bool_t write );
+
+/**
+** Name:	_vm_context
+**
+** Find a word of a process' saved context (for VM_RET() and friends).
+** The context was pushed onto the process' stack, so it is mapped and
+** the page it is on was the process' own.  Another process can only
+** come to share that page through a fork() of this one (a thread's
+** fork() child drops the other threads' stacks at once), so until
+** then, writing there never needs memory.  The one write that can
+** (the return value of a fork() child) uses _vm_access() instead.
+**
+** @param pgdir   The process' address space
+** @param va      The word's address in that space
+** @param write   Will the caller be writing there?
+**
+** @return the kernel's address for it
+*/
+uint32_t *_vm_context( pde_t *pgdir, uint32_t va, bool_t write );
+
+/**
+** Name:	_vm_copyin
+**
+** Copy data out of some address space
+**
+** @param pgdir   The address space
+** @param va      Where the data is in that space
+** @param buf     Where to put it
+** @param len     How many bytes to copy
+**
+** @return S_OK, or S_BAD_PARAM if part of the data wasn't mapped
+*/
+status_t _vm_copyin( pde_t *pgdir, uint32_t va, void *buf, uint32_t len );
+
+/**
+** Name:	_vm_copyout
+**
+** Copy data into some address space
+**
+** @param pgdir   The address space
+** @param va      Where the data goes in that space
+** @param buf     The data
+** @param len     How many bytes to copy
+**
+** @return S_OK, or S_BAD_PARAM if part of the range wasn't mapped
+*/
+status_t _vm_copyout( pde_t *pgdir, uint32_t va, const void *buf,
+		uint32_t len );
+
+/**
+** Name:	_vm_fault
+**
+** Page fault handler; runs as a task of its own (see isr_stubs.S)
+**
+** @param code   The error code for the fault
+*/
+void _vm_fault( uint32_t code );
+
+/**
+** Name:	_vm_kill
+**
+** Get rid of the current process after a page fault it can't recover
+** from; the fault handler sends the process here (see isr_stubs.S),
+** on the OS stack
+*/
+void _vm_kill( void );
+
+#endif
+// !SP_ASM_SRC
+
+#endif
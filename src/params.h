@@ -6,9 +6,9 @@
 ** @brief	System configuration settings
 **
 ** This header file contains many of the "easily tunable" system
-** settings, such as clock rate, number of simultaneous user
-** processes, etc. This provides a sort of "one-stop shop" for
-** things that might be tweaked frequently.
+** settings, such as clock rate, size of the process tables, etc.
+** This provides a sort of "one-stop shop" for things that might be
+** tweaked frequently.
 */
 
 #ifndef PARAMS_H_
@@ -18,15 +18,22 @@
 ** General (C and/or assembly) definitions
 */
 
-// Upper bound on the number of simultaneous user-level
-// processes in the system (completely arbitrary)
+// Number of simultaneous processes the process tables are sized
+// for.  This is not a limit (PCBs come from a slab cache, so only
+// memory limits how many there can be); it is the number of chains
+// in the PID hash table, and the size of the scheduler's tables until
+// they have to grow.  Must be a power of two.
 
-#define N_PROCS		25
+#define N_PROCS		32
 
 // PID of the initial user process
 
 #define	PID_INIT	1
 
+// PID of the (kernel) idle process
+
+#define	PID_IDLE	0
+
 // First PID value assigned when processes are created
 // at user-level (i.e., not created directly by the OS).
 
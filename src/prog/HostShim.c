@@ -0,0 +1,123 @@
+/*
+** File:    HostShim.c
+**
+** Description:     Host-side services for the HostTest program
+**
+** Stands in for the parts of the kernel that the modules under test
+** expect to find:  console output goes to stdout, _kpanic() aborts,
+** and the "BIOS" memory map describes a single arena obtained from
+** the host's allocator.  This is the only HostTest source file which
+** is compiled against the host's headers; see HostShim.h.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "HostShim.h"
+
+/*
+** Layout of the memory map that _km_init() reads (see kmem.c):
+** a 32-bit entry count followed by the region descriptors
+*/
+
+typedef struct {
+	uint64_t base;
+	uint64_t length;
+	uint32_t type;
+	uint32_t acpi;
+} __attribute__((packed)) host_region_t;
+
+typedef struct {
+	int32_t entries;
+	host_region_t regions[1];
+} host_mmap_t;
+
+static host_mmap_t _map;
+
+/*
+** Kernel globals the modules under test refer to
+*/
+
+int32_t *_host_mmap = &_map.entries;
+
+uint32_t _system_time;
+
+char _b256[256];
+char _b512[512];
+
+/*
+** Console and panic routines
+*/
+
+void __cio_putchar( unsigned int c ) {
+	putchar( c );
+}
+
+void __cio_puts( const char *str ) {
+	fputs( str, stdout );
+}
+
+/*
+** The kernel's format directives (%d, %u, %x, %o, %c, %s, with
+** widths and '-') are a subset of printf()'s
+*/
+void __cio_printf( char *fmt, ... ) {
+	va_list ap;
+
+	va_start( ap, fmt );
+	vprintf( fmt, ap );
+	va_end( ap );
+}
+
+void _kpanic( const char *msg ) {
+	fflush( stdout );
+	fprintf( stderr, "\n*** PANIC: %s\n", msg );
+	abort();
+}
+
+/*
+** Services for HostTest itself
+*/
+
+void _host_init( unsigned int bytes ) {
+	void *arena;
+
+	if( posix_memalign(&arena,4096,bytes) != 0 ) {
+		fprintf( stderr, "can't allocate a %u-byte arena\n", bytes );
+		exit( 1 );
+	}
+
+	// region type 1 is "usable"; ACPI bit 0 set means "don't ignore"
+	_map.entries = 1;
+	_map.regions[0].base = (uint32_t) arena;
+	_map.regions[0].length = bytes;
+	_map.regions[0].type = 1;
+	_map.regions[0].acpi = 1;
+
+	// make the output order match the order things happen in
+	setvbuf( stdout, NULL, _IONBF, 0 );
+}
+
+unsigned long long _host_ns( void ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return( ts.tv_sec * 1000000000ULL + ts.tv_nsec );
+}
+
+void _host_report( const char *name, unsigned int ops,
+		unsigned long long ns ) {
+	double secs = ns / 1e9;
+
+	printf( "  %-28s %10u ops %9.3f ms %14.0f ops/sec\n",
+			name, ops, ns / 1e6, secs > 0 ? ops / secs : 0.0 );
+}
+
+void _host_exit( int status ) {
+	exit( status );
+}
@@ -0,0 +1,56 @@
+/*
+** File:    HostShim.h
+**
+** Description:     Host-side services for the HostTest program
+**
+** HostTest links the kernel's allocators and data structures into an
+** ordinary 32-bit Linux program.  HostShim.c is the only part of it
+** that uses the host's C library; it also supplies the kernel symbols
+** (console output, _kpanic(), the BIOS memory map, etc.) that those
+** modules expect.  Only plain C types are used here, so that this
+** header can be included on either side.
+*/
+
+#ifndef HOSTSHIM_H_
+#define HOSTSHIM_H_
+
+/*
+** Name:    _host_init
+**
+** Reserve an arena of the given size for the page allocator and
+** describe it in the memory map that _km_init() will read.
+**
+** @param bytes  Size of the arena
+*/
+void _host_init( unsigned int bytes );
+
+/*
+** Name:    _host_ns
+**
+** @return a monotonic timestamp, in nanoseconds
+*/
+unsigned long long _host_ns( void );
+
+/*
+** Name:    _host_report
+**
+** Print one benchmark result, including its rate in operations
+** per second (done here because it needs floating point)
+**
+** @param name  What was measured
+** @param ops   How many operations were performed
+** @param ns    How long they took, in nanoseconds
+*/
+void _host_report( const char *name, unsigned int ops,
+		unsigned long long ns );
+
+/*
+** Name:    _host_exit
+**
+** Terminate the program
+**
+** @param status  The exit status
+*/
+void _host_exit( int status );
+
+#endif
@@ -0,0 +1,665 @@
+/*
+** File:    HostTest.c
+**
+** Description:     Host-side tests and benchmarks for the kernel's
+**                  allocators and data structures
+**
+** This program is built by "make hosttest" from kmem.c, slab_cache.c,
+** queues.c, timer.c, kstring.c and the kernel's libc.c, compiled exactly as
+** they are for the kernel (plus -DHOST_TEST and optimization), and
+** linked with HostShim.c into an ordinary 32-bit Linux program.  It
+** runs a set of checks on each module, then times the common
+** operations and reports them in operations per second.
+**
+** Everything here is kernel code and uses only kernel headers; the
+** host's C library is reached only through HostShim.h.
+*/
+
+#define SP_KERNEL_SRC
+
+#include "common.h"
+
+#include "kern/kernel.h"
+#include "kern/clock.h"
+#include "kern/timer.h"
+#include "mem/kmem.h"
+#include "util/slab_cache.h"
+#include "util/queues.h"
+#include "util/kstring.h"
+
+#include "HostShim.h"
+
+/*
+** PRIVATE DEFINITIONS
+*/
+
+// how much memory the page allocator gets to manage
+#define ARENA_SIZE      (64 * 1024 * 1024)
+
+// iteration counts for the benchmarks
+#define BENCH_OPS       1000000
+#define BENCH_PAGE_OPS  200000
+#define BENCH_BATCH     64
+
+// record the outcome of one check, complaining if it failed
+#define CHECK(x)   do { \
+		++_checks; \
+		if( !(x) ) { \
+			++_failures; \
+			__cio_printf( "  FAIL %s:%d: %s\n", __FILE__, __LINE__, #x ); \
+		} \
+	} while( 0 )
+
+/*
+** PRIVATE GLOBAL VARIABLES
+*/
+
+static uint32_t _checks;
+static uint32_t _failures;
+
+// constructor/destructor call counts for the slab tests
+static uint32_t _ctor_calls;
+static uint32_t _dtor_calls;
+
+// defeats dead-code elimination in the benchmarks
+static volatile uint32_t _sink;
+
+/*
+** PRIVATE FUNCTIONS
+*/
+
+/**
+** Name:    _contains
+**
+** @return true if 'needle' occurs in 'haystack'
+*/
+static bool_t _contains( const char *haystack, const char *needle ) {
+	uint32_t len = __strlen( needle );
+
+	for( ; *haystack; ++haystack ) {
+		if( __memcmp(haystack,needle,len) == 0 ) {
+			return( true );
+		}
+	}
+
+	return( false );
+}
+
+static void _test_ctor( void *elem ) {
+	*(uint32_t *) elem = 0xc0ffee;
+	++_ctor_calls;
+}
+
+static void _test_dtor( void *elem ) {
+	(void) elem;
+	++_dtor_calls;
+}
+
+static int _cmp_int( void *a, void *b ) {
+	return( (int) a - (int) b );
+}
+
+// an entry for the intrusive queue tests
+typedef struct {
+	int value;
+	qlink_t link;
+} item_t;
+
+static int _cmp_item( void *a, void *b ) {
+	return( ((item_t *) a)->value - ((item_t *) b)->value );
+}
+
+/*
+** TESTS
+*/
+
+static void _test_kmem( void ) {
+	kpage_t info;
+
+	__cio_puts( "kmem\n" );
+
+	uint8_t *block = _km_page_alloc( 3 );
+	CHECK( block != NULL );
+	CHECK( ((uint32_t) block & (SZ_PAGE - 1)) == 0 );
+	CHECK( _km_page_lookup(block + 2 * SZ_PAGE + 17,&info) == block );
+	CHECK( info.pages == 3 );
+	// the tail of the rounded-up block went back to the free pool
+	CHECK( _km_page_lookup(block + 3 * SZ_PAGE,NULL) == NULL );
+
+	// dirty it, give it back, and make sure KM_ZERO cleans it up
+	__memset( block, 3 * SZ_PAGE, 0xa5 );
+	_km_page_free( block );
+	CHECK( _km_page_lookup(block,NULL) == NULL );
+
+	// a shared page survives until every holder has freed it
+	uint8_t *shared = _km_page_alloc( 1 );
+	CHECK( _km_page_refs(shared) == 1 );
+	_km_page_share( shared );
+	CHECK( _km_page_refs(shared) == 2 );
+	_km_page_free( shared );
+	CHECK( _km_page_lookup(shared,NULL) == shared );
+	CHECK( _km_page_refs(shared) == 1 );
+	_km_page_free( shared );
+	CHECK( _km_page_lookup(shared,NULL) == NULL );
+
+	uint8_t *zeroed = _km_page_alloc_flags( 3, KM_ZERO );
+	CHECK( zeroed != NULL );
+	bool_t clean = true;
+	for( int i = 0; i < 3 * SZ_PAGE; ++i ) {
+		if( zeroed[i] != 0 ) {
+			clean = false;
+		}
+	}
+	CHECK( clean );
+	_km_page_free( zeroed );
+
+	// buddies coalesce: the largest block is still there afterwards
+	void *small[8];
+	for( int i = 0; i < 8; ++i ) {
+		small[i] = _km_page_alloc( 1 );
+	}
+	for( int i = 0; i < 8; ++i ) {
+		_km_page_free( small[i] );
+	}
+	void *big = _km_page_alloc( 1 << KM_MAX_ORDER );
+	CHECK( big != NULL );
+	CHECK( ((uint32_t) big & ((SZ_PAGE << KM_MAX_ORDER) - 1)) == 0 );
+	_km_page_free( big );
+
+	// slices are aligned and always handed out clean
+	uint8_t *slice = _km_slice_alloc();
+	CHECK( ((uint32_t) slice & (SZ_SLICE - 1)) == 0 );
+	__memset( slice, SZ_SLICE, 0x5a );
+	_km_slice_free( slice );
+	slice = _km_slice_alloc();
+	clean = true;
+	for( int i = 0; i < SZ_SLICE; ++i ) {
+		if( slice[i] != 0 ) {
+			clean = false;
+		}
+	}
+	CHECK( clean );
+	_km_slice_free( slice );
+}
+
+static void _test_slab( void ) {
+	slab_cache_t cache;
+	void *elems[3 * 7 + 2];
+
+	__cio_puts( "slab_cache\n" );
+
+	// 512-byte elements: 7 to a one-page slab
+	CHECK( slab_init(&cache,512,SC_INIT_LARGE_SLABS) == E_SUCCESS );
+	CHECK( cache.slab_order == 0 );
+	CHECK( cache.elems_per_slab == 7 );
+	CHECK( cache.num_slabs == 1 );
+
+	for( int i = 0; i < 8; ++i ) {
+		elems[i] = slab_alloc( &cache, SC_ALLOC_ZERO_MEM );
+		CHECK( elems[i] != NULL );
+	}
+	CHECK( elems[1] == (uint8_t *) elems[0] + 512 );
+	CHECK( cache.in_use == 8 );
+	CHECK( cache.num_slabs == 2 );
+	CHECK( cache.full_slabs != NULL && cache.partial_slabs != NULL );
+	CHECK( slab_element_cache(elems[3],true) == &cache );
+
+	for( int i = 0; i < 8; ++i ) {
+		CHECK( slab_free(&cache,elems[i]) == E_SUCCESS );
+	}
+	CHECK( cache.in_use == 0 );
+	CHECK( cache.num_empty == SC_DEFAULT_MAX_EMPTY );
+	CHECK( cache.num_slabs == SC_DEFAULT_MAX_EMPTY );
+
+	// the first slab is the one that was kept, so this is still safe
+	CHECK( slab_free(&cache,elems[0]) == E_BAD_PARAM );
+
+	// bulk operations
+	CHECK( slab_alloc_bulk(&cache,3 * 7 + 2,elems,0) == 3 * 7 + 2 );
+	CHECK( cache.in_use == 3 * 7 + 2 );
+	CHECK( cache.num_slabs == 4 );
+	CHECK( slab_free_bulk(&cache,3 * 7 + 2,elems) == E_SUCCESS );
+	CHECK( cache.in_use == 0 );
+	CHECK( cache.num_slabs == SC_DEFAULT_MAX_EMPTY );
+	CHECK( cache.num_allocs == 8 + 3 * 7 + 2 );
+
+	CHECK( slab_shrink(&cache) == 1 );
+	CHECK( cache.num_slabs == 0 );
+
+	// the registry
+	CHECK( slab_register(&cache,"host-512") == E_SUCCESS );
+	CHECK( slab_register(&cache,"again") == E_BAD_PARAM );
+	char *report = _km_page_alloc( 1 );
+	CHECK( slab_info(report,SZ_PAGE) > 0 );
+	CHECK( _contains(report,"host-512") );
+	// rates stay right past 2^32 / CLOCK_FREQUENCY operations
+	cache.num_allocs += 5000000;
+	_system_time += CLOCK_FREQUENCY;
+	slab_info( report, SZ_PAGE );
+	CHECK( _contains(report," 5000000") );
+	slab_deinit( &cache );
+	slab_info( report, SZ_PAGE );
+	CHECK( !_contains(report,"host-512") );
+	_km_page_free( report );
+
+	// small elements live in slices
+	CHECK( slab_init(&cache,12,0) == E_SUCCESS );
+	CHECK( cache.slab_size == SZ_SLICE );
+	void *tiny = slab_alloc( &cache, 0 );
+	CHECK( ((uint32_t) tiny & ~(SZ_SLICE - 1)) ==
+			((uint32_t) cache.partial_slabs) );
+	CHECK( slab_free(&cache,tiny) == E_SUCCESS );
+	slab_deinit( &cache );
+
+	// larger elements get bigger slabs (see __pick_slab_order)
+	CHECK( slab_init(&cache,3000,0) == E_SUCCESS );
+	CHECK( (cache.flags & SC_INIT_LARGE_SLABS) != 0 );
+	CHECK( cache.slab_order == 2 );
+	slab_deinit( &cache );
+
+	// constructors run once per element per slab, not per allocation
+	_ctor_calls = _dtor_calls = 0;
+	CHECK( slab_init_ctor(&cache,100,SC_INIT_LARGE_SLABS,
+			_test_ctor,_test_dtor) == E_SUCCESS );
+	CHECK( _ctor_calls == cache.elems_per_slab );
+	uint32_t *obj = slab_alloc( &cache, SC_ALLOC_ZERO_MEM );
+	CHECK( *obj == 0xc0ffee );
+	CHECK( slab_free(&cache,obj) == E_SUCCESS );
+	obj = slab_alloc( &cache, 0 );
+	CHECK( *obj == 0xc0ffee );
+	CHECK( _ctor_calls == cache.elems_per_slab );
+	slab_free( &cache, obj );
+	slab_deinit( &cache );
+	CHECK( _dtor_calls == _ctor_calls );
+}
+
+static void _test_queues( void ) {
+	queue_t q;
+	void *data;
+
+	__cio_puts( "queues\n" );
+
+	_que_create( &q, NULL );
+	CHECK( _que_remove(&q,&data) == S_EMPTY );
+	for( int i = 1; i <= 5; ++i ) {
+		CHECK( _que_insert(&q,(void *) i) == S_OK );
+	}
+	CHECK( q.length == 5 );
+	CHECK( _que_remove_ptr(&q,(void *) 3) == S_OK );
+	CHECK( _que_peek(&q,&data) == S_OK && data == (void *) 1 );
+	int expected[] = { 1, 2, 4, 5 };
+	for( int i = 0; i < 4; ++i ) {
+		CHECK( _que_remove(&q,&data) == S_OK );
+		CHECK( data == (void *) expected[i] );
+	}
+	CHECK( QUE_IS_EMPTY(&q) );
+
+	_que_create( &q, _cmp_int );
+	int values[] = { 5, 1, 4, 2, 3 };
+	for( int i = 0; i < 5; ++i ) {
+		_que_insert( &q, (void *) values[i] );
+	}
+	for( int i = 1; i <= 5; ++i ) {
+		CHECK( _que_remove(&q,&data) == S_OK );
+		CHECK( data == (void *) i );
+	}
+
+	CHECK( _que_reserve(500) == S_OK );
+
+	// intrusive queues behave the same way
+	iqueue_t iq;
+	item_t items[5];
+	for( int i = 0; i < 5; ++i ) {
+		items[i].value = values[i];
+	}
+
+	_iq_create( &iq, NULL, IQ_OFFSET(item_t,link) );
+	CHECK( _iq_remove(&iq,&data) == S_EMPTY );
+	for( int i = 0; i < 5; ++i ) {
+		CHECK( _iq_insert(&iq,&items[i]) == S_OK );
+	}
+	CHECK( QUE_LENGTH(&iq) == 5 );
+	CHECK( _iq_remove_ptr(&iq,&items[2]) == S_OK );
+	CHECK( _iq_peek(&iq,&data) == S_OK && data == &items[0] );
+	int fifo[] = { 0, 1, 3, 4 };
+	int n = 0;
+	for( item_t *it = IQ_FIRST(&iq); it != NULL; it = IQ_NEXT(&iq,it) ) {
+		CHECK( n < 4 && it == &items[fifo[n]] );
+		++n;
+	}
+	CHECK( n == 4 );
+	for( int i = 0; i < 4; ++i ) {
+		CHECK( _iq_remove(&iq,&data) == S_OK );
+		CHECK( data == &items[fifo[i]] );
+	}
+	CHECK( QUE_IS_EMPTY(&iq) && iq.tail == NULL );
+
+	_iq_create( &iq, _cmp_item, IQ_OFFSET(item_t,link) );
+	for( int i = 0; i < 5; ++i ) {
+		_iq_insert( &iq, &items[i] );
+	}
+	CHECK( _iq_remove_ptr(&iq,&items[4]) == S_OK );	// value 3
+	CHECK( _iq_remove_ptr(&iq,&items[0]) == S_OK );	// value 5 (the tail)
+	int ordered[] = { 1, 2, 4 };
+	for( int i = 0; i < 3; ++i ) {
+		CHECK( _iq_remove(&iq,&data) == S_OK );
+		CHECK( ((item_t *) data)->value == ordered[i] );
+	}
+	CHECK( QUE_IS_EMPTY(&iq) );
+}
+
+// timer callback: note when it fired
+static void _timer_fired( ktimer_t *timer, void *arg ) {
+	*(time_t *) arg = _system_time;
+}
+
+// timer callback: re-arm every 10 ticks, counting the firings
+static void _timer_periodic( ktimer_t *timer, void *arg ) {
+	++*(uint32_t *) arg;
+	_timer_arm( timer, timer->expires + 10 );
+}
+
+// advance the system time by one tick at a time, as the clock ISR does
+static void _timer_run_to( time_t when ) {
+	while( _system_time != when ) {
+		++_system_time;
+		_timer_tick();
+	}
+}
+
+static void _test_timers( void ) {
+	// expirations on both sides of each level boundary, and one
+	// which needs every level
+	time_t when[] = { 1, 2, 63, 64, 65, 100, 4095, 4096, 4097, 300000 };
+	const int n = sizeof(when) / sizeof(when[0]);
+	ktimer_t timers[n];
+	time_t fired[n];
+
+	__cio_puts( "timers\n" );
+
+	_system_time = 0;
+	_timer_init();
+
+	// arm them in reverse order, one of them twice
+	for( int i = n - 1; i >= 0; --i ) {
+		fired[i] = 0;
+		_timer_setup( &timers[i], _timer_fired, &fired[i] );
+		_timer_arm( &timers[i], i == 5 ? 7 : when[i] );
+	}
+	_timer_arm( &timers[5], when[5] );
+	CHECK( _timer_count() == (uint32_t) n );
+
+	// cancelling works once
+	ktimer_t cancelled;
+	time_t never = 0;
+	_timer_setup( &cancelled, _timer_fired, &never );
+	_timer_arm( &cancelled, 64 );
+	CHECK( _timer_pending(&cancelled) );
+	CHECK( _timer_cancel(&cancelled) == S_OK );
+	CHECK( _timer_cancel(&cancelled) == S_NOTFOUND );
+	CHECK( !_timer_pending(&cancelled) );
+
+	ktimer_t periodic;
+	uint32_t ticks = 0;
+	_timer_setup( &periodic, _timer_periodic, &ticks );
+	_timer_arm( &periodic, 10 );
+
+	_timer_run_to( 300000 );
+	for( int i = 0; i < n; ++i ) {
+		CHECK( fired[i] == when[i] );
+	}
+	CHECK( never == 0 );
+	CHECK( ticks == 30000 );
+	CHECK( _timer_count() == 1 );
+
+	// a time already passed fires on the next tick
+	_timer_arm( &timers[0], 5 );
+	_timer_run_to( 300001 );
+	CHECK( fired[0] == 300001 );
+
+	// when ticks are missed, the next one catches up
+	_timer_arm( &timers[1], 301000 );
+	_system_time = 302000;
+	_timer_tick();
+	CHECK( fired[1] == 302000 );
+	CHECK( ticks == 30200 );
+
+	// how long the clock can go without ticking:  until the next
+	// expiration, the caller's limit, or level 0 wrapping around
+	CHECK( _timer_next(54) == 10 );
+	CHECK( _timer_next(5) == 5 );
+
+	CHECK( _timer_cancel(&periodic) == S_OK );
+	CHECK( _timer_count() == 0 );
+	CHECK( _timer_next(54) == 64 - (302000 & TW_MASK) );
+}
+
+static void _test_kstring( void ) {
+	kstr_strtok_context_t ctx = { NULL };
+
+	__cio_puts( "kstring\n" );
+
+	kstr_t abc = KSTR_CREATE( "abc", 3 );
+	kstr_t abc2 = KSTR_CREATE( "abcdef", 3 );
+	kstr_t abd = KSTR_CREATE( "abd", 3 );
+	kstr_t ab = KSTR_CREATE( "ab", 2 );
+	CHECK( kstr_strcmp(&abc,&abc2) == 0 );
+	CHECK( kstr_strcmp(&abc,&abd) < 0 );
+	CHECK( kstr_strcmp(&abd,&abc) > 0 );
+	CHECK( kstr_strcmp(&ab,&abc) < 0 );
+
+	// FNV-1 reference values
+	kstr_t empty = KSTR_CREATE( "", 0 );
+	kstr_t a = KSTR_CREATE( "a", 1 );
+	CHECK( kstr_hash(&empty) == 0x811c9dc5 );
+	CHECK( kstr_hash(&a) == 0x050c5d7e );
+
+	kstr_t path = KSTR_CREATE( "//usr/bin", 9 );
+	kstr_t tok = kstr_strtok( &path, '/', &ctx );
+	CHECK( tok.len == 3 && __memcmp(tok.str,"usr",3) == 0 );
+	tok = kstr_strtok( &path, '/', &ctx );
+	CHECK( tok.len == 3 && __memcmp(tok.str,"bin",3) == 0 );
+	tok = kstr_strtok( &path, '/', &ctx );
+	CHECK( tok.len == 0 );
+}
+
+/*
+** BENCHMARKS
+*/
+
+static void _bench_kmem( void ) {
+	unsigned long long start = _host_ns();
+	for( int i = 0; i < BENCH_PAGE_OPS; ++i ) {
+		_km_page_free( _km_page_alloc(1) );
+	}
+	_host_report( "page alloc+free (1 page)", BENCH_PAGE_OPS,
+			_host_ns() - start );
+
+	start = _host_ns();
+	for( int i = 0; i < BENCH_PAGE_OPS; ++i ) {
+		_km_page_free( _km_page_alloc(5) );
+	}
+	_host_report( "page alloc+free (5 pages)", BENCH_PAGE_OPS,
+			_host_ns() - start );
+
+	start = _host_ns();
+	for( int i = 0; i < BENCH_PAGE_OPS; ++i ) {
+		_km_slice_free( _km_slice_alloc() );
+	}
+	_host_report( "slice alloc+free", BENCH_PAGE_OPS, _host_ns() - start );
+}
+
+static void _bench_slab( void ) {
+	slab_cache_t cache;
+	void *batch[BENCH_BATCH];
+
+	slab_init( &cache, 64, SC_INIT_LARGE_SLABS );
+
+	unsigned long long start = _host_ns();
+	for( int i = 0; i < BENCH_OPS; ++i ) {
+		slab_free( &cache, slab_alloc(&cache,0) );
+	}
+	_host_report( "slab alloc+free", BENCH_OPS, _host_ns() - start );
+
+	start = _host_ns();
+	for( int i = 0; i < BENCH_OPS / BENCH_BATCH; ++i ) {
+		for( int j = 0; j < BENCH_BATCH; ++j ) {
+			batch[j] = slab_alloc( &cache, 0 );
+		}
+		for( int j = 0; j < BENCH_BATCH; ++j ) {
+			slab_free( &cache, batch[j] );
+		}
+	}
+	_host_report( "slab alloc+free (batches)",
+			(BENCH_OPS / BENCH_BATCH) * BENCH_BATCH, _host_ns() - start );
+
+	start = _host_ns();
+	for( int i = 0; i < BENCH_OPS / BENCH_BATCH; ++i ) {
+		uint32_t got = slab_alloc_bulk( &cache, BENCH_BATCH, batch, 0 );
+		slab_free_bulk( &cache, got, batch );
+	}
+	_host_report( "slab bulk alloc+free",
+			(BENCH_OPS / BENCH_BATCH) * BENCH_BATCH, _host_ns() - start );
+
+	slab_deinit( &cache );
+}
+
+static void _bench_queues( void ) {
+	queue_t q;
+	void *data;
+
+	_que_create( &q, NULL );
+
+	unsigned long long start = _host_ns();
+	for( int i = 0; i < BENCH_OPS; ++i ) {
+		_que_insert( &q, (void *) i );
+		_que_remove( &q, &data );
+	}
+	_host_report( "queue insert+remove", BENCH_OPS, _host_ns() - start );
+
+	start = _host_ns();
+	for( int i = 0; i < BENCH_OPS / BENCH_BATCH; ++i ) {
+		for( int j = 0; j < BENCH_BATCH; ++j ) {
+			_que_insert( &q, (void *) j );
+		}
+		for( int j = 0; j < BENCH_BATCH; ++j ) {
+			_que_remove( &q, &data );
+		}
+	}
+	_host_report( "queue insert+remove (x64)",
+			(BENCH_OPS / BENCH_BATCH) * BENCH_BATCH, _host_ns() - start );
+
+	iqueue_t iq;
+	item_t items[BENCH_BATCH];
+
+	_iq_create( &iq, NULL, IQ_OFFSET(item_t,link) );
+
+	start = _host_ns();
+	for( int i = 0; i < BENCH_OPS; ++i ) {
+		_iq_insert( &iq, &items[0] );
+		_iq_remove( &iq, &data );
+	}
+	_host_report( "iqueue insert+remove", BENCH_OPS, _host_ns() - start );
+
+	start = _host_ns();
+	for( int i = 0; i < BENCH_OPS / BENCH_BATCH; ++i ) {
+		for( int j = 0; j < BENCH_BATCH; ++j ) {
+			_iq_insert( &iq, &items[j] );
+		}
+		for( int j = 0; j < BENCH_BATCH; ++j ) {
+			_iq_remove( &iq, &data );
+		}
+	}
+	_host_report( "iqueue insert+remove (x64)",
+			(BENCH_OPS / BENCH_BATCH) * BENCH_BATCH, _host_ns() - start );
+}
+
+static void _bench_timers( void ) {
+	ktimer_t timers[BENCH_BATCH];
+	time_t fired;
+
+	for( int j = 0; j < BENCH_BATCH; ++j ) {
+		_timer_setup( &timers[j], _timer_fired, &fired );
+	}
+
+	// arm and cancel with delays spread over the levels
+	unsigned long long start = _host_ns();
+	for( int i = 0; i < BENCH_OPS / BENCH_BATCH; ++i ) {
+		for( int j = 0; j < BENCH_BATCH; ++j ) {
+			_timer_arm( &timers[j], _system_time + 1 + (j << (j % 24)) );
+		}
+		for( int j = 0; j < BENCH_BATCH; ++j ) {
+			_timer_cancel( &timers[j] );
+		}
+	}
+	_host_report( "timer arm+cancel (x64)",
+			(BENCH_OPS / BENCH_BATCH) * BENCH_BATCH, _host_ns() - start );
+
+	// ticks with that many timers pending, each re-armed as it fires
+	for( int j = 0; j < BENCH_BATCH; ++j ) {
+		_timer_setup( &timers[j], _timer_periodic, &fired );
+		_timer_arm( &timers[j], _system_time + 1 + j );
+	}
+	time_t stop = _system_time + BENCH_OPS;
+	start = _host_ns();
+	_timer_run_to( stop );
+	_host_report( "timer ticks (64 pending)", BENCH_OPS, _host_ns() - start );
+
+	for( int j = 0; j < BENCH_BATCH; ++j ) {
+		_timer_cancel( &timers[j] );
+	}
+}
+
+static void _bench_kstring( void ) {
+	kstr_t left = KSTR_CREATE( "libgdi.so.0.0.1-a", 17 );
+	kstr_t right = KSTR_CREATE( "libgdi.so.0.0.1-b", 17 );
+	uint32_t acc = 0;
+
+	unsigned long long start = _host_ns();
+	for( int i = 0; i < BENCH_OPS; ++i ) {
+		acc += kstr_strcmp( &left, &right );
+	}
+	_host_report( "kstr_strcmp (17 chars)", BENCH_OPS, _host_ns() - start );
+
+	start = _host_ns();
+	for( int i = 0; i < BENCH_OPS; ++i ) {
+		acc += kstr_hash( &left );
+	}
+	_host_report( "kstr_hash (17 chars)", BENCH_OPS, _host_ns() - start );
+
+	_sink = acc;
+}
+
+/*
+** PUBLIC FUNCTIONS
+*/
+
+int main( void ) {
+
+	_host_init( ARENA_SIZE );
+
+	__cio_puts( "Init:" );
+	_km_init();
+	_que_init();
+	__cio_puts( "\n\nTests:\n" );
+
+	_test_kmem();
+	_test_slab();
+	_test_queues();
+	_test_timers();
+	_test_kstring();
+
+	__cio_printf( "%d checks, %d failed\n", _checks, _failures );
+	if( _failures != 0 ) {
+		_host_exit( 1 );
+	}
+
+	__cio_puts( "\nBenchmarks:\n" );
+	_bench_kmem();
+	_bench_slab();
+	_bench_queues();
+	_bench_timers();
+	_bench_kstring();
+
+	return( 0 );
+}
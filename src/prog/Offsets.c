@@ -184,6 +184,9 @@ int main( int argc, char *argv[] ) {
     process( "SZ", "qnode_t", sizeof(qnode_t) );
     process( "SZ", "queue_t", sizeof(queue_t) );
     process( "SZ", "compare_t", sizeof(compare_t) );
+    process( "SZ", "qlink_t", sizeof(qlink_t) );
+    process( "SZ", "iqueue_t", sizeof(iqueue_t) );
+    process( "SZ", "ktimer_t", sizeof(ktimer_t) );
     fputc( '\n', genheader ? hfile : stdout );
 
     /*
@@ -213,15 +216,21 @@ int main( int argc, char *argv[] ) {
 
     hsection( "PCB", "pcb_t", sizeof(pcb_t) );
     process( "PCB", "context", offsetof(pcb_t,context) );
-    process( "PCB", "stack", offsetof(pcb_t,stack) );
+    process( "PCB", "proc", offsetof(pcb_t,proc) );
     process( "PCB", "exit_status", offsetof(pcb_t,exit_status) );
-    process( "PCB", "wakeup", offsetof(pcb_t,wakeup) );
+    process( "PCB", "vruntime", offsetof(pcb_t,vruntime) );
+    process( "PCB", "qlink", offsetof(pcb_t,qlink) );
+    process( "PCB", "plink", offsetof(pcb_t,plink) );
+    process( "PCB", "hnext", offsetof(pcb_t,hnext) );
+    process( "PCB", "rt", offsetof(pcb_t,rt) );
+    process( "PCB", "timer", offsetof(pcb_t,timer) );
     process( "PCB", "pid", offsetof(pcb_t,pid) );
     process( "PCB", "ppid", offsetof(pcb_t,ppid) );
     process( "PCB", "state", offsetof(pcb_t,state) );
     process( "PCB", "ticks_left",offsetof(pcb_t,ticks_left) );
     process( "PCB", "priority", offsetof(pcb_t,priority) );
-    process( "PCB", "filler", offsetof(pcb_t,filler) );
+    process( "PCB", "level", offsetof(pcb_t,level) );
+    process( "PCB", "slot", offsetof(pcb_t,slot) );
     fputc( '\n', genheader ? hfile : stdout );
 
     hsection( "QND", "qnode_t", sizeof(qnode_t) );
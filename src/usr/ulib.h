@@ -397,6 +397,95 @@ int32_t fchdir(char *path);
  */
 uint32_t fgetcwd(char *buffer, uint32_t buffer_len);
 
+/**
+** rtsched - enter (or leave) the real-time scheduling class
+**
+** usage:   n = rtsched( period, runtime, deadline )
+**
+** In each period, the process may run for up to 'runtime' ms, and
+** should finish its work within 'deadline' ms of the start of the
+** period; it says it has finished by calling sleep(0), and then
+** waits for the next period.  getdata(Misses) reports how many
+** deadlines it has missed.  A period of 0 leaves the class.
+**
+** @param period    length of each period, in ms
+** @param runtime   CPU time allowed in each period, in ms
+** @param deadline  deadline within each period, in ms
+**
+** @returns  0 on success, E_BAD_PARAM if runtime <= deadline <= period
+**           doesn't hold, or E_FAILURE if there isn't enough CPU time
+**           left to reserve (each process reserves runtime / deadline
+**           of it, so that every deadline can be met)
+*/
+int32_t rtsched( uint32_t period, uint32_t runtime, uint32_t deadline );
+
+/**
+** usleep - put the current process to sleep for some number of
+** microseconds
+**
+** usage:   usleep(n);
+**
+** Unlike sleep(), the wakeup isn't rounded to a clock tick (when
+** the hardware allows; see hrtimer.h).
+**
+** @param us Desired sleep time (in microseconds), or 0 to yield the CPU
+**
+** @return E_SUCCESS, or an error code if the sleep couldn't be performed
+*/
+int32_t usleep( uint32_t us );
+
+/**
+** spawnfd - create a new process running a different program
+**
+** usage:   pid = spawnfd( entry, prio, args, SPAWN_FD(fd1) | SPAWN_FD(fd2) )
+**
+** The child gets a stack of its own, with nothing of the caller's
+** copied into it, and inherits the caller's working directory and
+** the open files named in 'fds'.
+**
+** @param entry   the entry point of the new code
+** @param prio    the desired priority for the child, or -1 for the
+**                caller's priority
+** @param args    the command-line argument vector for the child
+** @param fds     bitmask of the file descriptors the child inherits
+**
+** @returns  the PID of the child, or an error code
+*/
+int32_t spawnfd( userfcn_t entry, int32_t prio, char *args[], uint32_t fds );
+
+// the spawnfd() bit for one file descriptor
+#define SPAWN_FD(fd)	(1U << (fd))
+
+/**
+** thrcreate - start a new thread in the calling process
+**
+** usage:   tid = thrcreate( entry, args )
+**
+** The thread runs entry(argc,argv) on a stack of its own, sharing
+** everything else (open files, working directory, PID) with the rest
+** of the process; it ends by returning from entry or calling exit().
+** If the process' first thread exits, its other threads are killed.
+**
+** @param entry   the function the thread runs
+** @param args    the argument vector for it
+**
+** @returns  the thread's ID (see getdata(Tid)), or an error code
+*/
+int32_t thrcreate( userfcn_t entry, char *args[] );
+
+/**
+** thrjoin - wait for a thread of the calling process to end
+**
+** usage:   tid = thrjoin( tid, &status )
+**
+** @param tid     the thread's ID
+** @param status  pointer to int32_t into which the thread's exit status
+**                is placed, or NULL
+**
+** @returns  the thread's ID, or an error code
+*/
+int32_t thrjoin( pid_t tid, int32_t *status );
+
 /**
 ** bogus - a nonexistent system call, to test our syscall ISR
 **
@@ -491,7 +580,8 @@ int32_t swrite( const char *buf, uint32_t leng );
 **
 ** usage:       n = spawn(entry,prio,args)
 **
-** Creates a new process, changes its priority, and then execs 'entry'
+** Creates a new process running 'entry', at the given priority; calls
+** spawnfd() with no file descriptors
 **
 ** @param entry The entry point of the new code
 ** @param prio  The desired priority for the process, or -1
@@ -59,8 +59,7 @@ int32_t wait( int32_t *status ) {
 **
 ** usage:   pid = spawn(entry,prio,args);
 **
-** Performs a fork(); on success, the child performs an execp()
-** with 'User' as the priority level.
+** Performs a spawnfd() in which the child inherits no open files.
 **
 ** @param entry The function which is the entry point of the new code
 ** @param prio  The desired priority for the new process, or -1
@@ -69,37 +68,7 @@ int32_t wait( int32_t *status ) {
 ** @returns PID of the new process, or an error code
 */
 int32_t spawn( userfcn_t entry, int32_t prio, char *args[] ) {
-	int32_t pid;
-	char buf[256];
-
-	pid = fork();
-	if( pid != 0 ) {
-		// failure, or we are the parent
-		return( pid );
-	}
-
-	// we are the child
-	pid = getdata( Pid );
-
-	// set the priority if we need to
-	if( prio >= 0 ) {
-		int32_t old = setdata( Prio, prio );
-		if( old < 0 ) {
-			sprint( buf, "PID %d set prio %d failed, code %d\n",
-					pid, prio, old );
-			cwrites( buf );
-		}
-	}
-
-	exec( entry, args );
-
-	// uh-oh....
-
-	sprint( buf, "PID %d exec() 0x%08x failed\n", pid, (uint32_t) entry );
-	cwrites( buf );
-
-	exit( E_FAILURE );
-	return( 0 );   // shut the compiler up
+	return( spawnfd(entry,prio,args,0) );
 }
 
 /**
@@ -0,0 +1,183 @@
+#ifndef BENCH_SCHED_H_
+#define BENCH_SCHED_H_
+
+#include "usr/users.h"
+#include "usr/ulib.h"
+
+/**
+** User function bench_sched:  exit, sleep, write, waitpid, getdata, fork
+**
+** Measures the scheduler.  First, it and a child each yield the CPU
+** n times, and it reports the rate of context switches.  Then it
+** starts h CPU-bound children, and while they run it repeatedly
+** sleeps for a short time, reporting how late it was woken (the
+** latency an interactive process would see) and how much work the
+** CPU-bound children got done (their throughput).
+**
+** Invoked as:  bench_sched  x  n  h  [ p ]
+**	 where x is the ID character
+**		   n is the number of yields per process
+**		   h is the number of CPU-bound children
+**		   p is the scheduling policy to use (m for MLFQ, the default,
+**		     or f for fair share); r uses MLFQ, but makes the napping
+**		     process a real-time one with a period of one nap
+*/
+
+// how long each nap in the latency test is, and how many there are
+#define BS_NAP		10
+#define BS_NAPS		50
+
+// how long the CPU-bound children run (they outlive the naps)
+#define BS_HOG_MS	(2 * BS_NAP * BS_NAPS)
+
+// a unit of "work" for the CPU-bound children
+#define BS_WORK		10000
+
+USERMAIN( bench_sched ) {
+	char ch = 'b';		// default character to print
+	int rounds = 2000;	// yields per process
+	int hogs = 3;		// CPU-bound children
+	int policy = PolicyMLFQ;
+	int rt = 0;
+	char buf[128];
+
+	// process the command-line arguments
+	switch( argc ) {
+	case 5:	policy = argv[4][0] == 'f' ? PolicyFair : PolicyMLFQ;
+			rt = argv[4][0] == 'r';
+			// FALL THROUGH
+	case 4:	hogs = str2int( argv[3], 10 );
+			// FALL THROUGH
+	case 3:	rounds = str2int( argv[2], 10 );
+			// FALL THROUGH
+	case 2:	ch = argv[1][0];
+			break;
+	default:
+			sprint( buf, "bench_sched: argc %d\n", argc );
+			cwrites( buf );
+	}
+
+	// announce our presence
+	swritech( ch );
+
+	// the children will inherit this
+	setdata( Policy, policy );
+	sprint( buf, "bench_sched: %s policy%s\n",
+			policy == PolicyFair ? "fair-share" : "MLFQ",
+			rt ? ", real-time napper" : "" );
+	cwrites( buf );
+
+	/*
+	** Context switches:  two processes trading the CPU back and forth
+	*/
+
+	uint32_t start = getdata( Time );
+	int32_t pid = fork();
+	if( pid < 0 ) {
+		cwrites( "bench_sched: fork failed\n" );
+		exit( 1 );
+	}
+	for( int i = 0; i < rounds; ++i ) {
+		sleep( 0 );
+	}
+	if( pid == 0 ) {
+		exit( 0 );
+	}
+	waitpid( pid, NULL );
+	uint32_t ms = getdata( Time ) - start;
+
+	sprint( buf, "bench_sched: %d switches in %d ms", 2 * rounds, ms );
+	cwrites( buf );
+	if( ms > 0 ) {
+		sprint( buf, " (%d/sec)", (2 * rounds * 1000) / ms );
+		cwrites( buf );
+	}
+	cwrites( "\n" );
+
+	/*
+	** Wakeup latency and throughput, with CPU-bound processes
+	** competing for the CPU
+	*/
+
+	uint32_t stop = getdata( Time ) + BS_HOG_MS;
+	for( int i = 0; i < hogs; ++i ) {
+		pid = fork();
+		if( pid < 0 ) {
+			cwrites( "bench_sched: fork failed\n" );
+			hogs = i;
+			break;
+		}
+		if( pid == 0 ) {
+			int32_t work = 0;
+			while( (uint32_t) getdata(Time) < stop ) {
+				for( volatile int j = 0; j < BS_WORK; ++j ) {
+					continue;
+				}
+				++work;
+			}
+			exit( work );
+		}
+	}
+
+	// as a real-time process, "napping" is waiting for the next period
+	if( rt && rtsched(BS_NAP,1,BS_NAP) != E_SUCCESS ) {
+		cwrites( "bench_sched: rtsched failed\n" );
+		rt = 0;
+	}
+
+	// keep the lateness figures sorted, for the tail
+	uint32_t late[BS_NAPS];
+	uint32_t total = 0;
+	uint32_t due = getdata( Time );
+	for( int i = 0; i < BS_NAPS; ++i ) {
+		if( rt ) {
+			// periods start at fixed intervals
+			sleep( 0 );
+			due += BS_NAP;
+		} else {
+			due = getdata( Time );
+			sleep( BS_NAP );
+			due += BS_NAP;
+		}
+		uint32_t l = getdata( Time ) - due;
+		total += l;
+		int j = i;
+		while( j > 0 && late[j - 1] > l ) {
+			late[j] = late[j - 1];
+			--j;
+		}
+		late[j] = l;
+	}
+
+	if( rt ) {
+		sprint( buf, "bench_sched: %d deadlines missed\n",
+				getdata(Misses) );
+		cwrites( buf );
+		rtsched( 0, 0, 0 );
+	}
+
+	int32_t work = 0;
+	for( int i = 0; i < hogs; ++i ) {
+		int32_t status;
+		if( waitpid(0,&status) > 0 ) {
+			work += status;
+		}
+	}
+
+	sprint( buf, "bench_sched: %d ms naps with %d CPU-bound processes: "
+			"late by %d ms avg, %d ms p95, %d ms max\n",
+			BS_NAP, hogs, total / BS_NAPS,
+			late[(BS_NAPS * 95) / 100], late[BS_NAPS - 1] );
+	cwrites( buf );
+	sprint( buf, "bench_sched: CPU-bound processes did %d units of work\n",
+			work );
+	cwrites( buf );
+
+	swritech( ch );
+
+	exit( 0 );
+
+	return( 42 );  // shut the compiler up!
+}
+
+#endif
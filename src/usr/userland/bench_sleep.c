@@ -0,0 +1,95 @@
+#ifndef BENCH_SLEEP_H_
+#define BENCH_SLEEP_H_
+
+#include "usr/users.h"
+#include "usr/ulib.h"
+
+/**
+** User function bench_sleep:  exit, sleep, usleep, write, getdata
+**
+** Measures how accurately sleeping processes are woken up.  For each
+** of a range of lengths, it sleeps n times with usleep() (and, for
+** lengths which are whole milliseconds, n more times with sleep()),
+** times each sleep with the nanosecond clock, and reports how much
+** longer than requested the sleeps took.
+**
+** Invoked as:  bench_sleep  x  n
+**	 where x is the ID character
+**		   n is the number of sleeps of each length
+*/
+
+// the sleep lengths, in microseconds
+static const uint32_t _bsl_us[] = {
+	20, 50, 100, 250, 500, 1000, 2000, 5000, 10000
+};
+
+#define BSL_LENGTHS	(sizeof(_bsl_us) / sizeof(_bsl_us[0]))
+
+/*
+** Sleep 'n' times for 'us' microseconds, either with usleep() or
+** (if 'ms' is set) with sleep(), and report the lateness
+*/
+static void _bsl_measure( uint32_t us, int n, int ms ) {
+	int32_t total = 0;
+	int32_t least = 0x7fffffff;
+	int32_t most = -least;
+	char buf[128];
+
+	for( int i = 0; i < n; ++i ) {
+		uint32_t start = getdata( Nanos );
+		if( ms ) {
+			sleep( us / 1000 );
+		} else {
+			usleep( us );
+		}
+		// in nanoseconds; negative if woken early
+		int32_t late = (int32_t) (getdata(Nanos) - start) - us * 1000;
+		total += late / n;
+		if( late < least ) {
+			least = late;
+		}
+		if( late > most ) {
+			most = late;
+		}
+	}
+
+	sprint( buf, "bench_sleep: %s %d us: late by %d us avg, "
+			"%d us min, %d us max\n", ms ? " sleep" : "usleep", us,
+			total / 1000, least / 1000, most / 1000 );
+	cwrites( buf );
+}
+
+USERMAIN( bench_sleep ) {
+	char ch = 's';		// default character to print
+	int count = 20;		// sleeps of each length
+	char buf[128];
+
+	// process the command-line arguments
+	switch( argc ) {
+	case 3:	count = str2int( argv[2], 10 );
+			// FALL THROUGH
+	case 2:	ch = argv[1][0];
+			break;
+	default:
+			sprint( buf, "bench_sleep: argc %d\n", argc );
+			cwrites( buf );
+	}
+
+	// announce our presence
+	swritech( ch );
+
+	for( uint32_t i = 0; i < BSL_LENGTHS; ++i ) {
+		_bsl_measure( _bsl_us[i], count, 0 );
+		if( _bsl_us[i] % 1000 == 0 ) {
+			_bsl_measure( _bsl_us[i], count, 1 );
+		}
+	}
+
+	swritech( ch );
+
+	exit( 0 );
+
+	return( 42 );  // shut the compiler up!
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef BENCH_SPAWN_H_
+#define BENCH_SPAWN_H_
+
+#include "usr/users.h"
+#include "usr/ulib.h"
+
+/**
+** User function bench_spawn:  exit, write, waitpid, getdata, fork,
+**                             exec, spawnfd
+**
+** Measures what it costs to start a process.  It runs n round trips
+** of starting a child which exits at once and waiting for it, first
+** with spawn() and then with fork() followed by exec(), times each
+** round trip with the nanosecond clock, and reports the results.
+**
+** Invoked as:  bench_spawn  x  n
+**	 where x is the ID character
+**		   n is the number of round trips of each kind
+*/
+
+/*
+** The child:  nothing to do but leave
+*/
+static int32_t _bsp_child( int32_t argc, char *argv[] ) {
+	exit( 0 );
+
+	return( 42 );  // shut the compiler up!
+}
+
+/*
+** Start 'n' children, either with spawn() or (if 'fe' is set) with
+** fork() and exec(), and report how long each round trip took
+*/
+static void _bsp_measure( int n, int fe ) {
+	char *args[] = { "bsp_child", NULL };
+	uint32_t total = 0;
+	uint32_t least = 0xffffffff;
+	uint32_t most = 0;
+	int32_t status;
+	char buf[128];
+
+	for( int i = 0; i < n; ++i ) {
+		uint32_t start = getdata( Nanos );
+		int32_t pid;
+		if( fe ) {
+			pid = fork();
+			if( pid == 0 ) {
+				exec( _bsp_child, args );
+				exit( E_FAILURE );
+			}
+		} else {
+			pid = spawn( _bsp_child, -1, args );
+		}
+		if( pid < 0 ) {
+			sprint( buf, "bench_spawn: %s failed, code %d\n",
+					fe ? "fork" : "spawn", pid );
+			cwrites( buf );
+			return;
+		}
+		waitpid( pid, &status );
+		uint32_t took = getdata( Nanos ) - start;
+		total += took / n;
+		if( took < least ) {
+			least = took;
+		}
+		if( took > most ) {
+			most = took;
+		}
+	}
+
+	sprint( buf, "bench_spawn: %s: %d us avg, %d us min, %d us max\n",
+			fe ? "fork+exec" : "    spawn", total / 1000, least / 1000,
+			most / 1000 );
+	cwrites( buf );
+}
+
+USERMAIN( bench_spawn ) {
+	char ch = 'p';		// default character to print
+	int count = 100;	// round trips of each kind
+	char buf[128];
+
+	// process the command-line arguments
+	switch( argc ) {
+	case 3:	count = str2int( argv[2], 10 );
+			// FALL THROUGH
+	case 2:	ch = argv[1][0];
+			break;
+	default:
+			sprint( buf, "bench_spawn: argc %d\n", argc );
+			cwrites( buf );
+	}
+
+	// announce our presence
+	swritech( ch );
+
+	_bsp_measure( count, 0 );
+	_bsp_measure( count, 1 );
+
+	swritech( ch );
+
+	exit( 0 );
+
+	return( 42 );  // shut the compiler up!
+}
+
+#endif
@@ -54,17 +54,12 @@ typedef struct proc_s {
 /*
 ** We have two spawn tables. The first one contains user-level
 ** processes that are started by 'init' but which are not available
-** to be started by 'shell', such as 'idle' and 'shell' itself.
+** to be started by 'shell', such as 'shell' itself.
 ** These will started before the processes listed in the secondary
 ** table (below).
 */
 static proc_t spawn_table_1[] = {
 
-	// the idle process; it runs at Deferred priority,
-	// so it will only be dispatched when there is
-	// nothing else available to be dispatched
-	PROCENT( idle, DeferredPrio, "!", "idle", "." ),
-
 #ifdef SPAWN_SHELL
 	// spawn a "test shell" process; it runs at System
 	// priority, so it takes precedence over all other
@@ -189,6 +184,31 @@ static proc_t spawn_table_2[] = {
 	PROCENT( test_vga, UserPrio, "G", "test_vga"),
 #endif
 
+#ifdef SPAWN_BENCH_SCHED
+	// b for benchmark
+	PROCENT( bench_sched, UserPrio, "b", "bench_sched", "b", "2000", "3" ),
+#endif
+
+#ifdef SPAWN_BENCH_SLEEP
+	// s for sleep
+	PROCENT( bench_sleep, UserPrio, "s", "bench_sleep", "s", "20" ),
+#endif
+
+#ifdef SPAWN_BENCH_SPAWN
+	// p for process creation
+	PROCENT( bench_spawn, UserPrio, "p", "bench_spawn", "p", "100" ),
+#endif
+
+#ifdef SPAWN_STRESS_SPAWN
+	// z for lots of zombies
+	PROCENT( stress_spawn, UserPrio, "z", "stress_spawn", "z", "2000", "64" ),
+#endif
+
+#ifdef SPAWN_TEST_THREADS
+	// t for threads
+	PROCENT( test_threads, UserPrio, "t", "test_threads", "t", "3" ),
+#endif
+
 #ifdef SPAWN_TEST_VFS
 	// V for vilesystem
 	PROCENT(test_vfs, UserPrio, "V", "vfs_test"),
@@ -0,0 +1,151 @@
+#ifndef STRESS_SPAWN_H_
+#define STRESS_SPAWN_H_
+
+#include "usr/users.h"
+#include "usr/ulib.h"
+
+/**
+** User function stress_spawn:  exit, write, waitpid, getdata, spawnfd
+**
+** Puts the process table under load.  It starts n short-lived
+** children in all, keeping up to w of them around at once (w may be
+** well beyond N_PROCS, which only sizes the process tables); whenever
+** w are around, it reaps one before starting another.  It then
+** reports how fast processes were started and reaped, and checks
+** that none are left over.
+**
+** Invoked as:  stress_spawn  x  n  w
+**	 where x is the ID character
+**		   n is the number of children to start in all
+**		   w is how many of them may be around at once
+*/
+
+/*
+** The children:  nothing to do but leave
+*/
+static int32_t _ssp_child( int32_t argc, char *argv[] ) {
+	exit( 0 );
+
+	return( 42 );  // shut the compiler up!
+}
+
+/*
+** Report the rate for 'n' operations which took 'us' microseconds
+*/
+static void _ssp_report( char *what, int n, uint32_t us ) {
+	char buf[128];
+
+	// the rate is only as good as the millisecond, at best
+	uint32_t ms = us / 1000;
+	if( ms == 0 ) {
+		ms = 1;
+	}
+
+	sprint( buf, "stress_spawn: %s %d in %d us, %d us each, %d/s\n",
+			what, n, us, n > 0 ? us / n : 0, n * 1000 / ms );
+	cwrites( buf );
+}
+
+USERMAIN( stress_spawn ) {
+	char ch = 'z';		// default character to print
+	int count = 2000;	// children to start
+	int width = 64;		// how many may be around at once
+	char buf[128];
+
+	// process the command-line arguments
+	switch( argc ) {
+	case 4:	width = str2int( argv[3], 10 );
+			// FALL THROUGH
+	case 3:	count = str2int( argv[2], 10 );
+			// FALL THROUGH
+	case 2:	ch = argv[1][0];
+			break;
+	default:
+			sprint( buf, "stress_spawn: argc %d\n", argc );
+			cwrites( buf );
+	}
+
+	if( width < 1 ) {
+		width = 1;
+	}
+
+	// announce our presence
+	swritech( ch );
+
+	char *args[] = { "ssp_child", NULL };
+	int started = 0;
+	int reaped = 0;
+	int alive = 0;
+	int most = 0;
+	uint32_t spawn_us = 0;
+	uint32_t reap_us = 0;
+	uint32_t begin = getdata( Time );
+
+	while( started < count || alive > 0 ) {
+
+		// start another one if there is room for it
+		if( started < count && alive < width ) {
+			uint32_t start = getdata( Nanos );
+			int32_t pid = spawn( _ssp_child, -1, args );
+			spawn_us += (getdata(Nanos) - start) / 1000;
+
+			if( pid >= 0 ) {
+				++started;
+				if( ++alive > most ) {
+					most = alive;
+				}
+				continue;
+			}
+
+			// out of memory, presumably; reap some and try again
+			if( alive == 0 ) {
+				sprint( buf, "stress_spawn: spawn %d failed, code %d\n",
+						started, pid );
+				cwrites( buf );
+				break;
+			}
+		}
+
+		// reap one
+		int32_t status;
+		uint32_t start = getdata( Nanos );
+		int32_t pid = waitpid( 0, &status );
+		reap_us += (getdata(Nanos) - start) / 1000;
+
+		if( pid < 0 ) {
+			sprint( buf, "stress_spawn: waitpid failed, code %d\n", pid );
+			cwrites( buf );
+			break;
+		}
+		if( status != 0 ) {
+			sprint( buf, "stress_spawn: child %d status %d\n", pid, status );
+			cwrites( buf );
+		}
+		++reaped;
+		--alive;
+	}
+
+	uint32_t elapsed = getdata( Time ) - begin;
+
+	_ssp_report( "spawned", started, spawn_us );
+	_ssp_report( "reaped", reaped, reap_us );
+	sprint( buf, "stress_spawn: %d at once at most, %d ms in all\n",
+			most, elapsed );
+	cwrites( buf );
+
+	// every child has been collected
+	int32_t left = waitpid( 0, NULL );
+	if( left != E_NO_CHILDREN ) {
+		sprint( buf, "stress_spawn: waitpid at the end returned %d\n",
+				left );
+		cwrites( buf );
+	}
+
+	swritech( ch );
+
+	exit( 0 );
+
+	return( 42 );  // shut the compiler up!
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef TEST_THREADS_H_
+#define TEST_THREADS_H_
+
+#include "usr/users.h"
+#include "usr/ulib.h"
+
+/**
+** User function test_threads:  exit, sleep, write, getdata, thrcreate,
+**                              thrjoin
+**
+** Starts a few threads, each of which prints its ID character a few
+** times and checks that it shares the process' PID, then joins them
+** all and checks their exit statuses.
+**
+** Invoked as:  test_threads  x  n
+**	 where x is the ID character
+**		   n is the number of threads (at most 7)
+*/
+
+// the process' PID, as its first thread sees it
+static int32_t _tth_pid;
+
+/*
+** The threads:  argv[1] is the character to print, and the exit
+** status is that character
+*/
+static int32_t _tth_thread( int32_t argc, char *argv[] ) {
+	char ch = argv[1][0];
+	char buf[128];
+
+	if( getdata(Pid) != _tth_pid ) {
+		sprint( buf, "test_threads: thread %d has pid %d, not %d\n",
+				getdata(Tid), getdata(Pid), _tth_pid );
+		cwrites( buf );
+	}
+
+	for( int i = 0; i < 5; ++i ) {
+		swritech( ch );
+		sleep( 100 );
+	}
+
+	return( ch );
+}
+
+USERMAIN( test_threads ) {
+	char ch = 't';		// default character to print
+	int count = 3;		// number of threads
+	char buf[128];
+
+	// process the command-line arguments
+	switch( argc ) {
+	case 3:	count = str2int( argv[2], 10 );
+			// FALL THROUGH
+	case 2:	ch = argv[1][0];
+			break;
+	default:
+			sprint( buf, "test_threads: argc %d\n", argc );
+			cwrites( buf );
+	}
+
+	if( count > 7 ) {
+		count = 7;
+	}
+
+	// announce our presence
+	swritech( ch );
+
+	_tth_pid = getdata( Pid );
+
+	int32_t tids[7];
+	char names[7][2];
+	for( int i = 0; i < count; ++i ) {
+		names[i][0] = '1' + i;
+		names[i][1] = '\0';
+		char *args[] = { "tth_thread", names[i], NULL };
+		tids[i] = thrcreate( _tth_thread, args );
+		if( tids[i] < 0 ) {
+			sprint( buf, "test_threads: thrcreate %d failed, code %d\n",
+					i, tids[i] );
+			cwrites( buf );
+			count = i;
+			break;
+		}
+	}
+
+	for( int i = 0; i < count; ++i ) {
+		int32_t status;
+		int32_t tid = thrjoin( tids[i], &status );
+		if( tid != tids[i] || status != '1' + i ) {
+			sprint( buf, "test_threads: join %d got %d, status %d\n",
+					tids[i], tid, status );
+			cwrites( buf );
+		}
+		// it's gone now
+		if( thrjoin(tids[i],NULL) >= 0 ) {
+			sprint( buf, "test_threads: joined %d twice\n", tids[i] );
+			cwrites( buf );
+		}
+	}
+
+	swritech( ch );
+
+	exit( 0 );
+
+	return( 42 );  // shut the compiler up!
+}
+
+#endif
@@ -463,8 +463,6 @@ INTERNAL_COMMAND(int_cmd_cat)
         cwrites("Path is required!\n");
     }
 
-    __memclr(read_buffer, READ_BUFFER_LEN);
-
     fd_t fd = fopen(argv[1], O_READ, 0);
     if(fd < 0) {
         sh_printf("Failed to open file: %d\n", fd);
@@ -474,17 +472,29 @@ INTERNAL_COMMAND(int_cmd_cat)
     uint32_t file_len = fseek(fd, 0, SEEK_END, NULL);
     fseek(fd, 0, SEEK_SET, NULL);
 
-    int32_t read_status = 0;
-    uint32_t num_read = fread(fd, read_buffer, file_len, 0, &read_status);
+    // Files (e.g. /slabinfo) can be bigger than the buffer: read them a piece at a time
+    while(file_len > 0) {
+        uint32_t to_read = file_len < READ_BUFFER_LEN - 1 ? file_len : READ_BUFFER_LEN - 1;
+        __memclr(read_buffer, READ_BUFFER_LEN);
+
+        int32_t read_status = 0;
+        uint32_t num_read = fread(fd, read_buffer, to_read, 0, &read_status);
 
-    if(read_status < 0 && read_status != E_EOF) {
-        sh_printf("Failed to read: %d\n", read_status);
-        if(num_read == 0) {
-            return -1;
+        if(read_status < 0 && read_status != E_EOF) {
+            sh_printf("Failed to read: %d\n", read_status);
+            if(num_read == 0) {
+                fclose(fd);
+                return -1;
+            }
         }
-    }
 
-    cwrites(read_buffer);
+        cwrites(read_buffer);
+
+        if(num_read == 0 || read_status == E_EOF) {
+            break;
+        }
+        file_len -= num_read;
+    }
     cwrites("\n");
 
     fclose(fd);
@@ -33,7 +33,7 @@
 ** for completeness)
 */
 
-USERMAIN(idle);  USERMAIN(shell); USERMAIN(wtsh_main);
+USERMAIN(shell); USERMAIN(wtsh_main);
 
 USERMAIN(main1); USERMAIN(main2); USERMAIN(main3); USERMAIN(main4);
 USERMAIN(main5); USERMAIN(main6); USERMAIN(main7); USERMAIN(main8);
@@ -47,6 +47,11 @@ USERMAIN(userU); USERMAIN(userV); USERMAIN(userW); USERMAIN(userX);
 USERMAIN(userY); USERMAIN(userZ);
 
 USERMAIN(test_vga);
+USERMAIN(bench_sched);
+USERMAIN(bench_sleep);
+USERMAIN(bench_spawn);
+USERMAIN(stress_spawn);
+USERMAIN(test_threads);
 USERMAIN(test_vfs);
 
 /*
@@ -124,6 +129,26 @@ USERMAIN(test_vfs);
 #include "userland/test_vga.c"
 #endif
 
+#if defined(SPAWN_BENCH_SCHED)
+#include "userland/bench_sched.c"
+#endif
+
+#if defined(SPAWN_BENCH_SLEEP)
+#include "userland/bench_sleep.c"
+#endif
+
+#if defined(SPAWN_BENCH_SPAWN)
+#include "userland/bench_spawn.c"
+#endif
+
+#if defined(SPAWN_STRESS_SPAWN)
+#include "userland/stress_spawn.c"
+#endif
+
+#if defined(SPAWN_TEST_THREADS)
+#include "userland/test_threads.c"
+#endif
+
 #if defined(SPAWN_TEST_VFS)
 #include "userland/test_vfs.c"
 #endif
@@ -139,4 +164,3 @@ USERMAIN(test_vfs);
 // init.c contains 'init' and 'shell'
 #include "userland/init.c"
 
-#include "userland/idle.c"
@@ -83,7 +83,6 @@
 **  fcn   exit  sleep read  write wtpid gdata sdata kill  fork  exec  bogus
 ** -----  ----- ----- ----- ----- ----- ----- ----- ----- ----- ----- -----
 ** init     X     X     .     X     X     .     X     .     X     X     .
-** idle     X     .     .     X     .     X     .     .     .     .     .
 ** shell    .     .     X     X     X     .     X     .     X     X     .
 ** -----  ----- ----- ----- ----- ----- ----- ----- ----- ----- ----- -----
 ** main1    X     .     .     X     .     .     .     .     .     .     .
@@ -104,6 +103,11 @@
 ** userX    X     .     .     X     .     X     .     .     .     .     .
 ** userY    X     .     .     X     .     X     .     .     .     .     .
 ** userZ    X     X     .     .     .     .     .     .     .     .     .
+** bench    X     X     .     X     X     X     .     .     X     .     .
+** bslp     X     X     .     X     .     X     .     .     .     .     .
+** bspn     X     .     .     X     X     X     .     .     X     X     .
+** thrd     X     X     .     X     .     X     .     .     .     .     .
+** sspn     X     .     .     X     X     X     .     .     .     .     .
 ** ........................................................................
 */
 
@@ -151,6 +155,11 @@
 // #define SPAWN_W // VGA syscall testing
 
 // #define SPAWN_TEST_VGA
+// #define SPAWN_BENCH_SCHED // scheduler benchmark
+// #define SPAWN_BENCH_SLEEP // sleep accuracy benchmark
+// #define SPAWN_BENCH_SPAWN // process creation benchmark
+// #define SPAWN_STRESS_SPAWN // thousands of short-lived processes
+// #define SPAWN_TEST_THREADS // thread creation and joining
 #endif
 
 #define WTSH_SHELL
@@ -175,15 +184,6 @@
 */
 USERMAIN(init);
 
-/**
-** idle - the idle process
-**
-** Reports itself, then loops forever delaying and printing a character.
-**
-** Invoked as:  idle
-*/
-USERMAIN(idle);
-
 #endif
 /* SP_ASM_SRC */
 
@@ -31,13 +31,17 @@
 #include "common.h"
 #include "kern/kernel.h"
 #include "queues.h"
+#include "util/slab_cache.h"
 
 /*
 ** PRIVATE DEFINITIONS
 */
 
-// how many qnodes can we get from a memory slice?
-#define	N_QN_PER_SLICE	(SZ_SLICE / sizeof(qnode_t))
+// how many qnodes move between the free list and the slab cache at once
+#define	N_QN_BATCH	32
+
+// how many free qnodes we hold on to before giving a batch back
+#define	N_QN_MAX_FREE	(3 * N_QN_BATCH)
 
 /*
 ** PRIVATE DATA TYPES
@@ -47,8 +51,12 @@
 ** PRIVATE GLOBAL VARIABLES
 */
 
-// list of free qnodes
+// list of free qnodes, and its length
 static qnode_t *_qn_freelist;
+static uint32_t _qn_nfree;
+
+// where the qnodes come from
+static slab_cache_t _qn_cache;
 
 /*
 ** PUBLIC GLOBAL VARIABLES
@@ -58,6 +66,24 @@ static qnode_t *_qn_freelist;
 ** PRIVATE FUNCTIONS
 */
 
+/**
+** Name:  _qn_shrink
+**
+** Give a batch of free qnodes back to the slab cache in one operation.
+*/
+static void _qn_shrink( void )
+{
+	void *batch[N_QN_BATCH];
+
+	for( int i = 0; i < N_QN_BATCH; ++i ) {
+		batch[i] = _qn_freelist;
+		_qn_freelist = _qn_freelist->next;
+	}
+	_qn_nfree -= N_QN_BATCH;
+
+	assert( slab_free_bulk(&_qn_cache,N_QN_BATCH,batch) == E_SUCCESS );
+}
+
 /**
 ** _qn_dealloc() - return a qnode to the free list
 **
@@ -72,25 +98,47 @@ static void _qn_dealloc( qnode_t *qn )
 	
 	qn->next = _qn_freelist;
 	_qn_freelist = qn;
+
+	// don't sit on an unbounded number of them
+	if( ++_qn_nfree > N_QN_MAX_FREE ) {
+		_qn_shrink();
+	}
 }
 
 /**
 ** Name:  _qn_extend
 **
-** Extend the set of available qnodes by allocating a slice
-** of memory and carving it into qnode structures.
+** Extend the set of available qnodes by pulling a batch of
+** them from the slab cache in one operation.
+**
+** @param count  The minimum number of qnodes to add
+**
+** @return The number of qnodes actually added
 */
-static void _qn_extend( void )
+static uint32_t _qn_extend( uint32_t count )
 {
-	qnode_t *tmp;
-
-	// allocate a slice of memory
-	tmp = (qnode_t *) _km_slice_alloc();
+	void *batch[N_QN_BATCH];
+	uint32_t added = 0;
+
+	while( added < count ) {
+		uint32_t got = slab_alloc_bulk( &_qn_cache, N_QN_BATCH, batch, 0 );
+
+		// put them on the free list directly, so that this
+		// doesn't just trigger _qn_shrink()
+		for( uint32_t i = 0; i < got; ++i ) {
+			qnode_t *qn = (qnode_t *) batch[i];
+			qn->next = _qn_freelist;
+			_qn_freelist = qn;
+		}
+		_qn_nfree += got;
+		added += got;
 
-	// iterate through it, deallocating each qnode
-	for( int i = 0; i < N_QN_PER_SLICE; ++i, ++tmp ) {
-		_qn_dealloc( tmp );
+		if( got < N_QN_BATCH ) {
+			break;	// out of memory
+		}
 	}
+
+	return added;
 }
 
 /**
@@ -104,14 +152,15 @@ static qnode_t *_qn_alloc( void )
 {
 	qnode_t *tmp;
 	
-	// if the list is empty, grab another slice and repopulate it
-	if( _qn_freelist == NULL ) {
-		_qn_extend();
+	// if the list is empty, grab another batch and repopulate it
+	if( _qn_freelist == NULL && _qn_extend(1) == 0 ) {
+		return NULL;
 	}
 	
 	// take the first node from the list
 	tmp = _qn_freelist;
 	_qn_freelist = tmp->next;
+	--_qn_nfree;
 
 	// make sure we clean it out
 	__memclr( tmp, sizeof(qnode_t) );
@@ -132,14 +181,39 @@ void _que_init( void )
 {
 	// reset the free list (just in case)
 	_qn_freelist = NULL;
+	_qn_nfree = 0;
+
+	// qnodes are small, so they come from slices
+	assert( slab_init(&_qn_cache,sizeof(qnode_t),0) == E_SUCCESS );
+	slab_register( &_qn_cache, "qnode" );
 
 	// create the first set of qnodes for use
-	_qn_extend();
+	_qn_extend( N_QN_BATCH );
 	
 	// all done!
 	__cio_puts( " QUE" );
 }
 
+/**
+** Name:  _que_reserve
+**
+** Make sure at least count qnodes are available, so that that many
+** insertions won't have to go back to the allocator one at a time.
+**
+** @param count  The number of insertions about to be made
+**
+** @return S_OK, or S_NOMEM if memory ran out
+*/
+status_t _que_reserve( uint32_t count )
+{
+	if( _qn_nfree >= count ) {
+		return S_OK;
+	}
+
+	count -= _qn_nfree;
+	return( _qn_extend(count) >= count ? S_OK : S_NOMEM );
+}
+
 /**
 ** Name:  _que_create
 **
@@ -436,3 +510,189 @@ status_t _que_remove_ptr( queue_t *q, void *data )
 	
 	return S_OK;
 }
+
+/*
+** INTRUSIVE QUEUES
+*/
+
+/**
+** Name:  _iq_create
+**
+** Create (reinitialize) an intrusive queue.
+**
+** @param q        The queue to be reinitialized
+** @param compare  The ordering function for this queue, or NULL
+** @param offset   Offset of the qlink_t within each entry (see IQ_OFFSET)
+*/
+void _iq_create( iqueue_t *q, compare_t compare, uint32_t offset )
+{
+	// sanity check
+	assert( q != NULL );
+
+	q->head = q->tail = NULL;
+	q->length = 0;
+	q->compare = compare;
+	q->offset = offset;
+}
+
+/**
+** Name:  _iq_peek
+**
+** Peek at the first entry in an intrusive queue
+**
+** @param q      The queue to be examined
+** @param entry  (output) Where to save the first entry
+**
+** @return S_OK if there was an entry, S_EMPTY otherwise
+*/
+status_t _iq_peek( iqueue_t *q, void **entry )
+{
+	// sanity check
+	assert1( q != NULL );
+	assert1( entry != NULL );
+
+	if( QUE_IS_EMPTY(q) ) {
+		return S_EMPTY;
+	}
+
+	*entry = IQ_ENTRY( q, q->head );
+
+	return S_OK;
+}
+
+/**
+** Name:  _iq_insert
+**
+** Add an entry to an intrusive queue.
+**
+** @param q      The queue to be manipulated
+** @param entry  The entry to add (must not be on a queue through this link)
+**
+** @return The insertion status (always S_OK)
+*/
+status_t _iq_insert( iqueue_t *q, void *entry )
+{
+	// sanity check
+	assert1( q != NULL );
+	assert1( entry != NULL );
+
+	qlink_t *link = IQ_LINK( q, entry );
+
+	// if it's empty, this is the first entry
+
+	if( QUE_IS_EMPTY(q) ) {
+		link->prev = link->next = NULL;
+		q->head = q->tail = link;
+		q->length = 1;
+		return S_OK;
+	}
+
+	// find the insertion point; FIFO queues always append
+
+	qlink_t *prev = q->tail;
+	qlink_t *curr = NULL;
+
+	if( !QUE_IS_FIFO(q) ) {
+
+		// same ordering rule as _que_insert(): stop at the first
+		// entry that the new one sorts strictly before
+
+		prev = NULL;
+		curr = q->head;
+		while( curr != NULL && q->compare(entry,IQ_ENTRY(q,curr)) >= 0 ) {
+			prev = curr;
+			curr = curr->next;
+		}
+	}
+
+	link->prev = prev;
+	link->next = curr;
+
+	if( prev == NULL ) {
+		q->head = link;
+	} else {
+		prev->next = link;
+	}
+
+	if( curr == NULL ) {
+		q->tail = link;
+	} else {
+		curr->prev = link;
+	}
+
+	q->length += 1;
+
+	return S_OK;
+}
+
+/**
+** Name:  _iq_remove
+**
+** Remove the first entry from an intrusive queue.
+**
+** @param q      The queue to be manipulated
+** @param entry  (output) Where to save the removed entry
+**
+** @return The removal status
+*/
+status_t _iq_remove( iqueue_t *q, void **entry )
+{
+	// sanity check
+	assert1( q != NULL );
+	assert1( entry != NULL );
+
+	if( QUE_IS_EMPTY(q) ) {
+		return S_EMPTY;
+	}
+
+	*entry = IQ_ENTRY( q, q->head );
+
+	return _iq_remove_ptr( q, *entry );
+}
+
+/**
+** Name:  _iq_remove_ptr
+**
+** Remove a specific entry from an intrusive queue, in O(1) time.
+**
+** @param q      The queue to be manipulated
+** @param entry  The entry to remove (must be on q)
+**
+** @return The removal status
+*/
+status_t _iq_remove_ptr( iqueue_t *q, void *entry )
+{
+	// sanity check
+	assert1( q != NULL );
+	assert1( entry != NULL );
+
+	if( QUE_IS_EMPTY(q) ) {
+		return S_EMPTY;
+	}
+
+	qlink_t *link = IQ_LINK( q, entry );
+
+	// an entry with no neighbors must be the only one on the queue
+	assert1( link->prev != NULL || q->head == link );
+	assert1( link->next != NULL || q->tail == link );
+
+	if( link->prev == NULL ) {
+		q->head = link->next;
+	} else {
+		link->prev->next = link->next;
+	}
+
+	if( link->next == NULL ) {
+		q->tail = link->prev;
+	} else {
+		link->next->prev = link->prev;
+	}
+
+	link->prev = link->next = NULL;
+	q->length -= 1;
+
+	// the queue is empty exactly when both ends are gone
+	assert1( (q->length == 0) == (q->head == NULL) );
+
+	return S_OK;
+}
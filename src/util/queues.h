@@ -70,6 +70,46 @@ typedef struct queue_s {
 // ordering functions
 typedef int (*compare_t)(void*,void*);
 
+/*
+** Intrusive queues
+**
+** An iqueue_t links its entries through a qlink_t embedded in each
+** entry, rather than through qnodes, so inserting and removing never
+** allocate memory and removing a specific entry takes O(1) time.
+** An entry can be on only one iqueue at a time through a given link.
+** Otherwise, iqueues behave exactly like queues (FIFO if there is no
+** comparison function, ordered if there is), and the QUE_* macros
+** work on them as well.  The comparison function is passed pointers
+** to the entries themselves, not to their links.
+*/
+
+typedef struct qlink_s {
+	struct qlink_s *prev;
+	struct qlink_s *next;
+} qlink_t;
+
+typedef struct iqueue_s {
+	qlink_t *head;
+	qlink_t *tail;
+	int (*compare)(void*,void*);
+	uint32_t length;
+	uint32_t offset;	// where the qlink_t is in each entry
+} iqueue_t;
+
+// byte offset of a field in a structure (we don't have <stddef.h>)
+#define	IQ_OFFSET(type,field)	((uint32_t) &(((type *) 0)->field))
+
+// convert between an entry and its link
+#define	IQ_LINK(q,entry)	((qlink_t *) ((uint8_t *) (entry) + (q)->offset))
+#define	IQ_ENTRY(q,link)	((void *) ((uint8_t *) (link) - (q)->offset))
+
+// walk through an iqueue:  its first entry, and the entry after a
+// given one (NULL at the end); fetch the next entry before removing
+// the current one
+#define	IQ_FIRST(q)			((q)->head == NULL ? NULL : IQ_ENTRY(q,(q)->head))
+#define	IQ_NEXT(q,entry)	(IQ_LINK(q,entry)->next == NULL ? NULL : \
+								IQ_ENTRY(q,IQ_LINK(q,entry)->next))
+
 /*
 ** Globals
 */
@@ -85,6 +125,18 @@ typedef int (*compare_t)(void*,void*);
 */
 void _que_init( void );
 
+/**
+** Name:  _que_reserve
+**
+** Make sure at least count qnodes are available, so that that many
+** insertions won't have to go back to the allocator one at a time.
+**
+** @param count  The number of insertions about to be made
+**
+** @return S_OK, or S_NOMEM if memory ran out
+*/
+status_t _que_reserve( uint32_t count );
+
 /**
 ** Name:  _que_create
 **
@@ -143,6 +195,65 @@ status_t _que_remove( queue_t *q, void **data );
 */
 status_t _que_remove_ptr( queue_t *q, void *data );
 
+/**
+** Name:  _iq_create
+**
+** Create (reinitialize) an intrusive queue.
+**
+** @param q        The queue to be reinitialized
+** @param compare  The ordering function for this queue, or NULL
+** @param offset   Offset of the qlink_t within each entry (see IQ_OFFSET)
+*/
+void _iq_create( iqueue_t *q, compare_t compare, uint32_t offset );
+
+/**
+** Name:  _iq_peek
+**
+** Peek at the first entry in an intrusive queue
+**
+** @param q      The queue to be examined
+** @param entry  (output) Where to save the first entry
+**
+** @return S_OK if there was an entry, S_EMPTY otherwise
+*/
+status_t _iq_peek( iqueue_t *q, void **entry );
+
+/**
+** Name:  _iq_insert
+**
+** Add an entry to an intrusive queue.
+**
+** @param q      The queue to be manipulated
+** @param entry  The entry to add (must not be on a queue through this link)
+**
+** @return The insertion status (always S_OK)
+*/
+status_t _iq_insert( iqueue_t *q, void *entry );
+
+/**
+** Name:  _iq_remove
+**
+** Remove the first entry from an intrusive queue.
+**
+** @param q      The queue to be manipulated
+** @param entry  (output) Where to save the removed entry
+**
+** @return The removal status
+*/
+status_t _iq_remove( iqueue_t *q, void **entry );
+
+/**
+** Name:  _iq_remove_ptr
+**
+** Remove a specific entry from an intrusive queue, in O(1) time.
+**
+** @param q      The queue to be manipulated
+** @param entry  The entry to remove (must be on q)
+**
+** @return The removal status
+*/
+status_t _iq_remove_ptr( iqueue_t *q, void *entry );
+
 #endif
 // !SP_ASM_SRC
 
@@ -11,21 +11,24 @@
 #include "common.h"
 #include "libc/lib.h"
 #include "mem/kmem.h"
+#include "kern/kernel.h"
+#include "kern/clock.h"
 
 /**
  * @brief The address mask to translate from an element to the slice it's contained in
  */
-#define SMALL_SLAB_HEADER_MASK (0xFFFFC00U)
-/**
- * @brief The address mask to translate from an element to the page it's contained in
- */
-#define LARGE_SLAB_HEADER_MASK (0xFFFF000U)
+#define SMALL_SLAB_HEADER_MASK (~(SZ_SLICE - 1U))
+
+// Multi-page slabs come from the buddy allocator as a power of two pages,
+// so they're aligned to their own size and masking an element's address
+// with the slab size still finds the header. Code that doesn't know the
+// cache (and so the slab size) asks kmem which page allocation the element
+// lives in instead.
 
 /**
  * @brief Get the header of the slab an element is contained in from a pointer to the element
  */
-#define ELEMENT_TO_SLAB_HEADER(elem) ((slab_header_t *) (((uint32_t) (elem)) & \
-                                 (cache->flags & SC_INIT_LARGE_SLABS ? LARGE_SLAB_HEADER_MASK : SMALL_SLAB_HEADER_MASK)))
+#define ELEMENT_TO_SLAB_HEADER(elem) ((slab_header_t *) (((uint32_t) (elem)) & ~(cache->slab_size - 1U)))
 
 /**
  * @brief Prettifying macro to cast a pointer to a void** linked list item
@@ -33,28 +36,43 @@
 #define VOID_PTR_TO_LIST_ITEM(ptr) ((void **) (ptr))
 
 /**
- * @brief Get the size of a cache's slabs from its flags
+ * @brief Get the free list link of an element
+ */
+#define ELEMENT_LINK(cache, elem) VOID_PTR_TO_LIST_ITEM((elem) + (cache)->link_offset)
+
+/**
+ * @brief Get the size of a cache's slabs
  */
-#define SLAB_SIZE(cache) ((cache)->flags & SC_INIT_LARGE_SLABS ? (4096U) : (1024U))
+#define SLAB_SIZE(cache) ((cache)->slab_size)
 
 
+/**
+ * @brief The alignment of the first element in a slab
+ */
+#define SLAB_ELEM_ALIGN (8U)
+
 // NOTE(Adin): This is a relatively costly operation so it shouldn't be
 //             done laissez faire
-// slab_addr + ceil(sizeof(slab_header_t) / elem_size) * elem_size
+// The header is padded out to SLAB_ELEM_ALIGN rather than to a whole element,
+// which wasted most of an element per slab for anything bigger than the
+// header (elem_size is kept so the callers don't have to change)
+// slab_addr + ceil(sizeof(slab_header_t) / SLAB_ELEM_ALIGN) * SLAB_ELEM_ALIGN
 
 /**
  * @brief Get the address of the first element in a slab from the address of the slab
  */
-#define SLAB_FIRST_ELEM(slab, elem_size) ((slab) + (((sizeof(slab_header_t) + (elem_size) - 1) / (elem_size)) * (elem_size)))
+#define SLAB_FIRST_ELEM(slab, elem_size) \
+    ((slab) + ((sizeof(slab_header_t) + SLAB_ELEM_ALIGN - 1) & ~(SLAB_ELEM_ALIGN - 1)))
 
 /**
- * @brief Iterate over every element in a slab
+ * @brief Iterate over every element in a slab (taking the slab's color into account)
  */
-#define SLAB_FOR_EACH(cache, slab, var)                            \
-    for (                                                          \
-        void * var = SLAB_FIRST_ELEM((slab), (cache)->elem_size);  \
-        var <= ((slab) + SLAB_SIZE((cache))) - (cache)->elem_size; \
-        var += (cache)->elem_size                                  \
+#define SLAB_FOR_EACH(cache, slab, var)                                          \
+    for (                                                                        \
+        void * var = SLAB_FIRST_ELEM((slab), (cache)->elem_size) +               \
+                     ((slab_header_t *) (slab))->color;                          \
+        var <= ((slab) + SLAB_SIZE((cache))) - (cache)->elem_size;               \
+        var += (cache)->elem_size                                                \
     )
 
 /**
@@ -62,56 +80,269 @@
  */
 typedef struct slab_header
 {
-    struct slab_header *next_slab; // For the all slabs list
+    struct slab_header *next_slab; // For the cache's full/partial/empty lists
+    struct slab_header *prev_slab; // For the cache's full/partial/empty lists
+    slab_cache_t *cache;           // The cache that owns this slab
+    void *free_list;               // A linked list of this slab's free elements
+    uint32_t in_use;               // The number of this slab's elements in use
+    uint32_t color;                // How far past SLAB_FIRST_ELEM the elements start
 } slab_header_t;
 
+/**
+ * @brief The head of the registry of named caches
+ */
+static slab_cache_t *__registered_caches = NULL;
+
+/**
+ * @brief The system time when slab_info last took its rate samples
+ */
+static time_t __sample_time = 0;
+
+/**
+ * @brief Push a slab on to the front of one of a cache's slab lists
+ *
+ * @param list the list
+ * @param slab the slab
+ */
+static inline void __slab_list_push(void **list, slab_header_t *slab)
+{
+    slab->prev_slab = NULL;
+    slab->next_slab = *list;
+    if (slab->next_slab) {
+        slab->next_slab->prev_slab = slab;
+    }
+    *list = slab;
+}
+
+/**
+ * @brief Remove a slab from one of a cache's slab lists
+ *
+ * @param list the list
+ * @param slab the slab
+ */
+static inline void __slab_list_remove(void **list, slab_header_t *slab)
+{
+    if (slab->prev_slab) {
+        slab->prev_slab->next_slab = slab->next_slab;
+    }
+    else {
+        *list = slab->next_slab;
+    }
+
+    if (slab->next_slab) {
+        slab->next_slab->prev_slab = slab->prev_slab;
+    }
+
+    slab->next_slab = slab->prev_slab = NULL;
+}
+
 /**
  * @brief Get a new, appropriately sized slab for a cache
  *
+ * The slab's elements are threaded on to its free list and the slab is
+ * added to the cache's empty slabs list.
+ *
  * @param cache the cache to get a slab for
  *
- * @return void* the new slab
+ * @return slab_header_t* the new slab (or NULL if memory is exhausted)
  */
-static inline void *__get_slab(slab_cache_t *cache)
+static slab_header_t *__get_slab(slab_cache_t *cache)
 {
     void *new_slab = NULL;
 
     if (cache->flags & SC_INIT_LARGE_SLABS) {
-        new_slab = _km_page_alloc(1);
-
-        // Initialize the new slab
-        // Clear the slab header area (aligned up to the next multiple of elem_size)
-        // Note(Adin): The slice allocator clears newly allocated memory regions, but
-        //             the page allocator doesn't.
-        __memclr(new_slab, SLAB_FIRST_ELEM(new_slab, cache->elem_size) - new_slab);
+        // Both allocators hand back zeroed memory (so the header area
+        // starts out clear): the page allocator usually takes it from its
+        // pre-zeroed pool
+        new_slab = _km_page_alloc_flags(1U << cache->slab_order, KM_ZERO);
     }
     else {
         new_slab = _km_slice_alloc();
     }
 
-    return new_slab;
+    if (!new_slab) {
+        return NULL;
+    }
+
+    // ELEMENT_TO_SLAB_HEADER depends on this
+    assert1(((uint32_t) new_slab & (SLAB_SIZE(cache) - 1U)) == 0);
+
+    slab_header_t *header = (slab_header_t *) new_slab;
+    header->cache = cache;
+    header->free_list = NULL;
+    header->in_use = 0;
+
+    // Stagger where each slab's elements start so that the same element
+    // in different slabs doesn't always map to the same cache lines
+    header->color = cache->color_next;
+    cache->color_next += SC_COLOR_ALIGN;
+    if (cache->color_next > cache->color_max) {
+        cache->color_next = 0;
+    }
+
+    // Construct and thread the elements so the lowest addressed one
+    // is handed out first
+    void **link = &header->free_list;
+    SLAB_FOR_EACH(cache, new_slab, curr) {
+        if (cache->ctor) {
+            cache->ctor(curr);
+        }
+        *link = curr;
+        link = ELEMENT_LINK(cache, curr);
+    }
+    *link = NULL;
+
+    __slab_list_push(&cache->empty_slabs, header);
+    cache->num_empty++;
+    cache->num_slabs++;
+
+    return header;
 }
 
 /**
  * @brief Free a cache's slab
  *
+ * The slab must already have been removed from the cache's lists.
+ *
  * @param cache the owning cache of the slab
  * @param slab the slab to free
  */
 static inline void __free_slab(slab_cache_t *cache, void *slab)
 {
+    if (cache->dtor) {
+        SLAB_FOR_EACH(cache, slab, curr) {
+            cache->dtor(curr);
+        }
+    }
+
     if (cache->flags & SC_INIT_LARGE_SLABS) {
         _km_page_free(slab);
     }
     else {
         _km_slice_free(slab);
     }
+
+    cache->num_slabs--;
+}
+
+/**
+ * @brief Release empty slabs until no more than a given number remain
+ *
+ * @param cache the cache
+ * @param keep the number of empty slabs to hold on to
+ *
+ * @return uint32_t the number of slabs released
+ */
+static uint32_t __trim_empty(slab_cache_t *cache, uint32_t keep)
+{
+    uint32_t released = 0;
+
+    while (cache->num_empty > keep) {
+        slab_header_t *slab = cache->empty_slabs;
+        __slab_list_remove(&cache->empty_slabs, slab);
+        cache->num_empty--;
+        __free_slab(cache, slab);
+        released++;
+    }
+
+    return released;
+}
+
+/**
+ * @brief Get the slab that the next allocation should come from
+ *
+ * Partially used slabs are preferred so that empty ones stay empty. If an
+ * empty slab has to be used (or made), it is moved to the partial list.
+ *
+ * @param cache the cache
+ *
+ * @return slab_header_t* a slab with at least one free element (or NULL if memory is exhausted)
+ */
+static slab_header_t *__alloc_slab(slab_cache_t *cache)
+{
+    slab_header_t *slab = cache->partial_slabs;
+
+    if (!slab) {
+        if (!cache->empty_slabs && !__get_slab(cache)) {
+            return NULL;
+        }
+
+        // The slab is about to be used: move it to the partial list
+        slab = cache->empty_slabs;
+        __slab_list_remove(&cache->empty_slabs, slab);
+        cache->num_empty--;
+        __slab_list_push(&cache->partial_slabs, slab);
+    }
+
+    return slab;
+}
+
+/**
+ * @brief Move a slab to the right list after elements were returned to it
+ *
+ * Empty slabs over the cache's high-water mark are not released here.
+ *
+ * @param cache the cache
+ * @param slab the slab
+ * @param was_full whether the slab was on the full list before the elements came back
+ */
+static void __relist_slab(slab_cache_t *cache, slab_header_t *slab, bool_t was_full)
+{
+    if (slab->in_use == 0) {
+        __slab_list_remove(was_full ? &cache->full_slabs : &cache->partial_slabs, slab);
+        __slab_list_push(&cache->empty_slabs, slab);
+        cache->num_empty++;
+    }
+    else if (was_full) {
+        __slab_list_remove(&cache->full_slabs, slab);
+        __slab_list_push(&cache->partial_slabs, slab);
+    }
+}
+
+/**
+ * @brief Choose the number of pages (as a power of two) in each of a cache's slabs
+ *
+ * The smallest order whose unusable space (the header area plus whatever is
+ * left over after the last element) is within 1/SC_WASTE_TARGET of the slab
+ * is chosen. If no order gets there, the one with the least waste wins.
+ *
+ * @param element_size the size of each element
+ *
+ * @return uint32_t the slab order
+ */
+static uint32_t __pick_slab_order(uint32_t element_size)
+{
+    uint32_t first_elem = (uint32_t) SLAB_FIRST_ELEM((void *) 0, element_size);
+    uint32_t best_order = SC_MAX_SLAB_ORDER;
+    uint32_t best_waste = ~0U;
+
+    for (uint32_t order = 0; order <= SC_MAX_SLAB_ORDER; order++) {
+        uint32_t size = SZ_PAGE << order;
+        if (size < first_elem + element_size) {
+            continue;
+        }
+
+        uint32_t waste = size - ((size - first_elem) / element_size) * element_size;
+        if (waste * SC_WASTE_TARGET <= size) {
+            return order;
+        }
+
+        // Compare waste as a fraction of the slab (scaled to the largest slab)
+        uint32_t scaled = waste << (SC_MAX_SLAB_ORDER - order);
+        if (scaled < best_waste) {
+            best_waste = scaled;
+            best_order = order;
+        }
+    }
+
+    return best_order;
 }
 
 /**
  * @brief Initialize a new slab cache
  *
- * Once initialized, a cache's parameters are fixed and must not be modified.
+ * Once initialized, a cache's parameters are fixed and must not be modified
+ * (except through the functions below).
  *
  * @param cache the cache to initialize
  * @param element_size the size of each element in the cache
@@ -121,23 +352,85 @@ static inline void __free_slab(slab_cache_t *cache, void *slab)
  */
 status_t slab_init(slab_cache_t *cache, uint32_t element_size, uint32_t flags)
 {
-    // Slab sizes are both even so a right shift is /= 2
+    return slab_init_ctor(cache, element_size, flags, NULL, NULL);
+}
+
+/**
+ * @brief Initialize a new slab cache whose elements have a constructor and/or destructor
+ *
+ * Elements of such a cache are always handed out in their constructed state,
+ * so they must be returned to that state before being freed. Their free list
+ * links are kept after the object so that freeing doesn't disturb it.
+ *
+ * @param cache the cache to initialize
+ * @param element_size the size of each element in the cache
+ * @param flags any options regarding the initialization or behavior of the cache
+ * @param ctor the constructor run on each element of a new slab (or NULL)
+ * @param dtor the destructor run on each element of a released slab (or NULL)
+ *
+ * @return status_t an error code representing the first error that occurred in the operation
+ */
+status_t slab_init_ctor(slab_cache_t *cache, uint32_t element_size, uint32_t flags,
+                        slab_ctor_t ctor, slab_ctor_t dtor)
+{
+    cache->ctor = ctor;
+    cache->dtor = dtor;
+    cache->link_offset = 0;
+
+    // Constructed objects can't share their first word with the free list
+    // link: put the link after the (4 byte aligned) object instead
+    if (ctor || dtor) {
+        cache->link_offset = (element_size + 3) & ~3U;
+        element_size = cache->link_offset + sizeof(void *);
+    }
+
     // 4 bytes are required (per element) to hold the pointer
     // for the free element list
-    if (element_size > (SLAB_SIZE(cache) >> 1) || element_size < 4) {
+    if (element_size < 4 ||
+        element_size > (SZ_PAGE << SC_MAX_SLAB_ORDER) - (uint32_t) SLAB_FIRST_ELEM((void *) 0, element_size)) {
         return E_BAD_PARAM;
     }
 
-    cache->elem_size = element_size;
-    cache->flags = flags;
-    cache->free_elements = NULL;
-    cache->all_slabs = NULL;
+    // Slices are only used for elements that fit at least twice
+    if (element_size > (SZ_SLICE >> 1)) {
+        flags |= SC_INIT_LARGE_SLABS;
+    }
 
-    void *first_slab = __get_slab(cache);
+    cache->flags = flags;
+    if (flags & SC_INIT_LARGE_SLABS) {
+        cache->slab_order = __pick_slab_order(element_size);
+        cache->slab_size = SZ_PAGE << cache->slab_order;
+    }
+    else {
+        cache->slab_order = 0;
+        cache->slab_size = SZ_SLICE;
+    }
 
-    cache->all_slabs = first_slab;
-    SLAB_FOR_EACH(cache, first_slab, curr) {
-        slab_free(cache, curr);
+    cache->elem_size = element_size;
+    cache->full_slabs = NULL;
+    cache->partial_slabs = NULL;
+    cache->empty_slabs = NULL;
+    cache->num_empty = 0;
+    cache->max_empty = SC_DEFAULT_MAX_EMPTY;
+
+    cache->num_slabs = 0;
+    cache->in_use = 0;
+    cache->num_allocs = cache->num_frees = 0;
+    cache->sample_allocs = cache->sample_frees = 0;
+    cache->name = NULL;
+    cache->next_cache = NULL;
+
+    uint32_t first_elem = (uint32_t) SLAB_FIRST_ELEM((void *) 0, element_size);
+    cache->elems_per_slab = (SLAB_SIZE(cache) - first_elem) / element_size;
+
+    // Colors can use whatever is left over at the end of a slab
+    uint32_t leftover = SLAB_SIZE(cache) - first_elem - cache->elems_per_slab * element_size;
+    cache->color_max = leftover - (leftover % SC_COLOR_ALIGN);
+    cache->color_next = 0;
+
+    // Grab the first slab now so the first allocation doesn't have to
+    if (!__get_slab(cache)) {
+        return E_NO_MEM;
     }
 
     return E_SUCCESS;
@@ -155,10 +448,29 @@ status_t slab_init(slab_cache_t *cache, uint32_t element_size, uint32_t flags)
  */
 status_t slab_deinit(slab_cache_t *cache)
 {
-    for(void *curr = cache->all_slabs; curr != NULL; curr = *VOID_PTR_TO_LIST_ITEM(curr)) {
-        __free_slab(cache, curr);
+    void **lists[] = { &cache->full_slabs, &cache->partial_slabs, &cache->empty_slabs };
+
+    for (uint32_t i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+        while (*lists[i]) {
+            slab_header_t *slab = *lists[i];
+            __slab_list_remove(lists[i], slab);
+            __free_slab(cache, slab);
+        }
     }
 
+    cache->num_empty = 0;
+    cache->in_use = 0;
+
+    // Take it out of the registry
+    slab_cache_t **link = &__registered_caches;
+    while (*link && *link != cache) {
+        link = &(*link)->next_cache;
+    }
+    if (*link) {
+        *link = cache->next_cache;
+    }
+    cache->name = NULL;
+
     return E_SUCCESS;
 }
 
@@ -172,25 +484,23 @@ status_t slab_deinit(slab_cache_t *cache)
  */
 void *slab_alloc(slab_cache_t *cache, uint32_t flags)
 {
-    if(!cache->free_elements) {
-        // There are no unused elements in the free list: allocate
-        // and initialize a new slab
-
-        void *new_slab = __get_slab(cache);
+    slab_header_t *slab = __alloc_slab(cache);
+    if (!slab) {
+        return NULL;
+    }
 
-        // Add the slab to the list of all slabs
-        ((slab_header_t *) new_slab)->next_slab = cache->all_slabs;
-        cache->all_slabs = new_slab;
+    void *new_element = slab->free_list;
+    slab->free_list = *ELEMENT_LINK(cache, new_element);
+    slab->in_use++;
+    cache->in_use++;
+    cache->num_allocs++;
 
-        SLAB_FOR_EACH(cache, new_slab, curr) {
-            slab_free(cache, curr);
-        }
+    if (!slab->free_list) {
+        __slab_list_remove(&cache->partial_slabs, slab);
+        __slab_list_push(&cache->full_slabs, slab);
     }
 
-    void *new_element = cache->free_elements;
-    cache->free_elements = *VOID_PTR_TO_LIST_ITEM(new_element);
-
-    if(flags & SC_ALLOC_ZERO_MEM) {
+    if((flags & SC_ALLOC_ZERO_MEM) && !cache->ctor) {
         __memclr(new_element, cache->elem_size);
     }
 
@@ -200,6 +510,9 @@ void *slab_alloc(slab_cache_t *cache, uint32_t flags)
 /**
  * @brief Free an element belonging to the cache
  *
+ * If this leaves the element's slab empty and the cache is holding more than
+ * its high-water mark of empty slabs, the slab is returned to the page allocator.
+ *
  * @param cache the cache that owns/manages the element
  * @param element the element to be freed
  *
@@ -207,18 +520,284 @@ void *slab_alloc(slab_cache_t *cache, uint32_t flags)
  */
 status_t slab_free(slab_cache_t *cache, void *element)
 {
-    if(!cache->free_elements) {
-        *VOID_PTR_TO_LIST_ITEM(element) = NULL;
-        cache->free_elements = element;
+    slab_header_t *slab = ELEMENT_TO_SLAB_HEADER(element);
+
+    if (slab->cache != cache || slab->in_use == 0) {
+        return E_BAD_PARAM;
     }
-    else {
-        *VOID_PTR_TO_LIST_ITEM(element) = cache->free_elements;
-        cache->free_elements = element;
+
+    bool_t was_full = (slab->free_list == NULL);
+
+    *ELEMENT_LINK(cache, element) = slab->free_list;
+    slab->free_list = element;
+    slab->in_use--;
+    cache->in_use--;
+    cache->num_frees++;
+
+    __relist_slab(cache, slab, was_full);
+    if (slab->in_use == 0) {
+        (void) __trim_empty(cache, cache->max_empty);
     }
 
     return E_SUCCESS;
 }
 
+/**
+ * @brief Allocate several elements from the cache at once
+ *
+ * Each slab's free elements are taken as a run, so the slab lists are only
+ * touched once per slab rather than once per element.
+ *
+ * @param cache the cache to allocate from
+ * @param n the number of elements wanted
+ * @param out where to store the new elements (must have room for n)
+ * @param flags any additional options for the operation
+ *
+ * @return uint32_t the number of elements allocated (less than n only if memory is exhausted)
+ */
+uint32_t slab_alloc_bulk(slab_cache_t *cache, uint32_t n, void **out, uint32_t flags)
+{
+    uint32_t count = 0;
+
+    while (count < n) {
+        slab_header_t *slab = __alloc_slab(cache);
+        if (!slab) {
+            break;
+        }
+
+        // Take as much of this slab's free list as is needed
+        void *curr = slab->free_list;
+        uint32_t first = count;
+        while (curr && count < n) {
+            out[count++] = curr;
+            curr = *ELEMENT_LINK(cache, curr);
+        }
+
+        slab->free_list = curr;
+        slab->in_use += count - first;
+        cache->in_use += count - first;
+        cache->num_allocs += count - first;
+
+        if (!slab->free_list) {
+            __slab_list_remove(&cache->partial_slabs, slab);
+            __slab_list_push(&cache->full_slabs, slab);
+        }
+    }
+
+    if((flags & SC_ALLOC_ZERO_MEM) && !cache->ctor) {
+        for (uint32_t i = 0; i < count; i++) {
+            __memclr(out[i], cache->elem_size);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Free several elements belonging to the cache at once
+ *
+ * Consecutive elements from the same slab are spliced on to its free list
+ * together, and surplus empty slabs are only released once at the end.
+ *
+ * @param cache the cache that owns/manages the elements
+ * @param n the number of elements
+ * @param in the elements to be freed
+ *
+ * @return status_t E_BAD_PARAM if any element didn't belong to the cache (the rest are still freed)
+ */
+status_t slab_free_bulk(slab_cache_t *cache, uint32_t n, void **in)
+{
+    status_t status = E_SUCCESS;
+    uint32_t i = 0;
+
+    while (i < n) {
+        slab_header_t *slab = ELEMENT_TO_SLAB_HEADER(in[i]);
+
+        if (slab->cache != cache || slab->in_use == 0) {
+            status = E_BAD_PARAM;
+            i++;
+            continue;
+        }
+
+        bool_t was_full = (slab->free_list == NULL);
+
+        // Chain the run of elements from this slab on to its free list
+        void *head = slab->free_list;
+        uint32_t run = 0;
+        while (i < n && run < slab->in_use && ELEMENT_TO_SLAB_HEADER(in[i]) == slab) {
+            *ELEMENT_LINK(cache, in[i]) = head;
+            head = in[i];
+            run++;
+            i++;
+        }
+
+        slab->free_list = head;
+        slab->in_use -= run;
+        cache->in_use -= run;
+        cache->num_frees += run;
+
+        __relist_slab(cache, slab, was_full);
+    }
+
+    (void) __trim_empty(cache, cache->max_empty);
+
+    return status;
+}
+
+/**
+ * @brief Set the number of empty slabs a cache holds on to
+ *
+ * Any empty slabs over the new limit are released immediately.
+ *
+ * @param cache the cache
+ * @param max_empty the new high-water mark
+ */
+void slab_set_max_empty(slab_cache_t *cache, uint32_t max_empty)
+{
+    cache->max_empty = max_empty;
+    (void) __trim_empty(cache, max_empty);
+}
+
+/**
+ * @brief Return every empty slab in a cache to the page allocator
+ *
+ * Meant to be called when memory is running low.
+ *
+ * @param cache the cache to shrink
+ *
+ * @return uint32_t the number of slabs released
+ */
+uint32_t slab_shrink(slab_cache_t *cache)
+{
+    return __trim_empty(cache, 0);
+}
+
+/**
+ * @brief Add a cache to the registry of caches reported by slab_info
+ *
+ * @param cache the (initialized) cache
+ * @param name the name to report it under (must outlive the cache)
+ *
+ * @return status_t the error status of the operation
+ */
+status_t slab_register(slab_cache_t *cache, const char *name)
+{
+    if (!cache || !name || cache->name) {
+        return E_BAD_PARAM;
+    }
+
+    cache->name = name;
+    cache->sample_allocs = cache->num_allocs;
+    cache->sample_frees = cache->num_frees;
+
+    // Append so the report comes out in registration order
+    slab_cache_t **link = &__registered_caches;
+    while (*link) {
+        link = &(*link)->next_cache;
+    }
+    cache->next_cache = NULL;
+    *link = cache;
+
+    return E_SUCCESS;
+}
+
+/**
+ * @brief The rate of ops operations over elapsed ticks, per second
+ *
+ * ops * CLOCK_FREQUENCY overflows 32 bits after a few million operations,
+ * and there's no 64-bit division, so this divides first.
+ */
+static uint32_t __slab_rate(uint32_t ops, time_t elapsed)
+{
+    // The remainder term below fits as long as elapsed does
+    if (elapsed > 0xffffffffU / CLOCK_FREQUENCY) {
+        return ops / (elapsed / CLOCK_FREQUENCY);
+    }
+
+    return ops / elapsed * CLOCK_FREQUENCY + ops % elapsed * CLOCK_FREQUENCY / elapsed;
+}
+
+/**
+ * @brief Describe every registered cache, one per line
+ *
+ * @param buffer where to write the report
+ * @param size the size of buffer (caches that don't fit are left out)
+ *
+ * @return uint32_t the length of the report (excluding the NUL)
+ */
+uint32_t slab_info(char *buffer, uint32_t size)
+{
+    // __sprint doesn't take a buffer size, so each line goes through
+    // here first (names are expected to be short)
+    char line[128];
+    uint32_t len = 0;
+
+    time_t now = _system_time;
+    time_t elapsed = now - __sample_time;
+    __sample_time = now;
+
+    if (size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+
+    __sprint(line, "%-16s %6s %6s %5s %6s %6s %7s %7s %7s\n",
+             "name", "active", "free", "slabs", "slabsz", "objsz", "waste", "alloc/s", "free/s");
+
+    for (slab_cache_t *cache = __registered_caches; ; cache = cache->next_cache) {
+        uint32_t line_len = __strlen(line);
+        if (len + line_len + 1 > size) {
+            break;
+        }
+        __strcpy(buffer + len, line);
+        len += line_len;
+
+        if (!cache) {
+            break;
+        }
+
+        uint32_t total = cache->num_slabs * cache->elems_per_slab;
+        uint32_t waste = cache->num_slabs * (cache->slab_size - cache->elems_per_slab * cache->elem_size);
+        uint32_t alloc_rate = 0;
+        uint32_t free_rate = 0;
+        if (elapsed > 0) {
+            alloc_rate = __slab_rate(cache->num_allocs - cache->sample_allocs, elapsed);
+            free_rate = __slab_rate(cache->num_frees - cache->sample_frees, elapsed);
+        }
+        cache->sample_allocs = cache->num_allocs;
+        cache->sample_frees = cache->num_frees;
+
+        __sprint(line, "%-16s %6u %6u %5u %6u %6u %7u %7u %7u\n",
+                 cache->name, cache->in_use, total - cache->in_use, cache->num_slabs,
+                 cache->slab_size, cache->elem_size, waste, alloc_rate, free_rate);
+    }
+
+    return len;
+}
+
+/**
+ * @brief Find the cache that owns an element
+ *
+ * @param element the element
+ * @param large_slabs whether the owning cache was initialized with SC_INIT_LARGE_SLABS
+ *
+ * @return slab_cache_t* the cache the element belongs to
+ */
+slab_cache_t *slab_element_cache(void *element, bool_t large_slabs)
+{
+    slab_header_t *slab = NULL;
+
+    if (large_slabs) {
+        // A large slab is a page allocation of its own
+        slab = _km_page_lookup(element, NULL);
+    }
+    else {
+        slab = (slab_header_t *) (((uint32_t) element) & SMALL_SLAB_HEADER_MASK);
+    }
+
+    return slab ? slab->cache : NULL;
+}
+
 //
 // ---------------------------------------------TESTS-----------------------------------------------
 //
@@ -231,17 +810,46 @@ status_t slab_free(slab_cache_t *cache, void *element)
 
 uint32_t __slab_test_first_element(void)
 {
-    // NOTE(Adin): At time of writing, sizeof(slab_header_t) = 4
+    // At time of writing, sizeof(slab_header_t) = 24
     // NOTE(Adin): In the future, element size will be limited to a minimum of 4
     //             (for the free-element list pointer)
-    uint32_t smaller =           SLAB_FIRST_ELEM(NULL, 3);  // Expected: 6
-    uint32_t smaller_multiple =  SLAB_FIRST_ELEM(NULL, 2);  // Expected: 4
-    uint32_t bigger =            SLAB_FIRST_ELEM(NULL, 7);  // Expected: 7
-    uint32_t bigger_multiple =   SLAB_FIRST_ELEM(NULL, 8);  // Expected: 8
-    uint32_t even =              SLAB_FIRST_ELEM(NULL, sizeof(slab_header_t)); // Expected: 4
+    uint32_t smaller =           SLAB_FIRST_ELEM(NULL, 3);  // Expected: 24
+    uint32_t smaller_multiple =  SLAB_FIRST_ELEM(NULL, 2);  // Expected: 24
+    uint32_t bigger =            SLAB_FIRST_ELEM(NULL, 7);  // Expected: 24
+    uint32_t bigger_multiple =   SLAB_FIRST_ELEM(NULL, 8);  // Expected: 24
+    uint32_t even =              SLAB_FIRST_ELEM(NULL, sizeof(slab_header_t)); // Expected: 24
+    uint32_t large =             SLAB_FIRST_ELEM(NULL, 2048); // Expected: 24 (was 2048)
 
     // HAH: Just try to compile me out now!
-    return smaller + smaller_multiple + bigger + bigger_multiple + even;
+    return smaller + smaller_multiple + bigger + bigger_multiple + even + large;
+}
+
+/**
+ * @brief Count the slabs in one of a cache's slab lists
+ */
+static uint32_t __slab_test_count_slabs(void *list)
+{
+    uint32_t num_slabs = 0;
+    for(slab_header_t *curr = list; curr; curr = curr->next_slab) {
+        num_slabs++;
+    }
+    return num_slabs;
+}
+
+/**
+ * @brief Count the free elements in one of a cache's slab lists
+ */
+static uint32_t __slab_test_count_free(void *list)
+{
+    uint32_t num_elements = 0;
+    for(slab_header_t *curr = list; curr; curr = curr->next_slab) {
+        void *curr_element = curr->free_list;
+        while(curr_element) {
+            curr_element = *VOID_PTR_TO_LIST_ITEM(curr_element);
+            num_elements++;
+        }
+    }
+    return num_elements;
 }
 
 void __slab_test_init(void)
@@ -249,31 +857,23 @@ void __slab_test_init(void)
     // By virtue of being called in init, this also tests
     //    * __get_slab()
     //    * SLAB_FOR_EACH()
-    //    * slab_free()
 
     slab_cache_t small_slabs_cache = {};
     slab_init(&small_slabs_cache, 7, 0);
-    uint32_t small_num_elements = 0;
-    void *curr_element = small_slabs_cache.free_elements;
-    while(curr_element) {
-        curr_element = *VOID_PTR_TO_LIST_ITEM(curr_element);
-        small_num_elements++;
-    }
+    uint32_t small_num_elements = __slab_test_count_free(small_slabs_cache.empty_slabs);
 
     slab_cache_t large_slabs_cache = {};
     slab_init(&large_slabs_cache, 7, SC_INIT_LARGE_SLABS);
-    uint32_t large_num_elements = 0;
-    curr_element = large_slabs_cache.free_elements;
-    while(curr_element) {
-        curr_element = *VOID_PTR_TO_LIST_ITEM(curr_element);
-        large_num_elements++;
-    }
+    uint32_t large_num_elements = __slab_test_count_free(large_slabs_cache.empty_slabs);
 
     // Useless expression to set a breakpoint on
-    // Small Expected: (1024 / 7) - 1 [145]
-    // Large Expected: (4096 / 7) - 1 [584]
+    // Small Expected: (1024 - 24) / 7 [142] (and == elems_per_slab)
+    // Large Expected: (4096 - 24) / 7 [581] (and == elems_per_slab)
     uint32_t foo = small_num_elements + large_num_elements;
     (void) foo;
+
+    slab_deinit(&small_slabs_cache);
+    slab_deinit(&large_slabs_cache);
 }
 
 void __slab_test_new_slab_alloc(void)
@@ -290,30 +890,106 @@ void __slab_test_new_slab_alloc(void)
     for(int i = 0; i < 146; i++) {
         slab_alloc(&small_slabs_cache, 0);
     }
-    uint32_t small_num_slabs = 0;
-    slab_header_t *curr_slab = small_slabs_cache.all_slabs;
-    while(curr_slab) {
-        small_num_slabs++;
-        curr_slab = curr_slab->next_slab;
-    }
+    uint32_t small_num_slabs = __slab_test_count_slabs(small_slabs_cache.full_slabs) +
+                               __slab_test_count_slabs(small_slabs_cache.partial_slabs);
 
     slab_cache_t large_slabs_cache = {};
     slab_init(&large_slabs_cache, 7, SC_INIT_LARGE_SLABS);
     for(int i = 0; i < 585; i++) {
         slab_alloc(&large_slabs_cache, 0);
     }
-    uint32_t large_num_slabs = 0;
-    curr_slab = large_slabs_cache.all_slabs;
-    while(curr_slab) {
-        large_num_slabs++;
-        curr_slab = curr_slab->next_slab;
-    }
+    uint32_t large_num_slabs = __slab_test_count_slabs(large_slabs_cache.full_slabs) +
+                               __slab_test_count_slabs(large_slabs_cache.partial_slabs);
 
     // Usless expression to set breakpoint on
-    // Small Expected: 2
-    // Large Expected: 2
+    // Small Expected: 2 (1 full, 1 partial)
+    // Large Expected: 2 (1 full, 1 partial)
     uint32_t bar = small_num_slabs + large_num_slabs;
     (void) bar;
+
+    slab_deinit(&small_slabs_cache);
+    slab_deinit(&large_slabs_cache);
+}
+
+void __slab_test_reclaim(void)
+{
+    // (4096 - 24) / 512 = 7 elements per slab
+    slab_cache_t cache = {};
+    slab_init(&cache, 512, SC_INIT_LARGE_SLABS);
+
+    // Fill three slabs, then free everything
+    void *elements[3 * 7];
+    for(int i = 0; i < 3 * 7; i++) {
+        elements[i] = slab_alloc(&cache, 0);
+    }
+    uint32_t full_before = __slab_test_count_slabs(cache.full_slabs);
+
+    for(int i = 0; i < 3 * 7; i++) {
+        slab_free(&cache, elements[i]);
+    }
+    uint32_t empty_after = cache.num_empty;
+
+    uint32_t released = slab_shrink(&cache);
+
+    // Useless expression to set a breakpoint on
+    // Full before expected: 3
+    // Empty after expected: 1 (SC_DEFAULT_MAX_EMPTY)
+    // Released expected: 1 (and cache.empty_slabs == NULL afterwards)
+    uint32_t baz = full_before + empty_after + released;
+    (void) baz;
+
+    slab_deinit(&cache);
+}
+
+void __slab_test_slab_orders(void)
+{
+    // At time of writing, SC_WASTE_TARGET = 8 and SC_MAX_SLAB_ORDER = 3
+    uint32_t one_page =    __pick_slab_order(512);   // Expected: 0 (waste 512 / 4096)
+    uint32_t two_pages =   __pick_slab_order(1024);  // Expected: 1 (waste 1024 / 8192)
+    uint32_t four_pages =  __pick_slab_order(2048);  // Expected: 2 (waste 2048 / 16384)
+    uint32_t odd_size =    __pick_slab_order(3000);  // Expected: 2 (waste 1384 / 16384)
+    uint32_t best_effort = __pick_slab_order(12000); // Expected: 2 (waste 4384 / 16384: nothing meets the target)
+
+    slab_cache_t big_cache = {};
+    status_t big_status = slab_init(&big_cache, 3000, 0);
+
+    // Useless expression to set a breakpoint on
+    // big_status Expected: E_SUCCESS, with SC_INIT_LARGE_SLABS forced on
+    uint32_t qux = one_page + two_pages + four_pages + odd_size + best_effort + big_status;
+    (void) qux;
+
+    slab_deinit(&big_cache);
+}
+
+void __slab_test_bulk(void)
+{
+    // 7 elements per slab (see __slab_test_reclaim)
+    slab_cache_t cache = {};
+    slab_init(&cache, 512, SC_INIT_LARGE_SLABS);
+
+    void *elements[3 * 7 + 2];
+    uint32_t allocated = slab_alloc_bulk(&cache, 3 * 7 + 2, elements, 0);
+    uint32_t full_after_alloc = __slab_test_count_slabs(cache.full_slabs);
+    uint32_t partial_after_alloc = __slab_test_count_slabs(cache.partial_slabs);
+
+    // Elements from one slab come out in a contiguous run
+    bool_t in_order = (elements[1] == elements[0] + 512);
+
+    status_t free_status = slab_free_bulk(&cache, 3 * 7 + 2, elements);
+    // The first slab is the one kept as the cache's empty slab, so its header is still valid
+    status_t refree_status = slab_free_bulk(&cache, 1, elements);
+
+    // Useless expression to set a breakpoint on
+    // Allocated expected: 23
+    // Full after alloc expected: 3, partial after alloc expected: 1
+    // In order expected: true
+    // Free status expected: E_SUCCESS, refree status expected: E_BAD_PARAM
+    // cache.num_empty expected: 1 (SC_DEFAULT_MAX_EMPTY)
+    uint32_t quux = allocated + full_after_alloc + partial_after_alloc + in_order +
+                    free_status + refree_status + cache.num_empty;
+    (void) quux;
+
+    slab_deinit(&cache);
 }
 
 void __slab_run_all_tests(void)
@@ -321,6 +997,9 @@ void __slab_run_all_tests(void)
     __slab_test_first_element();
     __slab_test_init();
     __slab_test_new_slab_alloc();
+    __slab_test_reclaim();
+    __slab_test_slab_orders();
+    __slab_test_bulk();
 }
 
-#endif // #ifdef __SLAB_CACHE_TEST
\ No newline at end of file
+#endif // #ifdef __SLAB_CACHE_TEST
@@ -12,39 +12,98 @@
 #define SP_KERNEL_SRC
 #include "common.h"
 
-// TODO(Adin): slab_free currently moves any freed element to the unused elements list
-// meaning even if a slab has 0 elements in use, its unused elements will still be in
-// free_elements, meaning it cannot be freed itself (as this would break the free_elements)
-// linked list.
-// Instead, each slab can have its own free list and finding a free element
-// is available_slabs->free_list->first
+// Each slab keeps its own free list and in-use count, and the
+// cache sorts its slabs into full, partial and empty lists. Allocations come
+// from partial slabs first (then empty ones), which lets slabs drain so that
+// empty ones can be handed back to the page allocator.
+
+/**
+ * @brief An element constructor or destructor
+ *
+ * Constructors are run once for each element when its slab is created and
+ * destructors once for each element when its slab is released, not on
+ * every allocation and free.
+ */
+typedef void (*slab_ctor_t)(void *element);
 
 /**
  * @brief A slab-allocated cache of homogenously sized items
  */
 typedef struct slab_cache
 {
-    uint32_t elem_size;  // The size of each element
-    uint32_t flags;      // Options specific to each instance
+    uint32_t elem_size;      // The size of each element (including its free list link)
+    uint32_t flags;          // Options specific to each instance
+    uint32_t slab_size;      // The size of each slab in bytes
+    uint32_t slab_order;     // Large slabs are 2^slab_order pages
+    uint32_t elems_per_slab; // The number of elements that fit in each slab
+    uint32_t link_offset;    // Where in a free element its free list link is kept
+
+    slab_ctor_t ctor;        // Run on each element when a slab is created (or NULL)
+    slab_ctor_t dtor;        // Run on each element when a slab is released (or NULL)
+
+    uint32_t color_next;     // The color (first element offset) for the next slab
+    uint32_t color_max;      // The largest color that still fits every element
+
+    void *full_slabs;        // Slabs with every element in use
+    void *partial_slabs;     // Slabs with some elements in use
+    void *empty_slabs;       // Slabs with no elements in use
+
+    uint32_t num_empty;      // The length of the empty slabs list
+    uint32_t max_empty;      // How many empty slabs are kept before returning them
+
+    // Statistics (see slab_info)
+    uint32_t num_slabs;      // The number of slabs on all three lists
+    uint32_t in_use;         // The number of elements handed out
+    uint32_t num_allocs;     // Elements allocated over the life of the cache
+    uint32_t num_frees;      // Elements freed over the life of the cache
+    uint32_t sample_allocs;  // num_allocs when slab_info last reported this cache
+    uint32_t sample_frees;   // num_frees when slab_info last reported this cache
 
-    void *free_elements; // A linked list of free elements in the cache
-    void *all_slabs;     // A linked list of all slabs in the cache
+    const char *name;                // The cache's name in the registry (NULL if not registered)
+    struct slab_cache *next_cache;   // The next cache in the registry
 } slab_cache_t;
 
 /**
  * Flag passed to slab_alloc to clear the contents of a new element before returning it
+ *
+ * Ignored by caches with a constructor (their elements are handed out already constructed)
  */
 #define SC_ALLOC_ZERO_MEM (0x01U)
 
 /**
  * Flag indicating the cache uses pages as its slabs (as opposed to slices: the default)
+ *
+ * Caches whose elements don't fit in a slice at least twice always use pages.
  */
 #define SC_INIT_LARGE_SLABS (0x01U)
 
+/**
+ * The largest slab a cache will use: 2^SC_MAX_SLAB_ORDER pages
+ */
+#define SC_MAX_SLAB_ORDER (3U)
+
+/**
+ * Large slabs are made big enough that no more than 1/SC_WASTE_TARGET of each
+ * one is wasted (when that's possible within SC_MAX_SLAB_ORDER)
+ */
+#define SC_WASTE_TARGET (8U)
+
+/**
+ * The number of empty slabs a cache keeps (its high-water mark) unless told otherwise
+ */
+#define SC_DEFAULT_MAX_EMPTY (1U)
+
+/**
+ * The granularity of slab coloring: successive slabs start their first
+ * element this many bytes further in (while the slab's leftover space allows)
+ */
+#define SC_COLOR_ALIGN (32U)
+
 /**
  * @brief Initialize a new slab cache
  *
- * Once initialized, a cache's parameters are fixed and must not be modified.
+ * Once initialized, a cache's parameters are fixed and must not be modified
+ * (except through the functions below).
  *
  * @param cache the cache to initialize
  * @param element_size the size of each element in the cache
@@ -53,6 +112,23 @@ typedef struct slab_cache
  * @return status_t an error code representing the first error that occurred in the operation
  */
 status_t slab_init(slab_cache_t *cache, uint32_t element_size, uint32_t flags);
+/**
+ * @brief Initialize a new slab cache whose elements have a constructor and/or destructor
+ *
+ * Elements of such a cache are always handed out in their constructed state,
+ * so they must be returned to that state before being freed. Their free list
+ * links are kept after the object so that freeing doesn't disturb it.
+ *
+ * @param cache the cache to initialize
+ * @param element_size the size of each element in the cache
+ * @param flags any options regarding the initialization or behavior of the cache
+ * @param ctor the constructor run on each element of a new slab (or NULL)
+ * @param dtor the destructor run on each element of a released slab (or NULL)
+ *
+ * @return status_t an error code representing the first error that occurred in the operation
+ */
+status_t slab_init_ctor(slab_cache_t *cache, uint32_t element_size, uint32_t flags,
+                        slab_ctor_t ctor, slab_ctor_t dtor);
 /**
  * @brief Allocate a new element in the cache
  *
@@ -65,12 +141,58 @@ void *slab_alloc(slab_cache_t *cache, uint32_t flags);
 /**
  * @brief Free an element belonging to the cache
  *
+ * If this leaves the element's slab empty and the cache is holding more than
+ * its high-water mark of empty slabs, the slab is returned to the page allocator.
+ *
  * @param cache the cache that owns/manages the element
  * @param element the element to be freed
  *
  * @return status_t the error status of the operation
  */
 status_t slab_free(slab_cache_t *cache, void *element);
+/**
+ * @brief Allocate several elements from the cache at once
+ *
+ * @param cache the cache to allocate from
+ * @param n the number of elements wanted
+ * @param out where to store the new elements (must have room for n)
+ * @param flags any additional options for the operation
+ *
+ * @return uint32_t the number of elements allocated (less than n only if memory is exhausted)
+ */
+uint32_t slab_alloc_bulk(slab_cache_t *cache, uint32_t n, void **out, uint32_t flags);
+/**
+ * @brief Free several elements belonging to the cache at once
+ *
+ * Elements from the same slab should be next to each other in the array:
+ * each run is returned to its slab in one list operation.
+ *
+ * @param cache the cache that owns/manages the elements
+ * @param n the number of elements
+ * @param in the elements to be freed
+ *
+ * @return status_t E_BAD_PARAM if any element didn't belong to the cache (the rest are still freed)
+ */
+status_t slab_free_bulk(slab_cache_t *cache, uint32_t n, void **in);
+/**
+ * @brief Set the number of empty slabs a cache holds on to
+ *
+ * Any empty slabs over the new limit are released immediately.
+ *
+ * @param cache the cache
+ * @param max_empty the new high-water mark
+ */
+void slab_set_max_empty(slab_cache_t *cache, uint32_t max_empty);
+/**
+ * @brief Return every empty slab in a cache to the page allocator
+ *
+ * Meant to be called when memory is running low.
+ *
+ * @param cache the cache to shrink
+ *
+ * @return uint32_t the number of slabs released
+ */
+uint32_t slab_shrink(slab_cache_t *cache);
 /**
  * @brief Deinitialize a cache and free all of its resources
  *
@@ -82,6 +204,40 @@ status_t slab_free(slab_cache_t *cache, void *element);
  * @return status_t the error status of the operation
  */
 status_t slab_deinit(slab_cache_t *cache);
+/**
+ * @brief Add a cache to the registry of caches reported by slab_info
+ *
+ * The cache is removed from the registry when it is deinitialized.
+ *
+ * @param cache the (initialized) cache
+ * @param name the name to report it under (must outlive the cache)
+ *
+ * @return status_t the error status of the operation
+ */
+status_t slab_register(slab_cache_t *cache, const char *name);
+/**
+ * @brief Describe every registered cache, one per line
+ *
+ * For each cache: its name, the objects in use and free, the number of
+ * slabs and their size, the object size, the bytes lost to slab headers and
+ * leftover space, and the allocation and free rates (per second) since the
+ * previous call.
+ *
+ * @param buffer where to write the report
+ * @param size the size of buffer (caches that don't fit are left out)
+ *
+ * @return uint32_t the length of the report (excluding the NUL)
+ */
+uint32_t slab_info(char *buffer, uint32_t size);
+/**
+ * @brief Find the cache that owns an element
+ *
+ * @param element the element
+ * @param large_slabs whether the owning cache uses pages (rather than slices) for its slabs
+ *
+ * @return slab_cache_t* the cache the element belongs to
+ */
+slab_cache_t *slab_element_cache(void *element, bool_t large_slabs);
 
 //
 // ---------------------------------------------TESTS-----------------------------------------------
@@ -95,4 +251,4 @@ void __slab_run_all_tests(void);
 
 #endif // #ifdef __SLAB_CACHE_TEST
 
-#endif // #ifndef __SLAB_CACHE_H__
\ No newline at end of file
+#endif // #ifndef __SLAB_CACHE_H__
@@ -33,7 +33,7 @@ status_t resolve_path(char *path, dirent_t **result)
         return E_BAD_PARAM;
     }
 
-    dirent_t *curr_dirent = _current->cwd;
+    dirent_t *curr_dirent = _current->proc->cwd;
 
     // Yes I know this doesn't account for leading spaces
     // No I don't care atm
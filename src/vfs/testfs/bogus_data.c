@@ -9,6 +9,7 @@
 #include "bogus_data.h"
 
 #include "mem/kmem.h"
+#include "util/slab_cache.h"
 
 /**
  * I wanted to dynamically allocate these, but nooooooo, we have to go and have
@@ -18,6 +19,7 @@
 /**
  *
  * root (/)/
+ * ├─ slabinfo
  * ├─ etc/
  * │  ├─ passwd
  * │  ├─ group
@@ -40,6 +42,7 @@ static bogus_node_t bogus_lib_node;
 static bogus_node_t bogus_libgdi_node;
 static bogus_node_t bogus_bin_node;
 static bogus_node_t bogus_chattr_node;
+static bogus_node_t bogus_slabinfo_node;
 
 // The list of all nodes (used for fs initialization)
 bogus_node_t *bogus_all_nodes[BOGUS_NUM_NODES] = {
@@ -47,7 +50,7 @@ bogus_node_t *bogus_all_nodes[BOGUS_NUM_NODES] = {
     &bogus_etc_node,
     &bogus_passwd_node,
     &bogus_group_node,
-    &bogus_passwd_node,
+    &bogus_slabinfo_node,
     &bogus_usr_node,
     &bogus_lib_node,
     &bogus_libgdi_node,
@@ -86,8 +89,8 @@ void __deinit_bogus_nodes(void)
 bogus_node_t bogus_root_node = {
     .name = "/",
     .parent = &bogus_root_node,
-    .children = {&bogus_etc_node, &bogus_usr_node},
-    .num_children = 2,
+    .children = {&bogus_etc_node, &bogus_usr_node, &bogus_slabinfo_node},
+    .num_children = 3,
 };
 
 static bogus_node_t bogus_etc_node = {
@@ -136,4 +139,10 @@ static bogus_node_t bogus_bin_node = {
 static bogus_node_t bogus_chattr_node = {
     .name = "chattr",
     .parent = &bogus_bin_node
+};
+
+static bogus_node_t bogus_slabinfo_node = {
+    .name = "slabinfo",
+    .parent = &bogus_root_node,
+    .generate = slab_info
 };
\ No newline at end of file
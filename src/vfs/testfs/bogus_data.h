@@ -30,6 +30,9 @@ struct bogus_node
     void *data;                                      // Bogus page for testing write calls
     uint32_t length;                                 // Length of data in data (will be less than full
                                                      //     allocation most of the time)
+    uint32_t (*generate)(char *, uint32_t);          // Fills a private copy of data on every open,
+                                                     //     making the file read-only (NULL for
+                                                     //     ordinary files)
 };
 
 /**
@@ -14,6 +14,7 @@
 #include "kern/kdefs.h"
 #include "vfs/vfs.h"
 #include "libc/lib.h"
+#include "mem/kmem.h"
 
 #include "bogus_data.h"
 
@@ -95,6 +96,22 @@ status_t testfs_open(inode_t *inode, kfile_t *file, uint32_t flags)
 
     file->kf_priv = inode->i_priv;
 
+    // Generated files get a snapshot of their own each time they're opened:
+    // a copy of the node at the start of a page, with its data in the rest
+    bogus_node_t *node = inode->i_priv;
+    if(node && node->generate) {
+        bogus_node_t *snapshot = _km_page_alloc(1);
+        if(!snapshot) {
+            return S_NOMEM;
+        }
+
+        *snapshot = *node;
+        snapshot->data = snapshot + 1;
+        snapshot->length = node->generate(snapshot->data, SZ_PAGE - sizeof(bogus_node_t));
+
+        file->kf_priv = snapshot;
+    }
+
     return S_OK;
 }
 
@@ -196,7 +213,14 @@ status_t testfs_lookup(inode_t *inode, dirent_t *dirent)
  */
 status_t testfs_close_file(kfile_t *file)
 {
-    __cio_printf("Closing testfs file (in driver) %s\n", ((bogus_node_t *)file->kf_priv)->name);
+    bogus_node_t *node = FILE_TO_BOGUS_NODE(file);
+
+    __cio_printf("Closing testfs file (in driver) %s\n", node->name);
+
+    // Free the snapshot testfs_open made
+    if(node->generate) {
+        _km_page_free(node);
+    }
 
     return S_OK;
 }
@@ -295,6 +319,12 @@ status_t testfs_file_write(kfile_t *file, void *buffer, uint32_t num_bytes, uint
     }
 
     bogus_node_t *node = FILE_TO_BOGUS_NODE(file);
+    if(node->generate) {
+        // Generated files are read-only
+        *num_written = 0;
+        return S_NOT_SUPP;
+    }
+
     if(!node->data) {
         // Not returned anywhere else so this will uniquely identify the issue
         return S_ERR;
@@ -357,6 +387,9 @@ dirent_t *testfs_mount(fs_type_t *fs_type)
     _que_create(&(testfs_super_block->sb_inodes), NULL);
     testfs_super_block->sb_root_inode = &bogus_root_node.inode;
 
+    // Get the qnodes for every inode in one go rather than one per insert
+    _que_reserve(BOGUS_NUM_NODES);
+
     // Init the inodes in the bogus nodes
     for(int i = 0; i < BOGUS_NUM_NODES; i++) {
         bogus_node_t *curr_node = bogus_all_nodes[i];
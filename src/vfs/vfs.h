@@ -144,6 +144,8 @@ struct kfile
     inode_t *kf_inode;  // The inode the file is representing
     uint32_t kf_rwhead; // The offset into the file's data to perform read and writes at
 
+    uint32_t kf_refs;   // The number of open file tables holding this file
+
     uint8_t kf_mode;    // The opened mode of the file (reading, writing, or both)
 
     kfile_ops_t *kf_ops; // Driver-implemented operations performed on this file
@@ -258,5 +260,30 @@ void _vfs_dirent_to_pathname(dirent_t *dirent, char *buffer);
  * @param file the file to free
  */
 void _vfs_free_file(kfile_t *file);
+/**
+ * @brief Drop one open file table's reference to a file
+ *
+ * When the last reference goes, the file is closed: the driver's close
+ * hook is called, the file's locks on its inode are released, and the
+ * kfile_t is freed.
+ *
+ * @param file the file
+ */
+void _vfs_close_file(kfile_t *file);
+/**
+ * @brief Free a dirent_t
+ *
+ * The dirent must have no children.
+ *
+ * @param dirent the dirent to free
+ */
+void _vfs_free_dirent(dirent_t *dirent);
+
+#ifdef SLAB_BENCH
+/**
+ * @brief Time the dirent and kfile allocation paths against plain (unconstructed) slab caches
+ */
+void _vfs_bench(void);
+#endif
 
 #endif // #ifndef __VFS_H__